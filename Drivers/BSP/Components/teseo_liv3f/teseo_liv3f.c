@@ -157,10 +157,81 @@ int32_t TESEO_LIV3F_ReleaseMessage(const TESEO_LIV3F_Object_t *pObj, const TESEO
   return TESEO_LIV3F_OK;
 }
 
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+uint32_t TESEO_LIV3F_GetMessageBatch(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t Max)
+{
+  return teseo_queue_claim_rd_batch(pObj->pTeseoQueue, pMsgs, Max);
+}
+
+int32_t TESEO_LIV3F_ReleaseMessageBatch(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t Nbr)
+{
+  teseo_queue_release_rd_batch(pObj->pTeseoQueue, pMsgs, Nbr);
+
+  return TESEO_LIV3F_OK;
+}
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+int32_t TESEO_LIV3F_RegisterConsumer(const TESEO_LIV3F_Object_t *pObj, uint8_t Policy, uint32_t *pId)
+{
+  int32_t id = teseo_queue_register_consumer(pObj->pTeseoQueue, Policy);
+
+  if (id < 0)
+  {
+    return TESEO_LIV3F_ERROR;
+  }
+  *pId = (uint32_t)id;
+
+  return TESEO_LIV3F_OK;
+}
+
+int32_t TESEO_LIV3F_UnregisterConsumer(const TESEO_LIV3F_Object_t *pObj, uint32_t Id)
+{
+  teseo_queue_unregister_consumer(pObj->pTeseoQueue, Id);
+
+  return TESEO_LIV3F_OK;
+}
+
+const TESEO_LIV3F_Msg_t *TESEO_LIV3F_GetConsumerMessage(const TESEO_LIV3F_Object_t *pObj, uint32_t Id)
+{
+  return teseo_queue_claim_rd_consumer(pObj->pTeseoQueue, Id);
+}
+
+int32_t TESEO_LIV3F_ReleaseConsumerMessage(const TESEO_LIV3F_Object_t *pObj, uint32_t Id, const TESEO_LIV3F_Msg_t *Message)
+{
+  teseo_queue_release_rd_consumer(pObj->pTeseoQueue, Id, Message);
+
+  return TESEO_LIV3F_OK;
+}
+
+uint32_t TESEO_LIV3F_GetConsumerOverruns(const TESEO_LIV3F_Object_t *pObj, uint32_t Id)
+{
+  return teseo_queue_get_overruns(pObj->pTeseoQueue, Id);
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 int32_t TESEO_LIV3F_Send(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *Message)
 {
+#if (CONFIG_USE_STATIC_BUS == 1)
+  (void)pObj;
+  return (int32_t)TESEO_LIV3F_BUS_TRANSMIT_IT(Message->buf, Message->len);
+#else
   return pObj->IO.Transmit_IT((pObj->IO.Address << 1), Message->buf, Message->len);
+#endif /* CONFIG_USE_STATIC_BUS */
+}
+
+#if (CONFIG_USE_RX_STATS == 1)
+int32_t TESEO_LIV3F_GetStats(const TESEO_LIV3F_Object_t *pObj, TESEO_LIV3F_Stats_t *pStats)
+{
+  if ((pObj->pTeseoQueue == NULL) || (pStats == NULL))
+  {
+    return TESEO_LIV3F_ERROR;
+  }
+  *pStats = pObj->pTeseoQueue->stats;
+
+  return TESEO_LIV3F_OK;
 }
+#endif /* CONFIG_USE_RX_STATS */
 
 void TESEO_LIV3F_I2C_BackgroundProcess(void)
 {
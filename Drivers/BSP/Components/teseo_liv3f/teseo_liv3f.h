@@ -235,6 +235,106 @@ const TESEO_LIV3F_Msg_t* TESEO_LIV3F_GetMessage(const TESEO_LIV3F_Object_t *pObj
  */
 int32_t                  TESEO_LIV3F_ReleaseMessage(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *Message);
 
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+/**
+ * @brief Returns all the messages currently readable, in arrival order.
+ *
+ * The messages are claimed with a single lock of the queue. They must be given back
+ * with TESEO_LIV3F_ReleaseMessageBatch().
+ *
+ * @pre GNSS1A1_GNSS_Init() must be called before calling this function.
+ *
+ * @param pObj Teseo Module object.
+ * @param pMsgs Array filled with the queue pointers to the NMEA messages.
+ * @param Max Size of the array.
+ *
+ * @return The number of messages returned.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_GetMessageBatch() and not exposed to the application.
+ */
+uint32_t                 TESEO_LIV3F_GetMessageBatch(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t Max);
+
+/**
+ * @brief Releases a batch of messages from the GNSS queue and marks their queue slots as writable.
+ *
+ * @param pObj Teseo Module object that contains the address of queue slots.
+ * @param pMsgs Messages returned by TESEO_LIV3F_GetMessageBatch().
+ * @param Nbr Number of messages.
+ *
+ * @return A zero value indicates that the queue space was marked as writable.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_ReleaseMessageBatch() and not exposed to the application.
+ */
+int32_t                  TESEO_LIV3F_ReleaseMessageBatch(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t Nbr);
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/**
+ * @brief Registers a new consumer of the GNSS queue.
+ *
+ * Every registered consumer reads all the messages completed after its registration,
+ * from the same queue slots. A slot is writable again when all the consumers have released it.
+ * Consumer 0 is registered by the queue and used by TESEO_LIV3F_GetMessage().
+ *
+ * @param pObj Teseo Module object.
+ * @param Policy TESEO_QUEUE_CONSUMER_LAG or TESEO_QUEUE_CONSUMER_OVERRUN.
+ * @param pId Id of the consumer.
+ *
+ * @return A zero value indicates that the consumer was registered.
+ *         A non-zero value indicates that no consumer was free.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_RegisterConsumer() and not exposed to the application.
+ */
+int32_t                  TESEO_LIV3F_RegisterConsumer(const TESEO_LIV3F_Object_t *pObj, uint8_t Policy, uint32_t *pId);
+
+/**
+ * @brief Unregisters a consumer of the GNSS queue and releases the messages it did not read.
+ *
+ * @param pObj Teseo Module object.
+ * @param Id Id of the consumer.
+ *
+ * @return A zero value indicates that the consumer was unregistered.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_UnregisterConsumer() and not exposed to the application.
+ */
+int32_t                  TESEO_LIV3F_UnregisterConsumer(const TESEO_LIV3F_Object_t *pObj, uint32_t Id);
+
+/**
+ * @brief Returns the oldest message not yet read by a consumer.
+ *
+ * @param pObj Teseo Module object.
+ * @param Id Id of the consumer.
+ *
+ * @return Queue pointer to the NMEA message, NULL if the consumer is not registered.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_GetConsumerMessage() and not exposed to the application.
+ */
+const TESEO_LIV3F_Msg_t  *TESEO_LIV3F_GetConsumerMessage(const TESEO_LIV3F_Object_t *pObj, uint32_t Id);
+
+/**
+ * @brief Releases a message read by a consumer.
+ *
+ * @param pObj Teseo Module object.
+ * @param Id Id of the consumer.
+ * @param Message Message returned by TESEO_LIV3F_GetConsumerMessage().
+ *
+ * @return A zero value indicates that the message was released.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_ReleaseConsumerMessage() and not exposed to the application.
+ */
+int32_t                  TESEO_LIV3F_ReleaseConsumerMessage(const TESEO_LIV3F_Object_t *pObj, uint32_t Id, const TESEO_LIV3F_Msg_t *Message);
+
+/**
+ * @brief Returns the number of messages a consumer missed (OVERRUN policy).
+ *
+ * @param pObj Teseo Module object.
+ * @param Id Id of the consumer.
+ *
+ * @return The number of overruns.
+ */
+uint32_t                 TESEO_LIV3F_GetConsumerOverruns(const TESEO_LIV3F_Object_t *pObj, uint32_t Id);
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /**
  * @brief Sends a message to the Teseo module.
  * 
@@ -251,6 +351,23 @@ int32_t                  TESEO_LIV3F_ReleaseMessage(const TESEO_LIV3F_Object_t *
  */
 int32_t                  TESEO_LIV3F_Send(const TESEO_LIV3F_Object_t *pObj, const TESEO_LIV3F_Msg_t *Message);
 
+#if (CONFIG_USE_RX_STATS == 1)
+/**
+ * @brief Returns a snapshot of the receive path statistics.
+ *
+ * The counters are updated by the bus callbacks and the message queue. Each of them
+ * is a 32-bit word, so every field of the snapshot is consistent on its own.
+ *
+ * @param pObj Teseo module object.
+ * @param pStats Location where the statistics are copied.
+ *
+ * @return A zero value indicates the statistics were copied.
+ *
+ * @remark The function is called from GNSS1A1_GNSS_GetStats() and not exposed to the application.
+ */
+int32_t                  TESEO_LIV3F_GetStats(const TESEO_LIV3F_Object_t *pObj, TESEO_LIV3F_Stats_t *pStats);
+#endif /* CONFIG_USE_RX_STATS */
+
 /**
  * @brief  Implement the API driver function to start (or resume after a given timeout) communication via I2C.
  * @retval none
@@ -17,6 +17,7 @@
   */
 /* Includes ------------------------------------------------------------------*/
 #include "teseo_liv3f_i2c.h"
+#include "teseo_liv3f.h"
 
 /* Private defines -----------------------------------------------------------*/
 
@@ -120,6 +121,9 @@ static void i2c_fsm(uint8_t temp)
       }
       
       Teseo_I2C_Data.wr_msg->len = 0;
+#if (CONFIG_USE_RX_LATENCY == 1)
+      Teseo_I2C_Data.wr_msg->tick = TESEO_LIV3F_CTX_GET_TICK(pCtx);
+#endif /* CONFIG_USE_RX_LATENCY */
       Teseo_I2C_Data.wr_msg->buf[Teseo_I2C_Data.wr_msg->len] = temp; /* save '$' */
       Teseo_I2C_Data.wr_msg->len++;
 
@@ -131,6 +135,12 @@ static void i2c_fsm(uint8_t temp)
       Teseo_I2C_Data.fsm_restart = 0;
       Teseo_I2C_Data.wr_msg->buf[Teseo_I2C_Data.wr_msg->len] = temp;
       Teseo_I2C_Data.wr_msg->len++;
+#if (CONFIG_USE_RX_LATENCY == 1)
+      if (temp == (uint8_t)'\n')
+      {
+        Teseo_I2C_Data.wr_msg->tick = TESEO_LIV3F_CTX_GET_TICK(pCtx);
+      }
+#endif /* CONFIG_USE_RX_LATENCY */
       
       if (Teseo_I2C_Data.wr_msg->buf[Teseo_I2C_Data.wr_msg->len-offset] == (uint8_t)'$')
       {
@@ -202,9 +212,13 @@ void teseo_i2c_rx_callback(Teseo_I2C_CB_CallerTypedef c)
   if (c == _i2c_error)
   {
     PRINT_DBG("Teseo I2C Error on ISR\n\r");
+#if (CONFIG_USE_RX_STATS == 1)
+    pCtx->pQueue->stats.rx_errors++;
+#endif /* CONFIG_USE_RX_STATS */
+    TESEO_LIV3F_TRACE(TESEO_TRACE_RX_ERROR, 0);
     /* suspend I2C-ISR... and try to resume later...*/
 #define TIMEOUT_DELAY	(uint32_t)100
-    Teseo_I2C_Data.timeout = pCtx->GetTick(pCtx->Handle) + TIMEOUT_DELAY;
+    Teseo_I2C_Data.timeout = TESEO_LIV3F_CTX_GET_TICK(pCtx) + TIMEOUT_DELAY;
     Teseo_I2C_Data.state = WAITING; /* turn-off */
     return;
   }
@@ -220,14 +234,14 @@ void teseo_i2c_rx_callback(Teseo_I2C_CB_CallerTypedef c)
   
   if (Teseo_I2C_Data.buf[I2C_LOCAL_BUF-1] == (uint8_t)0xff)
   {
-    Teseo_I2C_Data.timeout = pCtx->GetTick(pCtx->Handle) + TIMEOUT_DELAY;
+    Teseo_I2C_Data.timeout = TESEO_LIV3F_CTX_GET_TICK(pCtx) + TIMEOUT_DELAY;
     Teseo_I2C_Data.state = WAITING;
     return;
   }
 
-  Teseo_I2C_Data.timeout = pCtx->GetTick(pCtx->Handle);
+  Teseo_I2C_Data.timeout = TESEO_LIV3F_CTX_GET_TICK(pCtx);
   Teseo_I2C_Data.state = RUNNING;
-  pCtx->Receive(pCtx->Handle, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
+  (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
 }
 
 void teseo_i2c_onoff(TESEO_LIV3F_ctx_t *pCtx, uint8_t enable, int8_t nr_msg)
@@ -249,10 +263,10 @@ void teseo_i2c_onoff(TESEO_LIV3F_ctx_t *pCtx, uint8_t enable, int8_t nr_msg)
     Teseo_I2C_Data.fsm_next_state = i2c_fsm_discard;
     Teseo_I2C_Data.fsm_restart = 1;
     Teseo_I2C_Data.nr_msg = nr_msg;
-    Teseo_I2C_Data.timeout = pCtx->GetTick(pCtx->Handle);
+    Teseo_I2C_Data.timeout = TESEO_LIV3F_CTX_GET_TICK(pCtx);
     Teseo_I2C_Data.wr_msg = NULL;
     Teseo_I2C_Data.cmd = RUNNING;
-    pCtx->Receive(pCtx->Handle, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
+    (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
     
     return;
   }
@@ -273,11 +287,11 @@ void teseo_i2c_background_process(void)
     return;
   }
 
-  if (pCtx->GetTick(pCtx->Handle) > Teseo_I2C_Data.timeout)
+  if (TESEO_LIV3F_CTX_GET_TICK(pCtx) > Teseo_I2C_Data.timeout)
   {
     //PRINT_DBG("I2C Idle running\n\r");
     Teseo_I2C_Data.state = RUNNING;
-    pCtx->Receive(pCtx->Handle, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
+    (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, (uint8_t *)Teseo_I2C_Data.buf, I2C_LOCAL_BUF);
   }
 }
 
@@ -16,6 +16,7 @@
   ******************************************************************************
   */
 /* Includes ------------------------------------------------------------------*/
+#include <string.h>
 #include "teseo_liv3f_queue.h"
 
 /* Defines -------------------------------------------------------------------*/
@@ -430,6 +431,182 @@ static void check_longer_msg(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F
   }
 }
 
+#if (CONFIG_USE_RX_STATS == 1)
+/*
+ * Updates the high-water mark with the number of buffers not writable.
+ */
+static void __update_hwm(TESEO_LIV3F_Queue_t *pTeseoQueue)
+{
+  uint32_t in_use = ~pTeseoQueue->bitmap_buffer_writable;
+  uint32_t n = 0;
+
+  if (MAX_MSG_QUEUE < 32)
+  {
+    in_use &= ((1UL << (uint32_t)MAX_MSG_QUEUE) - 1UL);
+  }
+  while (in_use != 0U)
+  {
+    in_use &= (in_use - 1U);
+    n++;
+  }
+  if (n > pTeseoQueue->stats.queue_hwm)
+  {
+    pTeseoQueue->stats.queue_hwm = n;
+  }
+}
+#endif /* CONFIG_USE_RX_STATS */
+
+#if (CONFIG_USE_QUEUE_PRIO == 1)
+/*
+ * Returns the priority class of a sentence.
+ */
+static uint8_t __msg_priority(const TESEO_LIV3F_Msg_t *pTeseoMsg)
+{
+  static const struct
+  {
+    char type[5];
+    uint8_t prio;
+  } prio_table[] = TESEO_QUEUE_PRIO_TABLE;
+  const uint8_t *pType;
+  uint32_t i;
+  uint32_t j;
+
+  if (pTeseoMsg->len < 6U)
+  {
+    return TESEO_QUEUE_PRIO_DEFAULT;
+  }
+  /* "$PSTM..." is matched after '$', "$GPGGA" after the talker */
+  pType = (pTeseoMsg->buf[1] == (uint8_t)'P') ? &pTeseoMsg->buf[1] : &pTeseoMsg->buf[3];
+
+  for (i = 0; i < (sizeof(prio_table) / sizeof(prio_table[0])); i++)
+  {
+    for (j = 0; (prio_table[i].type[j] != '\0') && (pType[j] == (uint8_t)prio_table[i].type[j]); j++)
+    {
+    }
+    if (prio_table[i].type[j] == '\0')
+    {
+      return prio_table[i].prio;
+    }
+  }
+
+  return TESEO_QUEUE_PRIO_DEFAULT;
+}
+
+/*
+ * Frees a buffer when the queue is full: the oldest readable sentence of the lowest class is dropped.
+ * The sentence just completed (idx) is dropped if no queued sentence has a lower class.
+ */
+static void __make_room(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t idx)
+{
+  uint32_t readable = pTeseoQueue->bitmap_buffer_readable & ~(1UL << idx);
+  uint32_t victim = idx;
+  uint32_t i;
+
+  for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+  {
+    if ((readable & (1UL << i)) == 0U)
+    {
+      continue;
+    }
+    if ((pTeseoQueue->prio[i] < pTeseoQueue->prio[victim]) ||
+        ((victim != idx) && (pTeseoQueue->prio[i] == pTeseoQueue->prio[victim]) &&
+         ((int32_t)(pTeseoQueue->seq[i] - pTeseoQueue->seq[victim]) < 0)))
+    {
+      victim = i;
+    }
+  }
+
+  pTeseoQueue->bitmap_buffer_readable &= ~(1UL << victim);
+  pTeseoQueue->bitmap_buffer_writable |= (1UL << victim);
+  check_longer_msg(pTeseoQueue, &pTeseoQueue->nmea_queue[victim], victim, 0);
+  TESEO_LIV3F_TRACE(TESEO_TRACE_EVICT, victim);
+#if (CONFIG_USE_RX_STATS == 1)
+  pTeseoQueue->stats.evictions++;
+#endif /* CONFIG_USE_RX_STATS */
+}
+#endif /* CONFIG_USE_QUEUE_PRIO */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/*
+ * Returns the bitmask of the registered consumers, optionally only the ones with the LAG policy.
+ */
+static uint8_t __consumers_mask(const TESEO_LIV3F_Queue_t *pTeseoQueue, uint8_t lag_only)
+{
+  uint8_t mask = 0;
+  uint32_t c;
+
+  for (c = 0; c < (uint32_t)TESEO_QUEUE_CONSUMERS_NBR; c++)
+  {
+    if ((pTeseoQueue->consumers[c].registered != 0U) &&
+        ((lag_only == 0U) || (pTeseoQueue->consumers[c].policy == TESEO_QUEUE_CONSUMER_LAG)))
+    {
+      mask |= (uint8_t)(1U << c);
+    }
+  }
+
+  return mask;
+}
+
+/*
+ * Makes a buffer writable again, once no consumer is left to read it.
+ */
+static void __bcast_free(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t idx)
+{
+  pTeseoQueue->bitmap_buffer_readable &= ~(1UL << idx);
+  pTeseoQueue->bitmap_buffer_writable |= (1UL << idx);
+  check_longer_msg(pTeseoQueue, &pTeseoQueue->nmea_queue[idx], idx, 0);
+}
+
+/*
+ * Frees a buffer when the queue is full: the oldest sentence that only OVERRUN consumers
+ * still have to read is reclaimed. A buffer being read is never reclaimed.
+ */
+static void __bcast_reclaim(TESEO_LIV3F_Queue_t *pTeseoQueue)
+{
+  uint8_t lag_mask = __consumers_mask(pTeseoQueue, 1U);
+  uint32_t readable = pTeseoQueue->bitmap_buffer_readable;
+  int32_t victim = -1;
+  uint32_t i;
+  uint32_t c;
+
+  for (c = 0; c < (uint32_t)TESEO_QUEUE_CONSUMERS_NBR; c++)
+  {
+    if (pTeseoQueue->consumers[c].rd_idx >= 0)
+    {
+      readable &= ~(1UL << (uint32_t)pTeseoQueue->consumers[c].rd_idx);
+    }
+  }
+
+  for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+  {
+    if (((readable & (1UL << i)) == 0U) || ((pTeseoQueue->pending[i] & lag_mask) != 0U))
+    {
+      continue;
+    }
+    if ((victim < 0) || ((int32_t)(pTeseoQueue->seq[i] - pTeseoQueue->seq[victim]) < 0))
+    {
+      victim = (int32_t)i;
+    }
+  }
+
+  if (victim < 0)
+  {
+    return;
+  }
+
+  for (c = 0; c < (uint32_t)TESEO_QUEUE_CONSUMERS_NBR; c++)
+  {
+    if ((pTeseoQueue->pending[victim] & (1U << c)) != 0U)
+    {
+      pTeseoQueue->consumers[c].overruns++;
+    }
+  }
+  pTeseoQueue->pending[victim] = 0;
+  __bcast_free(pTeseoQueue, (uint32_t)victim);
+  TESEO_LIV3F_TRACE(TESEO_TRACE_EVICT, victim);
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /* Exported functions --------------------------------------------------------*/
 TESEO_LIV3F_Queue_t *teseo_queue_init(void)
 {
@@ -448,6 +625,21 @@ TESEO_LIV3F_Queue_t *teseo_queue_init(void)
     pTeseoQueue->bitmap_buffer_writable |=  (1UL << (uint8_t)i);
   }
   pTeseoQueue->bitmap_buffer_readable = 0;
+#if (CONFIG_USE_RX_STATS == 1)
+  (void)memset(&pTeseoQueue->stats, 0, sizeof(pTeseoQueue->stats));
+#endif /* CONFIG_USE_RX_STATS */
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  pTeseoQueue->wr_seq = 0;
+  (void)memset(pTeseoQueue->pending, 0, sizeof(pTeseoQueue->pending));
+  (void)memset(pTeseoQueue->consumers, 0, sizeof(pTeseoQueue->consumers));
+  for (i = 0; i < TESEO_QUEUE_CONSUMERS_NBR; ++i)
+  {
+    pTeseoQueue->consumers[i].rd_idx = -1;
+  }
+  /* consumer 0 serves teseo_queue_claim_rd_buffer() */
+  pTeseoQueue->consumers[0].registered = 1;
+  pTeseoQueue->consumers[0].policy = TESEO_QUEUE_CONSUMER_LAG;
+#endif /* CONFIG_USE_QUEUE_BCAST */
 #if (ANY_RTOS)
   pTeseoQueue->bitmap_unreleased_buffer_irq = 0;
   pTeseoQueue->semaphore = semaphore_create();  
@@ -476,18 +668,34 @@ TESEO_LIV3F_Msg_t *teseo_queue_claim_wr_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue)
 
   /* semaphore already taken.... */
   if (ret != OS_SUCCESS) {
+#if (CONFIG_USE_RX_STATS == 1)
+    pTeseoQueue->stats.drops++;
+#endif /* CONFIG_USE_RX_STATS */
+    TESEO_LIV3F_TRACE(TESEO_TRACE_WR_DROP, 0);
     return NULL;
   }
 #endif /* ANY_RTOS */
 
   /* first available buffer writable */
   i = teseo_ffs(pTeseoQueue->bitmap_buffer_writable);
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  if (i == 0) {
+    /* take the oldest sentence back from the consumers that accept overruns */
+    __bcast_reclaim(pTeseoQueue);
+    i = teseo_ffs(pTeseoQueue->bitmap_buffer_writable);
+  }
+#endif /* CONFIG_USE_QUEUE_BCAST */
   
   if (i == 0) {
 #if (ANY_RTOS)
     /* release the semaphore */
     semaphore_free_irq(pTeseoQueue->semaphore);
 #endif /* ANY_RTOS */
+#if (CONFIG_USE_RX_STATS == 1)
+    pTeseoQueue->stats.drops++;
+#endif /* CONFIG_USE_RX_STATS */
+    TESEO_LIV3F_TRACE(TESEO_TRACE_WR_DROP, 0);
     PRINT_DBG("-\n\r");
     return NULL;
   }
@@ -498,6 +706,9 @@ TESEO_LIV3F_Msg_t *teseo_queue_claim_wr_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue)
   pTeseoQueue->bitmap_buffer_writable &= ~(1U << (uint32_t)i);
   
   __check_unreleased_buffer(pTeseoQueue);
+#if (CONFIG_USE_RX_STATS == 1)
+  __update_hwm(pTeseoQueue);
+#endif /* CONFIG_USE_RX_STATS */
 
 #if (ANY_RTOS)
   semaphore_free_irq(pTeseoQueue->semaphore);
@@ -505,6 +716,7 @@ TESEO_LIV3F_Msg_t *teseo_queue_claim_wr_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue)
 
   pTeseoMsg = &pTeseoQueue->nmea_queue[i];
   pTeseoMsg->len = 0;
+  TESEO_LIV3F_TRACE(TESEO_TRACE_WR_CLAIM, i);
   
   return pTeseoMsg;
 }
@@ -526,6 +738,25 @@ void teseo_queue_release_wr_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, TESEO_LIV3F
     /* this should NEVER happen... this means an external buffer was provided */
     return;
   }
+
+#if (CONFIG_USE_RX_STATS == 1)
+  pTeseoQueue->stats.rx_msgs++;
+#endif /* CONFIG_USE_RX_STATS */
+  TESEO_LIV3F_TRACE(TESEO_TRACE_WR_RELEASE, i);
+
+#if (CONFIG_USE_QUEUE_PRIO == 1)
+  pTeseoQueue->prio[i] = __msg_priority(pTeseoMsg);
+#endif /* CONFIG_USE_QUEUE_PRIO */
+
+#if (CONFIG_USE_QUEUE_BATCH == 1) || (CONFIG_USE_QUEUE_BCAST == 1) || (CONFIG_USE_QUEUE_PRIO == 1)
+  pTeseoQueue->seq[i] = pTeseoQueue->wr_seq;
+  pTeseoQueue->wr_seq++;
+#endif /* CONFIG_USE_QUEUE_BATCH || CONFIG_USE_QUEUE_BCAST || CONFIG_USE_QUEUE_PRIO */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  /* every consumer registered now has to read the sentence */
+  pTeseoQueue->pending[i] = __consumers_mask(pTeseoQueue, 0U);
+#endif /* CONFIG_USE_QUEUE_BCAST */
   
 #if (ANY_RTOS)
   ret = semaphore_lock_irq(pTeseoQueue->semaphore);
@@ -545,12 +776,39 @@ void teseo_queue_release_wr_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, TESEO_LIV3F
   /* check for longer message */
   check_longer_msg(pTeseoQueue, pTeseoMsg, (uint32_t)i, 1);
 
+#if (CONFIG_USE_QUEUE_PRIO == 1)
+  /* keep a buffer for the next sentence, dropping the least important one */
+  if (pTeseoQueue->bitmap_buffer_writable == 0U)
+  {
+    __make_room(pTeseoQueue, (uint32_t)i);
+  }
+#endif /* CONFIG_USE_QUEUE_PRIO */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  /* no consumer: the buffer is not kept */
+  if (pTeseoQueue->pending[i] == 0U)
+  {
+    __bcast_free(pTeseoQueue, (uint32_t)i);
+  }
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 #if (ANY_RTOS)
   __check_unreleased_buffer(pTeseoQueue);
   semaphore_free_irq(pTeseoQueue->semaphore);
 #endif /* ANY_RTOS */
 }
 
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue)
+{
+  return teseo_queue_claim_rd_consumer(pTeseoQueue, 0U);
+}
+
+void teseo_queue_release_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pTeseoMsg)
+{
+  teseo_queue_release_rd_consumer(pTeseoQueue, 0U, pTeseoMsg);
+}
+#else
 const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue)
 {
   const TESEO_LIV3F_Msg_t *pTeseoMsg = NULL;
@@ -591,6 +849,7 @@ const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_buffer(TESEO_LIV3F_Queue_t *pTeseo
     /* buffer no more readable */
     pTeseoQueue->bitmap_buffer_readable &= ~(1UL << (uint32_t)i);
     pTeseoMsg = &pTeseoQueue->nmea_queue[i];
+    TESEO_LIV3F_TRACE(TESEO_TRACE_RD_CLAIM, i);
 
 #if (ANY_RTOS)
     semaphore_free(pTeseoQueue->semaphore);
@@ -626,6 +885,7 @@ void teseo_queue_release_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO
 
   /* mark the buffer as writeable */
   pTeseoQueue->bitmap_buffer_writable |= (1UL << (uint32_t)i);
+  TESEO_LIV3F_TRACE(TESEO_TRACE_RD_RELEASE, i);
 
   /* check for longer message */
   check_longer_msg(pTeseoQueue, pTeseoMsg, (uint32_t)i, 0);
@@ -634,6 +894,327 @@ void teseo_queue_release_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO
   semaphore_free(pTeseoQueue->semaphore);
 #endif /* ANY_RTOS */
 }
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+uint32_t teseo_queue_claim_rd_batch(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t max)
+{
+  uint32_t idx[MAX_MSG_QUEUE];
+  uint32_t readable;
+  uint32_t nbr = 0;
+  uint32_t i;
+  uint32_t j;
+  uint8_t rd_buffer_re_try = 1;
+
+#if (ANY_RTOS)
+  BaseVal_t ret;
+#endif /* ANY_RTOS */
+
+  while(rd_buffer_re_try == 1U) {
+#if (ANY_RTOS)
+    ret = semaphore_lock(pTeseoQueue->semaphore);
+
+    /* semaphore already taken.... */
+    if (ret != OS_SUCCESS) {
+      return 0;
+    }
+#endif /* ANY_RTOS */
+
+    readable = pTeseoQueue->bitmap_buffer_readable;
+
+    if (readable == 0U) {
+#if (ANY_RTOS)
+      /* release the semaphore */
+      semaphore_free(pTeseoQueue->semaphore);
+      os_delay();
+      continue;
+#else   /* no RTOS: bare metal */
+      break;
+#endif /* ANY_RTOS */
+    }
+
+    /* collect the max oldest readable buffers, oldest first */
+    for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+    {
+      if ((readable & (1UL << i)) == 0U)
+      {
+        continue;
+      }
+      if (nbr == max)
+      {
+        /* no room: the buffer replaces the newest one collected, if older */
+        if ((max == 0U) || ((int32_t)(pTeseoQueue->seq[i] - pTeseoQueue->seq[idx[max - 1U]]) >= 0))
+        {
+          continue;
+        }
+        nbr--;
+      }
+      for (j = nbr; (j > 0U) && ((int32_t)(pTeseoQueue->seq[i] - pTeseoQueue->seq[idx[j - 1U]]) < 0); j--)
+      {
+        idx[j] = idx[j - 1U];
+      }
+      idx[j] = i;
+      nbr++;
+    }
+
+    for (i = 0; i < nbr; i++)
+    {
+      /* buffer no more readable */
+      pTeseoQueue->bitmap_buffer_readable &= ~(1UL << idx[i]);
+      pMsgs[i] = &pTeseoQueue->nmea_queue[idx[i]];
+      TESEO_LIV3F_TRACE(TESEO_TRACE_RD_CLAIM, idx[i]);
+    }
+
+#if (ANY_RTOS)
+    semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+
+    rd_buffer_re_try = 0;
+  } /* while */
+  return nbr;
+}
+
+void teseo_queue_release_rd_batch(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t nbr)
+{
+  int32_t i;
+  uint32_t k;
+
+#if (ANY_RTOS)
+  BaseVal_t ret;
+
+  ret = semaphore_lock(pTeseoQueue->semaphore);
+
+  /* semaphore already taken.... */
+  if (ret != OS_SUCCESS) {
+    return;
+  }
+#endif /* ANY_RTOS */
+
+  for (k = 0; k < nbr; k++)
+  {
+    i = __find_msg_idx(pTeseoQueue, pMsgs[k]);
+    if (i < 0) {
+      /* this should NEVER happen... this means an external buffer was provided */
+      continue;
+    }
+
+    /* mark the buffer as writeable */
+    pTeseoQueue->bitmap_buffer_writable |= (1UL << (uint32_t)i);
+    TESEO_LIV3F_TRACE(TESEO_TRACE_RD_RELEASE, i);
+
+    /* check for longer message */
+    check_longer_msg(pTeseoQueue, pMsgs[k], (uint32_t)i, 0);
+  }
+
+#if (ANY_RTOS)
+  semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+}
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+int32_t teseo_queue_register_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint8_t policy)
+{
+  int32_t id = -1;
+  uint32_t c;
+  uint32_t i;
+
+#if (ANY_RTOS)
+  BaseVal_t ret;
+
+  ret = semaphore_lock(pTeseoQueue->semaphore);
+
+  /* semaphore already taken.... */
+  if (ret != OS_SUCCESS) {
+    return -1;
+  }
+#endif /* ANY_RTOS */
+
+  for (c = 0; c < (uint32_t)TESEO_QUEUE_CONSUMERS_NBR; c++)
+  {
+    if (pTeseoQueue->consumers[c].registered == 0U)
+    {
+      /* the sentences already queued are not for the new consumer */
+      for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+      {
+        pTeseoQueue->pending[i] &= (uint8_t)~(1U << c);
+      }
+      pTeseoQueue->consumers[c].policy = policy;
+      pTeseoQueue->consumers[c].rd_idx = -1;
+      pTeseoQueue->consumers[c].overruns = 0;
+      pTeseoQueue->consumers[c].registered = 1;
+      id = (int32_t)c;
+      break;
+    }
+  }
+
+#if (ANY_RTOS)
+  semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+
+  return id;
+}
+
+void teseo_queue_unregister_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id)
+{
+  uint32_t i;
 
+#if (ANY_RTOS)
+  BaseVal_t ret;
+#endif /* ANY_RTOS */
+
+  if (id >= (uint32_t)TESEO_QUEUE_CONSUMERS_NBR) {
+    return;
+  }
+
+#if (ANY_RTOS)
+  ret = semaphore_lock(pTeseoQueue->semaphore);
+
+  /* semaphore already taken.... */
+  if (ret != OS_SUCCESS) {
+    return;
+  }
+#endif /* ANY_RTOS */
 
+  pTeseoQueue->consumers[id].registered = 0;
+  pTeseoQueue->consumers[id].rd_idx = -1;
 
+  /* release the sentences the consumer did not read */
+  for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+  {
+    if ((pTeseoQueue->pending[i] & (1U << id)) == 0U)
+    {
+      continue;
+    }
+    pTeseoQueue->pending[i] &= (uint8_t)~(1U << id);
+    if ((pTeseoQueue->pending[i] == 0U) && ((pTeseoQueue->bitmap_buffer_readable & (1UL << i)) != 0U))
+    {
+      __bcast_free(pTeseoQueue, i);
+    }
+  }
+
+#if (ANY_RTOS)
+  semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+}
+
+const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id)
+{
+  const TESEO_LIV3F_Msg_t *pTeseoMsg = NULL;
+  int32_t idx;
+  uint32_t i;
+  uint8_t rd_buffer_re_try = 1;
+
+#if (ANY_RTOS)
+  BaseVal_t ret;
+#endif /* ANY_RTOS */
+
+  if (id >= (uint32_t)TESEO_QUEUE_CONSUMERS_NBR) {
+    return NULL;
+  }
+
+  while(rd_buffer_re_try == 1U) {
+#if (ANY_RTOS)
+    ret = semaphore_lock(pTeseoQueue->semaphore);
+
+    /* semaphore already taken.... */
+    if (ret != OS_SUCCESS) {
+      return NULL;
+    }
+#endif /* ANY_RTOS */
+
+    /* unknown consumer, or unregistered while waiting: there is nothing to wait for */
+    if (pTeseoQueue->consumers[id].registered == 0U) {
+#if (ANY_RTOS)
+      semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+      break;
+    }
+
+    /* oldest readable buffer not yet read by the consumer */
+    idx = -1;
+    for (i = 0; i < (uint32_t)MAX_MSG_QUEUE; i++)
+    {
+      if (((pTeseoQueue->bitmap_buffer_readable & (1UL << i)) == 0U) ||
+          ((pTeseoQueue->pending[i] & (1U << id)) == 0U))
+      {
+        continue;
+      }
+      if ((idx < 0) || ((int32_t)(pTeseoQueue->seq[i] - pTeseoQueue->seq[idx]) < 0))
+      {
+        idx = (int32_t)i;
+      }
+    }
+
+    if (idx < 0) {
+#if (ANY_RTOS)
+      /* release the semaphore */
+      semaphore_free(pTeseoQueue->semaphore);
+      os_delay();
+      continue;
+#else   /* no RTOS: bare metal */
+      break;
+#endif /* ANY_RTOS */
+    }
+
+    /* the buffer stays readable for the other consumers */
+    pTeseoQueue->consumers[id].rd_idx = (int8_t)idx;
+    pTeseoMsg = &pTeseoQueue->nmea_queue[idx];
+    TESEO_LIV3F_TRACE(TESEO_TRACE_RD_CLAIM, idx);
+
+#if (ANY_RTOS)
+    semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+
+    rd_buffer_re_try = 0;
+  } /* while */
+  return pTeseoMsg;
+}
+
+void teseo_queue_release_rd_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id, const TESEO_LIV3F_Msg_t *pTeseoMsg)
+{
+  int32_t i;
+
+#if (ANY_RTOS)
+  BaseVal_t ret;
+#endif /* ANY_RTOS */
+
+  i = __find_msg_idx(pTeseoQueue, pTeseoMsg);
+  if ((i < 0) || (id >= (uint32_t)TESEO_QUEUE_CONSUMERS_NBR)) {
+    /* this should NEVER happen... this means an external buffer was provided */
+    return;
+  }
+
+#if (ANY_RTOS)
+  ret = semaphore_lock(pTeseoQueue->semaphore);
+
+  /* semaphore already taken.... */
+  if (ret != OS_SUCCESS) {
+    return;
+  }
+#endif /* ANY_RTOS */
+
+  pTeseoQueue->consumers[id].rd_idx = -1;
+  pTeseoQueue->pending[i] &= (uint8_t)~(1U << id);
+  TESEO_LIV3F_TRACE(TESEO_TRACE_RD_RELEASE, i);
+
+  /* the last consumer makes the buffer writable */
+  if ((pTeseoQueue->pending[i] == 0U) && ((pTeseoQueue->bitmap_buffer_readable & (1UL << (uint32_t)i)) != 0U))
+  {
+    __bcast_free(pTeseoQueue, (uint32_t)i);
+  }
+
+#if (ANY_RTOS)
+  semaphore_free(pTeseoQueue->semaphore);
+#endif /* ANY_RTOS */
+}
+
+uint32_t teseo_queue_get_overruns(const TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id)
+{
+  if (id >= (uint32_t)TESEO_QUEUE_CONSUMERS_NBR) {
+    return 0;
+  }
+
+  return pTeseoQueue->consumers[id].overruns;
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
@@ -59,15 +59,77 @@ extern "C" {
 
 /* Exported defines ----------------------------------------------------------*/
 /**
- * @brief Constant for the maximum message queue size
+ * @brief Constant for the maximum message queue size (at most 32, the width of the buffer bitmaps)
  */
+#ifndef MAX_MSG_QUEUE
 #define MAX_MSG_QUEUE    (8)
+#endif /* MAX_MSG_QUEUE */
 
 /**
  * @brief Constant for the maximum number of messages in the queue
  */
 #define MAX_MSG_BUF     (80)
 
+#if (CONFIG_USE_QUEUE_PRIO == 1)
+/**
+ * @brief Priority classes of the sentences. When the queue is full, a completed sentence
+ *        replaces the queued sentence of the lowest class, if its own class is higher.
+ *        The table matches the sentence type ("GGA" in "$GPGGA") or, for proprietary
+ *        sentences, the prefix after '$' ("PSTM"). Sentences not listed get the default class.
+ */
+#ifndef TESEO_QUEUE_PRIO_TABLE
+#define TESEO_QUEUE_PRIO_TABLE  { {"GGA", 3U}, {"RMC", 3U}, {"GNS", 3U}, {"PSTM", 3U}, \
+                                  {"GSA", 1U}, {"GSV", 0U} }
+#endif /* TESEO_QUEUE_PRIO_TABLE */
+
+#ifndef TESEO_QUEUE_PRIO_DEFAULT
+#define TESEO_QUEUE_PRIO_DEFAULT  (2U)
+#endif /* TESEO_QUEUE_PRIO_DEFAULT */
+#endif /* CONFIG_USE_QUEUE_PRIO */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+#if (CONFIG_USE_QUEUE_PRIO == 1) || (CONFIG_USE_QUEUE_BATCH == 1)
+#error "CONFIG_USE_QUEUE_BCAST cannot be combined with CONFIG_USE_QUEUE_PRIO or CONFIG_USE_QUEUE_BATCH"
+#endif /* CONFIG_USE_QUEUE_PRIO || CONFIG_USE_QUEUE_BATCH */
+/**
+ * @brief Maximum number of consumers of the broadcast queue (at most 8).
+ *        Consumer 0 is registered at init and serves teseo_queue_claim_rd_buffer().
+ */
+#ifndef TESEO_QUEUE_CONSUMERS_NBR
+#define TESEO_QUEUE_CONSUMERS_NBR  (3)
+#endif /* TESEO_QUEUE_CONSUMERS_NBR */
+
+#if (TESEO_QUEUE_CONSUMERS_NBR > 8)
+#error "TESEO_QUEUE_CONSUMERS_NBR must be at most 8"
+#endif /* TESEO_QUEUE_CONSUMERS_NBR */
+
+/**
+ * @brief Policies of a consumer that does not keep up with the receive rate.
+ *        LAG: the queue waits for the consumer, new sentences are dropped when it is full.
+ *        OVERRUN: the oldest sentences not yet read by the consumer are reclaimed for
+ *        the new ones, and the consumer overrun counter is incremented.
+ */
+#define TESEO_QUEUE_CONSUMER_LAG      (0U)
+#define TESEO_QUEUE_CONSUMER_OVERRUN  (1U)
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
+/**
+ * @brief Trace points of the receive path. teseo_liv3f_conf.h can define
+ *        TESEO_LIV3F_TRACE(evt, arg) to record them, e.g. in a RAM ring or in the RTOS
+ *        trace log. The macro is called from the bus ISR too: it must not block.
+ */
+#define TESEO_TRACE_WR_CLAIM    (1U) /**< '$' received, arg: buffer index */
+#define TESEO_TRACE_WR_DROP     (2U) /**< '$' received, no buffer, arg: 0 */
+#define TESEO_TRACE_WR_RELEASE  (3U) /**< Sentence queued, arg: buffer index */
+#define TESEO_TRACE_RD_CLAIM    (4U) /**< Sentence got by a reader, arg: buffer index */
+#define TESEO_TRACE_RD_RELEASE  (5U) /**< Sentence released by a reader, arg: buffer index */
+#define TESEO_TRACE_EVICT       (6U) /**< Queued sentence reclaimed, arg: buffer index */
+#define TESEO_TRACE_RX_ERROR    (7U) /**< Bus error, arg: 0 */
+
+#ifndef TESEO_LIV3F_TRACE
+#define TESEO_LIV3F_TRACE(evt, arg)
+#endif /* TESEO_LIV3F_TRACE */
+
 /**
  * @}
  */
@@ -84,8 +146,38 @@ typedef struct
 {
   uint8_t *buf;
   uint16_t len;
+#if (CONFIG_USE_RX_LATENCY == 1)
+  uint32_t tick; /**< Tick at the end of the sentence ('\n' received) */
+#endif /* CONFIG_USE_RX_LATENCY */
 } TESEO_LIV3F_Msg_t;
 
+#if (CONFIG_USE_RX_STATS == 1)
+/**
+ * @brief Receive path statistics, updated from the bus ISR.
+ */
+typedef struct
+{
+  uint32_t rx_msgs;     /**< Sentences completed and queued */
+  uint32_t drops;       /**< Sentences dropped, no writable buffer */
+  uint32_t evictions;   /**< Sentences dropped by priority, queue full */
+  uint32_t rx_errors;   /**< Bus errors (UART overruns cleared, I2C errors) */
+  uint32_t queue_hwm;   /**< Highest number of buffers in use at once */
+} TESEO_LIV3F_Stats_t;
+#endif /* CONFIG_USE_RX_STATS */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/**
+ * @brief Read cursor of a consumer of the broadcast queue.
+ */
+typedef struct
+{
+  uint8_t registered;   /**< The consumer is in use */
+  uint8_t policy;       /**< TESEO_QUEUE_CONSUMER_LAG or TESEO_QUEUE_CONSUMER_OVERRUN */
+  int8_t rd_idx;        /**< Buffer being read, -1 if none */
+  uint32_t overruns;    /**< Sentences reclaimed before the consumer read them */
+} TESEO_LIV3F_Consumer_t;
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /**
  * @brief Data structure for the Teseo Message Queue.
  */
@@ -115,6 +207,20 @@ typedef struct
   uint32_t bitmap_buffer_readable;
   TESEO_LIV3F_Msg_t nmea_queue[MAX_MSG_QUEUE];
   uint8_t single_message_buffer[MAX_MSG_QUEUE * MAX_MSG_BUF];
+#if (CONFIG_USE_QUEUE_PRIO == 1)
+  uint8_t prio[MAX_MSG_QUEUE];
+#endif /* CONFIG_USE_QUEUE_PRIO */
+#if (CONFIG_USE_QUEUE_BATCH == 1) || (CONFIG_USE_QUEUE_BCAST == 1) || (CONFIG_USE_QUEUE_PRIO == 1)
+  uint32_t wr_seq;
+  uint32_t seq[MAX_MSG_QUEUE];
+#endif /* CONFIG_USE_QUEUE_BATCH || CONFIG_USE_QUEUE_BCAST || CONFIG_USE_QUEUE_PRIO */
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  uint8_t pending[MAX_MSG_QUEUE]; /**< Bitmask of the consumers that did not release the buffer */
+  TESEO_LIV3F_Consumer_t consumers[TESEO_QUEUE_CONSUMERS_NBR];
+#endif /* CONFIG_USE_QUEUE_BCAST */
+#if (CONFIG_USE_RX_STATS == 1)
+  TESEO_LIV3F_Stats_t stats;
+#endif /* CONFIG_USE_RX_STATS */
 } TESEO_LIV3F_Queue_t;
 
 typedef struct
@@ -129,6 +235,25 @@ typedef struct
   void *Handle;
 } TESEO_LIV3F_ctx_t;
 
+/**
+ * @brief Bus access from the receive state machines. With CONFIG_USE_STATIC_BUS the
+ *        functions are bound at compile time by teseo_liv3f_conf.h, which defines
+ *        TESEO_LIV3F_BUS_RECEIVE_IT(pData, Length), TESEO_LIV3F_BUS_TRANSMIT_IT(pData, Length),
+ *        TESEO_LIV3F_BUS_GET_TICK() and, for the UART, TESEO_LIV3F_BUS_CLEAR_OREF().
+ */
+#if (CONFIG_USE_STATIC_BUS == 1)
+#ifndef TESEO_LIV3F_BUS_CLEAR_OREF
+#define TESEO_LIV3F_BUS_CLEAR_OREF()  ((void)0) /* I2C bus */
+#endif /* TESEO_LIV3F_BUS_CLEAR_OREF */
+#define TESEO_LIV3F_CTX_RECEIVE(pCtx, pData, Length)  ((void)(pCtx), (int32_t)TESEO_LIV3F_BUS_RECEIVE_IT((pData), (Length)))
+#define TESEO_LIV3F_CTX_GET_TICK(pCtx)                ((void)(pCtx), (uint32_t)TESEO_LIV3F_BUS_GET_TICK())
+#define TESEO_LIV3F_CTX_CLEAR_OREF(pCtx)              ((void)(pCtx), TESEO_LIV3F_BUS_CLEAR_OREF())
+#else
+#define TESEO_LIV3F_CTX_RECEIVE(pCtx, pData, Length)  ((pCtx)->Receive((pCtx)->Handle, (pData), (Length)))
+#define TESEO_LIV3F_CTX_GET_TICK(pCtx)                ((pCtx)->GetTick((pCtx)->Handle))
+#define TESEO_LIV3F_CTX_CLEAR_OREF(pCtx)              ((pCtx)->ClearOREF((pCtx)->Handle))
+#endif /* CONFIG_USE_STATIC_BUS */
+
 /**
  * @}
  */
@@ -181,6 +306,72 @@ const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_buffer(TESEO_LIV3F_Queue_t *pTeseo
  */
 void teseo_queue_release_rd_buffer(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pMsg);
 
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+/**
+ * @brief  Low level driver function to get all the buffers (queue messages) to be read, in arrival order.
+ * @param  pTeseoQueue The message queue
+ * @param  pMsgs       The array filled with the messages retrieved
+ * @param  max         The size of the array
+ * @retval The number of messages retrieved
+ */
+uint32_t teseo_queue_claim_rd_batch(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t max);
+
+/**
+ * @brief  Low level driver function to release the buffers (queue messages) got by teseo_queue_claim_rd_batch.
+ * @param  pTeseoQueue The message queue
+ * @param  pMsgs       The messages to be released for a new write
+ * @param  nbr         The number of messages
+ * @retval None
+ */
+void teseo_queue_release_rd_batch(TESEO_LIV3F_Queue_t *pTeseoQueue, const TESEO_LIV3F_Msg_t *pMsgs[], uint32_t nbr);
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/**
+ * @brief  Low level driver function to register a new consumer of the broadcast queue.
+ *         The consumer reads the sentences completed after its registration.
+ * @param  pTeseoQueue The message queue
+ * @param  policy      TESEO_QUEUE_CONSUMER_LAG or TESEO_QUEUE_CONSUMER_OVERRUN
+ * @retval The consumer id, -1 if no consumer is free
+ */
+int32_t teseo_queue_register_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint8_t policy);
+
+/**
+ * @brief  Low level driver function to unregister a consumer of the broadcast queue.
+ *         The buffers it did not read are released.
+ * @param  pTeseoQueue The message queue
+ * @param  id          The consumer id
+ * @retval None
+ */
+void teseo_queue_unregister_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id);
+
+/**
+ * @brief  Low level driver function to get the oldest buffer (queue message) not yet read by a consumer.
+ * @param  pTeseoQueue The message queue
+ * @param  id          The consumer id
+ * @retval The message retrieved, NULL if the consumer is not registered
+ */
+const TESEO_LIV3F_Msg_t *teseo_queue_claim_rd_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id);
+
+/**
+ * @brief  Low level driver function to release a buffer (queue message) read by a consumer.
+ *         The buffer is writable again once every consumer has released it.
+ * @param  pTeseoQueue The message queue
+ * @param  id          The consumer id
+ * @param  pMsg        The message got by teseo_queue_claim_rd_consumer
+ * @retval None
+ */
+void teseo_queue_release_rd_consumer(TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id, const TESEO_LIV3F_Msg_t *pMsg);
+
+/**
+ * @brief  Low level driver function to get the number of sentences a consumer missed.
+ * @param  pTeseoQueue The message queue
+ * @param  id          The consumer id
+ * @retval The number of overruns
+ */
+uint32_t teseo_queue_get_overruns(const TESEO_LIV3F_Queue_t *pTeseoQueue, uint32_t id);
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /**
  * @}
  */
@@ -77,7 +77,7 @@ static void teseo_rx_callback_ok(void)
       if (Teseo_UART_Data.dummy_char != (uint8_t)'$')
       {
         //PRINT_DBG(".");
-        pCtx->Receive(pCtx->Handle, &Teseo_UART_Data.dummy_char, 1);
+        (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, &Teseo_UART_Data.dummy_char, 1);
         break;
       }
       
@@ -89,16 +89,19 @@ static void teseo_rx_callback_ok(void)
       if (Teseo_UART_Data.wr_msg == NULL)
       {
         //PRINT_DBG(".");
-        pCtx->Receive(pCtx->Handle, &Teseo_UART_Data.dummy_char, 1);
+        (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, &Teseo_UART_Data.dummy_char, 1);
         break;
       }
       //PRINT_DBG("S");
 
+#if (CONFIG_USE_RX_LATENCY == 1)
+      Teseo_UART_Data.wr_msg->tick = TESEO_LIV3F_CTX_GET_TICK(pCtx);
+#endif /* CONFIG_USE_RX_LATENCY */
       /* save '$' */
       Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len] = Teseo_UART_Data.dummy_char;
       Teseo_UART_Data.wr_msg->len++;
       Teseo_UART_Data.fsm_next_state = fsm_synch ;
-      pCtx->Receive(pCtx->Handle, (uint8_t *)&Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len], 1);
+      (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, (uint8_t *)&Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len], 1);
        break;
        
     case fsm_synch:
@@ -116,6 +119,12 @@ static void teseo_rx_callback_ok(void)
         break;
       }
       
+#if (CONFIG_USE_RX_LATENCY == 1)
+      if (Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len] == (uint8_t)'\n')
+      {
+        Teseo_UART_Data.wr_msg->tick = TESEO_LIV3F_CTX_GET_TICK(pCtx);
+      }
+#endif /* CONFIG_USE_RX_LATENCY */
       //PRINT_DBG("+");
       Teseo_UART_Data.wr_msg->len++;
 #if 0
@@ -132,7 +141,7 @@ static void teseo_rx_callback_ok(void)
       }
 #endif
       Teseo_UART_Data.fsm_next_state = fsm_synch;
-      pCtx->Receive(pCtx->Handle, (uint8_t *)&Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len], 1);
+      (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, (uint8_t *)&Teseo_UART_Data.wr_msg->buf[Teseo_UART_Data.wr_msg->len], 1);
       break;
       
     case fsm_stop:
@@ -154,9 +163,13 @@ static void teseo_rx_callback_error(void)
   
   Teseo_UART_Data.fsm_next_state = fsm_discard;
   Teseo_UART_Data.wr_msg->len = 0;
-  pCtx->ClearOREF(pCtx->Handle);
+  TESEO_LIV3F_CTX_CLEAR_OREF(pCtx);
+#if (CONFIG_USE_RX_STATS == 1)
+  pCtx->pQueue->stats.rx_errors++;
+#endif /* CONFIG_USE_RX_STATS */
+  TESEO_LIV3F_TRACE(TESEO_TRACE_RX_ERROR, 0);
   //__HAL_UART_CLEAR_FLAG(teseo_io_data->huart, UART_FLAG_ORE);
-  pCtx->Receive(pCtx->Handle, &Teseo_UART_Data.dummy_char, 1);
+  (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, &Teseo_UART_Data.dummy_char, 1);
 }
 
 /* Exported functions --------------------------------------------------------*/
@@ -196,6 +209,6 @@ void teseo_uart_rx_onoff(TESEO_LIV3F_ctx_t *pCtx, uint8_t enable)
   Teseo_UART_Data.fsm_state = fsm_discard;
   Teseo_UART_Data.fsm_next_state = fsm_discard;
   
-  pCtx->Receive(pCtx->Handle, &Teseo_UART_Data.dummy_char, 1);
+  (void)TESEO_LIV3F_CTX_RECEIVE(pCtx, &Teseo_UART_Data.dummy_char, 1);
 }
 
@@ -194,6 +194,152 @@ int32_t GNSS1A1_GNSS_ReleaseMessage(uint32_t Instance, const GNSS1A1_GNSS_Msg_t
   return ret;
 }
 
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+int32_t GNSS1A1_GNSS_GetMessageBatch(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *pMsgs[], uint32_t Max, uint32_t *pNbr)
+{
+  int32_t ret;
+
+  if ((Instance >= GNSS1A1_GNSS_INSTANCES_NBR) || (pMsgs == NULL) || (pNbr == NULL))
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    *pNbr = TESEO_LIV3F_GetMessageBatch(&teseo_liv3f_obj, (const TESEO_LIV3F_Msg_t **)pMsgs, Max);
+    ret = BSP_ERROR_NONE;
+  }
+
+  return ret;
+}
+
+int32_t GNSS1A1_GNSS_ReleaseMessageBatch(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *pMsgs[], uint32_t Nbr)
+{
+  int32_t ret;
+
+  if ((Instance >= GNSS1A1_GNSS_INSTANCES_NBR) || (pMsgs == NULL))
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    if (TESEO_LIV3F_ReleaseMessageBatch(&teseo_liv3f_obj, (const TESEO_LIV3F_Msg_t **)pMsgs, Nbr) != TESEO_LIV3F_OK)
+    {
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+    }
+    else
+    {
+      ret = BSP_ERROR_NONE;
+    }
+  }
+
+  return ret;
+}
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+int32_t GNSS1A1_GNSS_RegisterConsumer(uint32_t Instance, uint8_t Policy, uint32_t *pId)
+{
+  int32_t ret;
+
+  if ((Instance >= GNSS1A1_GNSS_INSTANCES_NBR) || (pId == NULL))
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    if (TESEO_LIV3F_RegisterConsumer(&teseo_liv3f_obj, Policy, pId) != TESEO_LIV3F_OK)
+    {
+      ret = BSP_ERROR_BUSY;
+    }
+    else
+    {
+      ret = BSP_ERROR_NONE;
+    }
+  }
+
+  return ret;
+}
+
+int32_t GNSS1A1_GNSS_UnregisterConsumer(uint32_t Instance, uint32_t Id)
+{
+  int32_t ret;
+
+  if (Instance >= GNSS1A1_GNSS_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    if (TESEO_LIV3F_UnregisterConsumer(&teseo_liv3f_obj, Id) != TESEO_LIV3F_OK)
+    {
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+    }
+    else
+    {
+      ret = BSP_ERROR_NONE;
+    }
+  }
+
+  return ret;
+}
+
+const GNSS1A1_GNSS_Msg_t* GNSS1A1_GNSS_GetConsumerMessage(uint32_t Instance, uint32_t Id)
+{
+  const GNSS1A1_GNSS_Msg_t *msg;
+
+  if (Instance >= GNSS1A1_GNSS_INSTANCES_NBR)
+  {
+    msg = NULL;
+  }
+  else
+  {
+    msg = (const GNSS1A1_GNSS_Msg_t *)TESEO_LIV3F_GetConsumerMessage(&teseo_liv3f_obj, Id);
+  }
+
+  return msg;
+}
+
+int32_t GNSS1A1_GNSS_ReleaseConsumerMessage(uint32_t Instance, uint32_t Id, const GNSS1A1_GNSS_Msg_t *Message)
+{
+  int32_t ret;
+
+  if (Instance >= GNSS1A1_GNSS_INSTANCES_NBR)
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    if (TESEO_LIV3F_ReleaseConsumerMessage(&teseo_liv3f_obj, Id, (const TESEO_LIV3F_Msg_t *)Message) != TESEO_LIV3F_OK)
+    {
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+    }
+    else
+    {
+      ret = BSP_ERROR_NONE;
+    }
+  }
+
+  return ret;
+}
+
+int32_t GNSS1A1_GNSS_GetConsumerOverruns(uint32_t Instance, uint32_t Id, uint32_t *pOverruns)
+{
+  int32_t ret;
+
+  if ((Instance >= GNSS1A1_GNSS_INSTANCES_NBR) || (pOverruns == NULL))
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    *pOverruns = TESEO_LIV3F_GetConsumerOverruns(&teseo_liv3f_obj, Id);
+    ret = BSP_ERROR_NONE;
+  }
+
+  return ret;
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 int32_t GNSS1A1_GNSS_Send(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *Message)
 {
   int32_t ret;
@@ -263,6 +409,37 @@ int32_t GNSS1A1_GNSS_Reset(uint32_t Instance)
   return ret;
 }
 
+#if (CONFIG_USE_RX_STATS == 1)
+int32_t GNSS1A1_GNSS_GetStats(uint32_t Instance, GNSS1A1_GNSS_Stats_t *pStats)
+{
+  int32_t ret;
+  TESEO_LIV3F_Stats_t stats;
+
+  if ((Instance >= GNSS1A1_GNSS_INSTANCES_NBR) || (pStats == NULL))
+  {
+    ret = BSP_ERROR_WRONG_PARAM;
+  }
+  else
+  {
+    if (TESEO_LIV3F_GetStats(&teseo_liv3f_obj, &stats) != TESEO_LIV3F_OK)
+    {
+      ret = BSP_ERROR_COMPONENT_FAILURE;
+    }
+    else
+    {
+      pStats->rx_msgs   = stats.rx_msgs;
+      pStats->drops     = stats.drops;
+      pStats->evictions = stats.evictions;
+      pStats->rx_errors = stats.rx_errors;
+      pStats->queue_hwm = stats.queue_hwm;
+      ret = BSP_ERROR_NONE;
+    }
+  }
+
+  return ret;
+}
+#endif /* CONFIG_USE_RX_STATS */
+
 void GNSS1A1_GNSS_BackgroundProcess(uint32_t Instance)
 {
   (void)Instance;
@@ -53,6 +53,9 @@ typedef struct
 {
   uint8_t *buf;
   uint16_t len;
+#if (CONFIG_USE_RX_LATENCY == 1)
+  uint32_t tick; /**< Tick at the end of the sentence */
+#endif /* CONFIG_USE_RX_LATENCY */
 } GNSS1A1_GNSS_Msg_t;
 
 /**
@@ -66,6 +69,20 @@ typedef struct
   uint8_t   AssistedGNSS;
 } GNSS1A1_GNSS_Capabilities_t;
 
+#if (CONFIG_USE_RX_STATS == 1)
+/**
+ * @brief GNSS receive path statistics
+ */
+typedef struct
+{
+  uint32_t rx_msgs;     /**< Sentences completed and queued */
+  uint32_t drops;       /**< Sentences dropped, no free buffer in the queue */
+  uint32_t evictions;   /**< Sentences dropped by priority, queue full */
+  uint32_t rx_errors;   /**< Bus errors (UART overruns, I2C errors) */
+  uint32_t queue_hwm;   /**< Highest number of queue buffers in use at once */
+} GNSS1A1_GNSS_Stats_t;
+#endif /* CONFIG_USE_RX_STATS */
+
 /**
  * @}
  */
@@ -127,6 +144,72 @@ const   GNSS1A1_GNSS_Msg_t* GNSS1A1_GNSS_GetMessage(uint32_t Instance);
  */
 int32_t GNSS1A1_GNSS_ReleaseMessage(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *Message);
 
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+/**
+ * @brief  Get all the messages currently received from GNSS, in arrival order
+ * @param  Instance GNSS instance
+ * @param  pMsgs The array filled with the message buffers
+ * @param  Max The size of the array
+ * @param  pNbr The number of message buffers returned
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_GetMessageBatch(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *pMsgs[], uint32_t Max, uint32_t *pNbr);
+
+/**
+ * @brief  Release the NMEA message buffers got by GNSS1A1_GNSS_GetMessageBatch
+ * @param  Instance GNSS instance
+ * @param  pMsgs The message buffers
+ * @param  Nbr The number of message buffers
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_ReleaseMessageBatch(uint32_t Instance, const GNSS1A1_GNSS_Msg_t *pMsgs[], uint32_t Nbr);
+#endif /* CONFIG_USE_QUEUE_BATCH */
+
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/**
+ * @brief  Register a new reader of the messages from GNSS, with its own read cursor
+ * @param  Instance GNSS instance
+ * @param  Policy TESEO_QUEUE_CONSUMER_LAG or TESEO_QUEUE_CONSUMER_OVERRUN
+ * @param  pId The consumer id
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_RegisterConsumer(uint32_t Instance, uint8_t Policy, uint32_t *pId);
+
+/**
+ * @brief  Unregister a reader of the messages from GNSS
+ * @param  Instance GNSS instance
+ * @param  Id The consumer id
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_UnregisterConsumer(uint32_t Instance, uint32_t Id);
+
+/**
+ * @brief  Get the buffer containing the next message from GNSS for a consumer
+ * @param  Instance GNSS instance
+ * @param  Id The consumer id
+ * @retval The message buffer, NULL if the consumer is not registered
+ */
+const   GNSS1A1_GNSS_Msg_t* GNSS1A1_GNSS_GetConsumerMessage(uint32_t Instance, uint32_t Id);
+
+/**
+ * @brief  Release the NMEA message buffer read by a consumer
+ * @param  Instance GNSS instance
+ * @param  Id The consumer id
+ * @param  Message The message buffer
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_ReleaseConsumerMessage(uint32_t Instance, uint32_t Id, const GNSS1A1_GNSS_Msg_t *Message);
+
+/**
+ * @brief  Get the number of messages a consumer missed
+ * @param  Instance GNSS instance
+ * @param  Id The consumer id
+ * @param  pOverruns The number of overruns
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_GetConsumerOverruns(uint32_t Instance, uint32_t Id, uint32_t *pOverruns);
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /**
  * @brief  Send a command to the GNSS
  * @param  Instance GNSS instance
@@ -151,6 +234,16 @@ int32_t GNSS1A1_GNSS_Wakeup_Status(uint32_t Instance, uint8_t *status);
  */
 int32_t GNSS1A1_GNSS_Reset(uint32_t Instance);
 
+#if (CONFIG_USE_RX_STATS == 1)
+/**
+ * @brief  Get the receive path statistics
+ * @param  Instance GNSS instance
+ * @param  pStats The statistics snapshot
+ * @retval BSP status
+ */
+int32_t GNSS1A1_GNSS_GetStats(uint32_t Instance, GNSS1A1_GNSS_Stats_t *pStats);
+#endif /* CONFIG_USE_RX_STATS */
+
 /**
  * @}
  */
@@ -0,0 +1,289 @@
+/**
+  ******************************************************************************
+  * @file    gnss_console.c
+  * @author  SRA
+  * @brief   Console output queued in a byte ring drained by the UART TX DMA.
+  *
+  *          Each TX complete interrupt hands the next contiguous block of the
+  *          ring to the DMA. When the ring is full, CONSOLE_TX_OVERFLOW_POLICY
+  *          selects whether the oldest output not yet handed to the DMA is
+  *          discarded (CONSOLE_TX_DROP_OLDEST) or the writer waits for room
+  *          (CONSOLE_TX_BLOCK).
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+
+#include "gnss_console.h"
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+
+#if (CONSOLE_TX_WAIT_OS == 1)
+#include "cmsis_os.h"
+#endif /* CONSOLE_TX_WAIT_OS */
+
+/* Global variables ----------------------------------------------------------*/
+/* DMA channel draining the console TX ring */
+DMA_HandleTypeDef hdma_usart2_tx;
+
+/* Private variables ---------------------------------------------------------*/
+static UART_HandleTypeDef *consoleTxUart;
+
+/* Console TX ring: [Rd, Rd + DmaLen) is owned by the DMA, [Rd + DmaLen, Wr) is pending */
+static uint8_t consoleTxBuf[CONSOLE_TX_BUF_SIZE];
+static volatile uint32_t consoleTxRd = 0;
+static volatile uint32_t consoleTxWr = 0;
+static volatile uint32_t consoleTxDmaLen = 0;
+#if (CONSOLE_TX_OVERFLOW_POLICY == CONSOLE_TX_DROP_OLDEST)
+static volatile uint32_t consoleTxDropped = 0;
+#endif /* CONSOLE_TX_OVERFLOW_POLICY */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Console_TxKick(void);
+static void Console_TxWait(void);
+#if (CONSOLE_TX_OVERFLOW_POLICY == CONSOLE_TX_DROP_OLDEST)
+static void Console_TxDropOldest(uint32_t nbr);
+#endif /* CONSOLE_TX_OVERFLOW_POLICY */
+static void Console_TxCpltCallback(UART_HandleTypeDef *huart);
+
+/* Private functions ---------------------------------------------------------*/
+
+/*
+ * Hand the oldest contiguous block of pending data to the DMA, if it is idle.
+ * Must be called with interrupts disabled or from the TX complete callback.
+ */
+static void Console_TxKick(void)
+{
+  uint32_t len;
+
+  if ((consoleTxDmaLen == 0U) && (consoleTxRd != consoleTxWr))
+  {
+    len = (consoleTxWr > consoleTxRd) ? (consoleTxWr - consoleTxRd) : (CONSOLE_TX_BUF_SIZE - consoleTxRd);
+    if (len > 0xFFFFU)
+    {
+      len = 0xFFFFU;
+    }
+    if (HAL_UART_Transmit_DMA(consoleTxUart, &consoleTxBuf[consoleTxRd], (uint16_t)len) == HAL_OK)
+    {
+      consoleTxDmaLen = len;
+    }
+  }
+}
+
+/*
+ * Let the DMA make progress: sleep for a tick when the scheduler is running,
+ * spin otherwise (e.g. messages printed before osKernelStart).
+ */
+static void Console_TxWait(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  /* Restart the transfer in case a previous attempt found the UART busy */
+  __disable_irq();
+  Console_TxKick();
+  __set_PRIMASK(primask);
+
+#if (CONSOLE_TX_WAIT_OS == 1)
+#if (osCMSIS < 0x20000U)
+  if (osKernelRunning() != 0)
+#else
+  if (osKernelGetState() == osKernelRunning)
+#endif /* osCMSIS */
+  {
+    (void)osDelay(1);
+  }
+#endif /* CONSOLE_TX_WAIT_OS */
+}
+
+#if (CONSOLE_TX_OVERFLOW_POLICY == CONSOLE_TX_DROP_OLDEST)
+/*
+ * Drop the nbr oldest pending bytes (those not yet handed to the DMA),
+ * sliding the newer ones down so that the free room stays contiguous.
+ * Must be called with interrupts disabled.
+ */
+static void Console_TxDropOldest(uint32_t nbr)
+{
+  uint32_t dst = (consoleTxRd + consoleTxDmaLen) % CONSOLE_TX_BUF_SIZE;
+  uint32_t pending = (consoleTxWr + CONSOLE_TX_BUF_SIZE - dst) % CONSOLE_TX_BUF_SIZE;
+  uint32_t src;
+  uint32_t i;
+
+  if (nbr > pending)
+  {
+    nbr = pending;
+  }
+  src = (dst + nbr) % CONSOLE_TX_BUF_SIZE;
+  for (i = nbr; i < pending; i++)
+  {
+    consoleTxBuf[dst] = consoleTxBuf[src];
+    dst = (dst + 1U) % CONSOLE_TX_BUF_SIZE;
+    src = (src + 1U) % CONSOLE_TX_BUF_SIZE;
+  }
+  consoleTxWr = dst;
+  consoleTxDropped += nbr;
+}
+#endif /* CONSOLE_TX_OVERFLOW_POLICY */
+
+/*
+ * Console UART TX complete: release the block sent by the DMA and start the next one.
+ */
+static void Console_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  if (huart == consoleTxUart)
+  {
+    consoleTxRd = (consoleTxRd + consoleTxDmaLen) % CONSOLE_TX_BUF_SIZE;
+    consoleTxDmaLen = 0;
+    Console_TxKick();
+  }
+}
+
+/* Functions Definition ------------------------------------------------------*/
+
+int32_t GNSS_CONSOLE_TxInit(UART_HandleTypeDef *huart)
+{
+  consoleTxUart = huart;
+
+  __HAL_RCC_DMA1_CLK_ENABLE();
+
+  hdma_usart2_tx.Instance = CONSOLE_TX_DMA_INSTANCE;
+  hdma_usart2_tx.Init.Request = CONSOLE_TX_DMA_REQUEST;
+  hdma_usart2_tx.Init.Direction = DMA_MEMORY_TO_PERIPH;
+  hdma_usart2_tx.Init.PeriphInc = DMA_PINC_DISABLE;
+  hdma_usart2_tx.Init.MemInc = DMA_MINC_ENABLE;
+  hdma_usart2_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+  hdma_usart2_tx.Init.MemDataAlignment = DMA_MDATAALIGN_BYTE;
+  hdma_usart2_tx.Init.Mode = DMA_NORMAL;
+  hdma_usart2_tx.Init.Priority = DMA_PRIORITY_LOW;
+  if (HAL_DMA_Init(&hdma_usart2_tx) != HAL_OK)
+  {
+    return -1;
+  }
+  __HAL_LINKDMA(huart, hdmatx, hdma_usart2_tx);
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  if ((HAL_UART_RegisterCallback(huart, HAL_UART_TX_COMPLETE_CB_ID, Console_TxCpltCallback) != HAL_OK) ||
+      (HAL_UART_RegisterCallback(huart, HAL_UART_ERROR_CB_ID, GNSS_CONSOLE_TxErrorCallback) != HAL_OK))
+  {
+    return -1;
+  }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+  HAL_NVIC_SetPriority(CONSOLE_TX_DMA_IRQn, CONSOLE_TX_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(CONSOLE_TX_DMA_IRQn);
+  HAL_NVIC_SetPriority(CONSOLE_UART_IRQn, CONSOLE_TX_IRQ_PRIO, 0);
+  HAL_NVIC_EnableIRQ(CONSOLE_UART_IRQn);
+
+  return 0;
+}
+
+void GNSS_CONSOLE_TxWrite(const uint8_t *pData, uint32_t len)
+{
+  uint32_t primask;
+  uint32_t room;
+  uint32_t chunk;
+  uint32_t wr;
+
+  while (len > 0U)
+  {
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    /* One slot is kept empty to tell a full ring from an empty one */
+    room = CONSOLE_TX_BUF_SIZE - 1U - ((consoleTxWr + CONSOLE_TX_BUF_SIZE - consoleTxRd) % CONSOLE_TX_BUF_SIZE);
+#if (CONSOLE_TX_OVERFLOW_POLICY == CONSOLE_TX_DROP_OLDEST)
+    if (room < len)
+    {
+      Console_TxDropOldest(len - room);
+      room = CONSOLE_TX_BUF_SIZE - 1U - ((consoleTxWr + CONSOLE_TX_BUF_SIZE - consoleTxRd) % CONSOLE_TX_BUF_SIZE);
+      if (room < len)
+      {
+        /* Even the whole ring is not enough: keep the newest part of the message */
+        consoleTxDropped += len - room;
+        pData += len - room;
+        len = room;
+      }
+    }
+#endif /* CONSOLE_TX_OVERFLOW_POLICY */
+
+    chunk = (len < room) ? len : room;
+    wr = consoleTxWr;
+    if ((wr + chunk) > CONSOLE_TX_BUF_SIZE)
+    {
+      (void)memcpy(&consoleTxBuf[wr], pData, CONSOLE_TX_BUF_SIZE - wr);
+      (void)memcpy(consoleTxBuf, &pData[CONSOLE_TX_BUF_SIZE - wr], chunk - (CONSOLE_TX_BUF_SIZE - wr));
+    }
+    else
+    {
+      (void)memcpy(&consoleTxBuf[wr], pData, chunk);
+    }
+    consoleTxWr = (wr + chunk) % CONSOLE_TX_BUF_SIZE;
+    pData += chunk;
+    len -= chunk;
+
+    Console_TxKick();
+    __set_PRIMASK(primask);
+
+    if (len > 0U)
+    {
+      if ((__get_IPSR() != 0U) || (primask != 0U))
+      {
+        break;
+      }
+      /* CONSOLE_TX_BLOCK: wait for the DMA to free some room */
+      Console_TxWait();
+    }
+  }
+}
+
+uint8_t GNSS_CONSOLE_TxFlush(uint32_t timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (consoleTxRd != consoleTxWr)
+  {
+    /* The DMA cannot make progress from an interrupt or with interrupts masked */
+    if (((HAL_GetTick() - tickstart) >= timeout) || (__get_IPSR() != 0U) || (__get_PRIMASK() != 0U))
+    {
+      return 1;
+    }
+    Console_TxWait();
+  }
+
+  return 0;
+}
+
+void GNSS_CONSOLE_TxErrorCallback(UART_HandleTypeDef *huart)
+{
+  /* The HAL has stopped the DMA transfer in error: give up the block in
+   * flight and go on with the rest of the ring
+   */
+  if ((huart == consoleTxUart) && ((huart->ErrorCode & HAL_UART_ERROR_DMA) != 0U) &&
+      (huart->gState == HAL_UART_STATE_READY))
+  {
+    Console_TxCpltCallback(huart);
+  }
+}
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 0)
+/**
+  * @brief  Tx Transfer completed callback
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+  Console_TxCpltCallback(huart);
+}
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
@@ -0,0 +1,125 @@
+/**
+  ******************************************************************************
+  * @file    gnss_console.h
+  * @author  SRA
+  * @brief   Header file for gnss_console.c
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef GNSS_CONSOLE_H
+#define GNSS_CONSOLE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "gnss1a1_conf.h"
+#include "teseo_liv3f_conf.h"
+
+/** @addtogroup DRIVERS
+  * @{
+  */
+
+/** @addtogroup BSP
+ * @{
+ */
+
+/** @addtogroup X_NUCLEO_GNSS1A1
+  * @{
+  */
+
+/** @addtogroup GNSS1A1Driver_EXPORTED_DEFINES
+ * @{
+ */
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+/* DMA channel serving the console UART TX (USART2 on the Nucleo boards) */
+#ifndef CONSOLE_TX_DMA_INSTANCE
+#define CONSOLE_TX_DMA_INSTANCE DMA1_Channel7
+#define CONSOLE_TX_DMA_REQUEST  DMA_REQUEST_2
+#define CONSOLE_TX_DMA_IRQn     DMA1_Channel7_IRQn
+#define CONSOLE_UART_IRQn       USART2_IRQn
+#endif /* CONSOLE_TX_DMA_INSTANCE */
+
+/* Interrupt priority of the DMA channel and of the console UART */
+#ifndef CONSOLE_TX_IRQ_PRIO
+#define CONSOLE_TX_IRQ_PRIO     5U
+#endif /* CONSOLE_TX_IRQ_PRIO */
+
+/* 1 to sleep a CMSIS-RTOS tick while waiting for room, 0 to spin (no RTOS) */
+#ifndef CONSOLE_TX_WAIT_OS
+#define CONSOLE_TX_WAIT_OS      1
+#endif /* CONSOLE_TX_WAIT_OS */
+
+/* DMA handle, for the DMA channel IRQ handler */
+extern DMA_HandleTypeDef hdma_usart2_tx;
+
+/**
+ * @brief  Configure the TX DMA of the console UART and the related interrupts.
+ *         With USE_HAL_UART_REGISTER_CALLBACKS set, the TX complete and error
+ *         callbacks of the UART are registered. Otherwise HAL_UART_TxCpltCallback()
+ *         is defined here, and the HAL_UART_ErrorCallback() of the application
+ *         has to call GNSS_CONSOLE_TxErrorCallback().
+ * @param  huart The console UART
+ * @retval 0 on success, -1 otherwise
+ */
+int32_t GNSS_CONSOLE_TxInit(UART_HandleTypeDef *huart);
+
+/**
+ * @brief  Queue data in the console TX ring and start the DMA if it is idle.
+ *         When the ring is full, the CONSOLE_TX_OVERFLOW_POLICY applies, except in
+ *         interrupt context or with interrupts masked where what does not fit is dropped.
+ * @param  pData The data to be sent
+ * @param  len The length of the data
+ * @retval None
+ */
+void GNSS_CONSOLE_TxWrite(const uint8_t *pData, uint32_t len);
+
+/**
+ * @brief  Wait until all the queued console output has been sent.
+ * @param  timeout Timeout in ms
+ * @retval 0 on success, 1 if the ring is not empty after timeout
+ */
+uint8_t GNSS_CONSOLE_TxFlush(uint32_t timeout);
+
+/**
+ * @brief  Console UART error: release the block of a failed TX DMA transfer.
+ * @param  huart UART handle
+ * @retval None
+ */
+void GNSS_CONSOLE_TxErrorCallback(UART_HandleTypeDef *huart);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNSS_CONSOLE_H */
@@ -18,6 +18,7 @@
 /* Includes ------------------------------------------------------------------*/
 
 #include <string.h>
+#include <stddef.h>
 
 #ifdef USE_STM32F4XX_NUCLEO
 #include "stm32f4xx_hal.h"
@@ -88,6 +89,8 @@ void PrintTime(char* direction, uint32_t time0, uint32_t time1);
 #define UART_READ_READY_ACK_TIMEOUT  (8000)
 #define UART_READ_CHUNK_ACK_TIMEOUT  (3500)
 #define UART_READ_CRC_ACK_TIMEOUT    (10000)
+#define UART_READ_SYNC_TIMEOUT       (10)
+#define UART_READ_FLASHER_READY_TIMEOUT (600)
 
 #define ACK  0xCC
 #define NACK 0xDD
@@ -100,10 +103,114 @@ void PrintTime(char* direction, uint32_t time0, uint32_t time1);
 #define UART_HEADER_SZ        2
 #define UART_FWUPG_CTRL_SZ    5
 #define UART_FWUPG_SYNC_SZ    26
-#define RXBUFFER_SZ           16*1024
+#define RXBUFFER_SZ           (16*1024 + CHUNK_IDX_SZ + CHUNK_CRC_SZ)
 #define VER_BUF_SZ            32
 #define EXIT_LOOP             48 //ASCII 0
 
+/**
+ * Pipelined relay of the FW chunks: chunk N+1 is received from the host by DMA while chunk N
+ * is written to the Teseo by DMA, each in one half of rxBuffer. The ACK returned to the host
+ * for chunk N+1 is the Teseo ACK of chunk N, the last one is checked before the CRC ACK.
+ * It needs twice the RAM for rxBuffer (about 32 KB) and a DMA channel on both UARTs: before
+ * FWUpgrade() is called, the application links an RX DMA handle to io_huart and a TX DMA
+ * handle to huart (__HAL_LINKDMA(&io_huart, hdmarx, ...) and __HAL_LINKDMA(&huart, hdmatx, ...),
+ * usually in HAL_UART_MspInit()) and enables the IRQs of both DMA channels and of both UARTs.
+ */
+#ifndef FWUPG_PIPELINED_RELAY
+#define FWUPG_PIPELINED_RELAY 0
+#endif /* FWUPG_PIPELINED_RELAY */
+
+/**
+ * Resumable upgrade: after the "CRC32" control command each chunk is framed as
+ * [index (4 bytes LE)][chunk][CRC32 of index and chunk (4 bytes LE)] and checked before
+ * being relayed to the Teseo. A corrupted or truncated chunk is NACKed and sent again by
+ * the host, a chunk already relayed is ACKed and dropped. After a glitch on the host link
+ * the "RESUM" control command returns the index of the next expected chunk (4 bytes LE),
+ * or FWUPG_RESUME_NONE if the Teseo is not in the flasher any longer.
+ * Once the Teseo has NACKed a chunk every chunk is NACKed: after a few retries the host
+ * sends "RESUM" and restarts from the sync when it gets FWUPG_RESUME_NONE.
+ * The Flash Updater Tool uses the plain chunks, which stay supported.
+ */
+#ifndef FWUPG_RESUMABLE
+#define FWUPG_RESUMABLE       1
+#endif /* FWUPG_RESUMABLE */
+
+#if (FWUPG_RESUMABLE == 1)
+#define CHUNK_IDX_SZ          4
+#define CHUNK_CRC_SZ          4
+#define FWUPG_RESUME_NONE     0xFFFFFFFFU
+#else
+#define CHUNK_IDX_SZ          0
+#define CHUNK_CRC_SZ          0
+#endif /* FWUPG_RESUMABLE */
+
+/**
+ * Staged upgrade: after the "STAGE" control command the image is not relayed but stored
+ * in a spare region of the MCU flash, the FWUPG_SYNC frame included. At the EOF the image
+ * is read back and checked against the CRC32 of the received chunks, then the Teseo is
+ * flashed from the MCU flash at FWUPG_STAGE_BAUD_RATE: the host link speed does not affect
+ * the programming time any longer. FWUpgrade_Staged() flashes again the stored image
+ * without any host.
+ * The region (FWUPG_STAGE_ADDR, FWUPG_STAGE_SIZE) must be outside the linker ROM regions
+ * of all the toolchains, in one flash bank (L4) or made of whole sectors (F4).
+ */
+#ifndef FWUPG_STAGED
+#define FWUPG_STAGED          0
+#endif /* FWUPG_STAGED */
+
+#if (FWUPG_STAGED == 1)
+#if !defined(FWUPG_STAGE_ADDR) || !defined(FWUPG_STAGE_SIZE)
+#error "FWUPG_STAGED needs FWUPG_STAGE_ADDR and FWUPG_STAGE_SIZE"
+#endif
+#if defined(USE_STM32F4XX_NUCLEO) && (!defined(FWUPG_STAGE_SECTOR) || !defined(FWUPG_STAGE_SECTOR_NBR))
+#error "FWUPG_STAGED needs FWUPG_STAGE_SECTOR and FWUPG_STAGE_SECTOR_NBR"
+#endif
+#if defined(USE_STM32L0XX_NUCLEO)
+#error "FWUPG_STAGED is not supported on STM32L0"
+#endif
+
+#ifndef FWUPG_STAGE_BAUD_RATE
+#define FWUPG_STAGE_BAUD_RATE FAST_UART_BAUD_RATE /* must be accepted by the Teseo bootloader */
+#endif /* FWUPG_STAGE_BAUD_RATE */
+
+#define STAGE_MAGIC           0x53544731U /* "STG1" */
+#define STAGE_HDR_SZ          64U
+#define STAGE_DATA_ADDR       (FWUPG_STAGE_ADDR + STAGE_HDR_SZ)
+#define STAGE_DATA_SZ         (FWUPG_STAGE_SIZE - STAGE_HDR_SZ)
+#if defined(USE_STM32L4XX_NUCLEO)
+#define STAGE_PROG_SZ         8U
+#define STAGE_PROG_TYPE       FLASH_TYPEPROGRAM_DOUBLEWORD
+#define STAGE_FLASH_ERRORS    FLASH_FLAG_ALL_ERRORS
+#else
+#define STAGE_PROG_SZ         4U
+#define STAGE_PROG_TYPE       FLASH_TYPEPROGRAM_WORD
+#define STAGE_FLASH_ERRORS    (FLASH_FLAG_OPERR | FLASH_FLAG_WRPERR | FLASH_FLAG_PGAERR | FLASH_FLAG_PGPERR | FLASH_FLAG_PGSERR)
+#endif
+#endif /* FWUPG_STAGED */
+
+#if (FWUPG_PIPELINED_RELAY == 1)
+#define RXBUFFER_NBR          2
+#if (defined(SRAM_SIZE_MAX) && ((RXBUFFER_NBR * RXBUFFER_SZ) >= SRAM_SIZE_MAX)) || \
+    (defined(SRAM1_SIZE_MAX) && ((RXBUFFER_NBR * RXBUFFER_SZ) >= SRAM1_SIZE_MAX))
+#error "FWUPG_PIPELINED_RELAY: the two chunk buffers do not fit in the RAM of this MCU"
+#endif
+#else
+#define RXBUFFER_NBR          1
+#endif /* FWUPG_PIPELINED_RELAY */
+
+#if (FWUPG_STAGED == 1)
+/* Header of the staged image, programmed at FWUPG_STAGE_ADDR once the image is checked */
+typedef struct {
+  uint32_t magic;
+  uint32_t image_len;
+  uint32_t chunk_sz;                   /* size of the chunks sent to the Teseo */
+  uint32_t image_crc;                  /* CRC32 of the image */
+  uint8_t  sync[32];                   /* FWUPG_SYNC frame */
+  uint32_t hdr_crc;                    /* CRC32 of the previous fields */
+  uint32_t reserved[3];
+} Stage_Header_t;
+#endif /* FWUPG_STAGED */
+
 /* Global variables ----------------------------------------------------------*/
 
 extern UART_HandleTypeDef huart;
@@ -113,10 +220,45 @@ extern UART_HandleTypeDef io_huart;
 
 /* Buffers used for reception and transmission */
 static uint8_t syncBuffer[UART_FWUPG_SYNC_SZ];
-static uint8_t rxBuffer[RXBUFFER_SZ];
+static uint8_t rxBuffer[RXBUFFER_NBR * RXBUFFER_SZ];
 static char    ver_buf[VER_BUF_SZ];
 static int already_flashed = 0;
 
+#if (FWUPG_PIPELINED_RELAY == 1)
+/* Chunk being written to the Teseo and its ACK */
+static volatile uint8_t relayAck;
+static uint8_t relayPending = 0;
+static uint32_t relayStart;
+#endif /* FWUPG_PIPELINED_RELAY */
+
+#if (FWUPG_RESUMABLE == 1)
+/**
+ * Upgrade session, kept across the host link glitches as long as the Teseo stays in the
+ * flasher (i.e. until the next sync, CLOSE or MCU reset).
+ */
+static uint8_t  chunkCrc = 0;  /* chunks framed with index and CRC32 */
+static uint8_t  chunkFailed;   /* the Teseo NACKed a chunk, the session is lost */
+static uint32_t chunkNext;     /* index of the next chunk expected from the host */
+#endif /* FWUPG_RESUMABLE */
+
+#if (FWUPG_STAGED == 1)
+/* Image being stored in the MCU flash */
+static uint8_t  staging = 0;
+static uint32_t stageLen;
+static uint32_t stageChunkSz;
+static uint32_t stageCrc;
+static Stage_Header_t stageHdr;
+#endif /* FWUPG_STAGED */
+
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && (USE_HAL_UART_REGISTER_CALLBACKS == 1U)
+/**
+ * The answers of the Teseo are received by IT: the RX complete and RX event (idle line)
+ * callbacks wake up the upgrading thread, otherwise the end of the reception is polled.
+ */
+#define TESEO_RX_SIGNAL 0x01U
+static osThreadId teseoRxThread;
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
 /* Global function prototypes -----------------------------------------------*/
 extern GNSS_StatusTypeDef GNSS_UART_Init(uint32_t BaudRate);
 extern GNSS_StatusTypeDef GNSS_UART_DeInit(void);
@@ -124,8 +266,37 @@ extern void Error_Handler(void);
 
 /* Private function prototypes -----------------------------------------------*/
 static void Handle_Upgrading_Process(int *win_is_open);
+static uint8_t Teseo_Flasher_Start(uint8_t *buffer, int *synced);
+static void Teseo_Rx_Register(void);
+static void Teseo_Rx_Start(uint8_t *buf, uint16_t len);
+static void Teseo_Rx_StartToIdle(uint8_t *buf, uint16_t len);
+static void Teseo_Rx_Sleep(uint32_t timeout);
+static HAL_StatusTypeDef Teseo_Rx_Wait(uint32_t deadline);
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && (USE_HAL_UART_REGISTER_CALLBACKS == 1U)
+static void Teseo_RxCplt(UART_HandleTypeDef *h);
+static void Teseo_RxEvent(UART_HandleTypeDef *h, uint16_t size);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
 static char* Get_GNSS_FW_Version(void);
 static char* TESEO_Detect_Sentence(const char *rsp, uint8_t *buf, uint32_t len);
+#if (FWUPG_PIPELINED_RELAY == 1)
+static HAL_StatusTypeDef Relay_Receive(uint8_t *buf, uint16_t len, uint32_t timeout);
+static void Relay_Start(uint8_t *buf, uint16_t len);
+static uint8_t Relay_Complete(void);
+#endif /* FWUPG_PIPELINED_RELAY */
+#if (FWUPG_RESUMABLE == 1) || (FWUPG_STAGED == 1)
+static uint32_t Crc32_Update(uint32_t crc, const uint8_t *buf, uint32_t len);
+static void Host_Reply(uint8_t *buf, uint16_t len);
+#endif /* FWUPG_RESUMABLE || FWUPG_STAGED */
+#if (FWUPG_RESUMABLE == 1)
+static uint32_t Chunk_Get32(const uint8_t *buf);
+#endif /* FWUPG_RESUMABLE */
+#if (FWUPG_STAGED == 1)
+static uint8_t Stage_Begin(const uint8_t *sync);
+static uint8_t Stage_Write(const uint8_t *buf, uint16_t len);
+static uint8_t Stage_Commit(void);
+static uint8_t Stage_Flash(void);
+static HAL_StatusTypeDef Stage_Program(uint32_t addr, const uint8_t *buf, uint32_t len);
+#endif /* FWUPG_STAGED */
 
 /* Exported function ---------------------------------------------------------*/
 void FWUpgrade(void)
@@ -141,6 +312,14 @@ void FWUpgrade(void)
   GNSS_Reset();
   GNSS_UART_Init(DEFAULT_UART_BAUD_RATE);
 
+#if (FWUPG_PIPELINED_RELAY == 1)
+  /* the DMA channels of the relay are set up by the application (HAL_UART_MspInit) */
+  if ((io_huart.hdmarx == NULL) || (huart.hdmatx == NULL)) {
+    PRINTMSG("FWUPG_PIPELINED_RELAY needs the DMA of both UARTs!!!");
+    Error_Handler();
+  }
+#endif /* FWUPG_PIPELINED_RELAY */
+
   /* Get current FW version */
   (void)memset(ver_buf, 0, VER_BUF_SZ);
   ver = Get_GNSS_FW_Version();
@@ -223,20 +402,30 @@ void FWUpgrade(void)
  */
 static void Handle_Upgrading_Process(int *win_is_open)
 {
-  int ready;
   int synced = 0; /* became 1 after getting the sync answer from the Teseo */ 
   uint32_t timeout;
   uint8_t ack;
   uint8_t* buffer;
-  uint8_t rsp[] = {0x00, 0x00, 0x00, 0x00}; /* array for the FWUPG_SYNC answer (0x83984073U) */
-  uint8_t rsp_len = (uint8_t)sizeof(rsp);
-  uint8_t offset;
-  int trials;
   const char* fwupg_close = "CLOSE";
   char* ver;
   uint16_t len = UART_FWUPG_SYNC_SZ;
   HAL_StatusTypeDef status = HAL_OK;
-  int max_trials = 10;
+  uint8_t* chunk;
+  uint16_t chunk_len;
+#if (FWUPG_RESUMABLE == 1)
+  uint32_t idx;
+  uint8_t resume[CHUNK_IDX_SZ];
+  const char* fwupg_crc = "CRC32";
+  const char* fwupg_resume = "RESUM";
+#endif /* FWUPG_RESUMABLE */
+#if (FWUPG_STAGED == 1)
+  const char* fwupg_stage = "STAGE";
+#endif /* FWUPG_STAGED */
+#if (FWUPG_PIPELINED_RELAY == 1)
+  uint32_t half = 0; /* half of rxBuffer receiving the next chunk */
+
+  relayPending = 0;
+#endif /* FWUPG_PIPELINED_RELAY */
   
   /**
    * Wait for the NMEA commands coming from the java Flash Updater Tool and 
@@ -244,8 +433,16 @@ static void Handle_Upgrading_Process(int *win_is_open)
    */
   for ( ; ; ) {
     
+#if (FWUPG_STAGED == 1)
+    if ((synced == 1) || (staging == 2U)) {
+#else
     if (synced == 1) {
+#endif /* FWUPG_STAGED */
+#if (FWUPG_PIPELINED_RELAY == 1)
+      buffer = &rxBuffer[half * RXBUFFER_SZ];
+#else
       buffer = rxBuffer;
+#endif /* FWUPG_PIPELINED_RELAY */
       timeout = UART_READ_LONG_TIMEOUT;
     }
     else {
@@ -262,135 +459,95 @@ static void Handle_Upgrading_Process(int *win_is_open)
     }
     if (status == HAL_OK) {
       already_flashed = 0;
+#if (FWUPG_PIPELINED_RELAY == 1)
+      /* the previous chunk, if any, is meanwhile written to the Teseo */
+      status = (synced == 1) ? Relay_Receive(buffer, len, timeout) : HAL_UART_Receive(&io_huart, buffer, len, timeout);
+#else
       status = HAL_UART_Receive(&io_huart, buffer, len, timeout);              
+#endif /* FWUPG_PIPELINED_RELAY */
       if (status != HAL_OK && status != HAL_TIMEOUT) {
         Error_Handler();
       }
       /* COM port closed */
       if (len == (uint16_t)UART_FWUPG_CTRL_SZ) {
         if (strncmp((char *)(buffer), fwupg_close, UART_FWUPG_CTRL_SZ) == 0){
+#if (FWUPG_PIPELINED_RELAY == 1)
+          if (relayPending == 1U) {
+            (void)Relay_Complete();
+          }
+#endif /* FWUPG_PIPELINED_RELAY */
           *win_is_open = 0;
+#if (FWUPG_RESUMABLE == 1)
+          chunkCrc = 0;
+#endif /* FWUPG_RESUMABLE */
+#if (FWUPG_STAGED == 1)
+          staging = 0;
+#endif /* FWUPG_STAGED */
           break;
         }
+#if (FWUPG_STAGED == 1)
+        /* Image to be stored in the MCU flash before flashing the Teseo */
+        else if (strncmp((char *)(buffer), fwupg_stage, UART_FWUPG_CTRL_SZ) == 0) {
+          staging = 1;
+          ack = ACK;
+          Host_Reply(&ack, 1);
+        }
+#endif /* FWUPG_STAGED */
+#if (FWUPG_RESUMABLE == 1)
+        /* Framed chunks requested by the host */
+        else if (strncmp((char *)(buffer), fwupg_crc, UART_FWUPG_CTRL_SZ) == 0) {
+          chunkCrc = 1;
+          ack = ACK;
+          Host_Reply(&ack, 1);
+        }
+        /* Host link re-opened in the middle of the upgrade */
+        else if (strncmp((char *)(buffer), fwupg_resume, UART_FWUPG_CTRL_SZ) == 0) {
+#if (FWUPG_PIPELINED_RELAY == 1)
+          if ((relayPending == 1U) && (Relay_Complete() != (uint8_t)ACK)) {
+            chunkFailed = 1;
+          }
+#endif /* FWUPG_PIPELINED_RELAY */
+#if (FWUPG_STAGED == 1)
+          idx = (((synced == 1) || (staging == 2U)) && (chunkFailed == 0U)) ? chunkNext : FWUPG_RESUME_NONE;
+#else
+          idx = ((synced == 1) && (chunkFailed == 0U)) ? chunkNext : FWUPG_RESUME_NONE;
+#endif /* FWUPG_STAGED */
+          PRINTMSG("resume from chunk %lu\n", idx);
+          resume[0] = (uint8_t)idx;
+          resume[1] = (uint8_t)(idx >> 8);
+          resume[2] = (uint8_t)(idx >> 16);
+          resume[3] = (uint8_t)(idx >> 24);
+          Host_Reply(resume, CHUNK_IDX_SZ);
+        }
+        else {
+          /* Unknown command */
+        }
+#endif /* FWUPG_RESUMABLE */
       }
       /* Start Firmware Update*/
       else if (len == (uint16_t)UART_FWUPG_SYNC_SZ) {                
         if (status == HAL_OK) {                  
           PRINTBYTES("rx_2", buffer, len);
           
-          /* Reset the Teseo and re-initialize the UART */
-          GNSS_UART_DeInit();
-          GNSS_UART_Init(FAST_UART_BAUD_RATE);
-          
-          GNSS_Reset();
-          ready = 1;
-          
-          /* Send the IDENTIFIER command */
-          trials = 0;
-          while ((ready == 1) && (synced == 0) && (trials < max_trials)) {
-            (void)memset(rsp, 0, rsp_len);                                        
-            status = HAL_UART_Transmit(&huart, buffer, IDENTIFIER_CMD_LEN, UART_WRITE_SHORT_TIMEOUT);           
-            if (status != HAL_OK) {
-              PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
-              Error_Handler();
-            }                    
-            PRINTBYTES("tx_1", buffer, IDENTIFIER_CMD_LEN);
-            /* Receive char by char */
-            for (uint8_t i=0; i<rsp_len; i++) {
-              status = HAL_UART_Receive(&huart, &(rsp[i]), 1, UART_READ_VERY_SHORT_TIMEOUT);
-              if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-                PRINTMSG("HAL_UART_1_Receive ERROR!!!");
-                Error_Handler();
-              }
-            }            
-
-            PRINTBYTES("rx_1", rsp, rsp_len);                      
-            /* Check the answer is the FWUPG_SYNC */
-            /**
-             * Unfortunately we are able to read only the first byte (0x73) out of the 
-             * four bytes (0x73, 0x40, 0x98, 0x83) indicating that the synchronization 
-             * went ok. To be investigated.
-             */
-            if (rsp[0] == (uint8_t)0x73) {
-              synced = 1;                      
-            }
-            else {
-              trials++;
-              if (trials == max_trials) {
-                PRINTMSG("Max number of trials reached!!! Not synced!!!\n");
-                ack = NACK;
-                status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_SHORT_TIMEOUT);
-                if (status != HAL_OK) {
-                  PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
-                  Error_Handler();
-                }
-              }
-            }
-          }  
-          /* Send Device Start Communication */
-          (void)memset(rsp, 0, rsp_len);
-          offset = IDENTIFIER_CMD_LEN;
-          status = HAL_UART_Transmit(&huart, &buffer[offset], START_COMMUNICATION_LEN, UART_WRITE_SHORT_TIMEOUT);
-          if (status != HAL_OK) {
-            PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
-            Error_Handler();
+#if (FWUPG_STAGED == 1)
+          if (staging != 0U) {
+            ack = Stage_Begin(buffer);
+            staging = (ack == (uint8_t)ACK) ? 2U : 0U;
           }
-          PRINTBYTES("tx_1", &buffer[offset], START_COMMUNICATION_LEN);
-          len = 0;
-          while (len == (uint16_t)0) {
-            status = HAL_UART_Receive(&huart, rsp, 1, UART_READ_VERY_SHORT_TIMEOUT);
-            if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-              PRINTMSG("HAL_UART_1_Receive ERROR!!!");
-              Error_Handler();
-            }
-            len = (uint16_t)strlen((char*)rsp);
-          }
-          PRINTBYTES("rx_1", rsp, len);
-          if (rsp[0] != (uint8_t)ACK) {
-            Error_Handler();
-          }
-          /* Send Image Info */ 
-          offset = IDENTIFIER_CMD_LEN+START_COMMUNICATION_LEN;
-          status = HAL_UART_Transmit(&huart, &buffer[offset], IMAGE_INFO_LEN, UART_WRITE_TIMEOUT);
-          if (status != HAL_OK) {
-            PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
-            Error_Handler();
-          }           
-          PRINTBYTES("tx_1", buffer+offset, IMAGE_INFO_LEN);
-          
-          /* Send Flasher Ready after Image Info */
-          (void)osDelay(100);
-          len = 0;
-          trials = 0;
-          (void)memset(rsp, 0, rsp_len);
-          offset = IDENTIFIER_CMD_LEN+START_COMMUNICATION_LEN+IMAGE_INFO_LEN;
-          while ((len == (uint16_t)0) && (trials < 50)) {
-            status = HAL_UART_Transmit(&huart, &buffer[offset], FLASHER_READY_CMD_LEN, UART_WRITE_SHORT_TIMEOUT);
-            if (status != HAL_OK) {
-              Error_Handler();
-            }
-            PRINTBYTES("tx_1", &buffer[offset], FLASHER_READY_CMD_LEN);
-            
-            /* Wait for the 1st ACK */
-            status = HAL_UART_Receive(&huart, rsp, 1, UART_READ_VERY_SHORT_TIMEOUT);
-            if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-              PRINTMSG("HAL_UART_1_Receive ERROR!!!");
-              Error_Handler();
-            }
-            len = (uint16_t)strlen((char*)rsp);
-            trials++;
-          }                    
-          /* Wait for the 2nd and the 3rd (the Erase Memory) ACK */
-          status = HAL_UART_Receive(&huart, &(rsp[1]), 2, UART_READ_READY_ACK_TIMEOUT);
-          if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-            PRINTMSG("HAL_UART_1_Receive ERROR!!!");
-            Error_Handler();
+          else
+#endif /* FWUPG_STAGED */
+          {
+            /* Reset the Teseo and re-initialize the UART */
+            GNSS_UART_DeInit();
+            GNSS_UART_Init(FAST_UART_BAUD_RATE);
+            ack = Teseo_Flasher_Start(buffer, &synced);
           }
-          len = (uint16_t)strlen((char*)rsp); 
-          PRINTBYTES("rx_1", rsp, len);
-          
+#if (FWUPG_RESUMABLE == 1)
+          chunkNext = 0;
+          chunkFailed = 0;
+#endif /* FWUPG_RESUMABLE */
+
           /* Send an ACK to the java tool indicating the Teseo is ready to be written */
-          ack = rsp[0];
           status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_TIMEOUT);
           if (status != HAL_OK) {
             Error_Handler();
@@ -403,15 +560,79 @@ static void Handle_Upgrading_Process(int *win_is_open)
         /* Write the new FW chunk */
         if ((len != (uint16_t)4) && 
             ((buffer[0] != (uint8_t)0xff) || (buffer[1] != (uint8_t)0xff) || (buffer[2] != (uint8_t)0xff) || (buffer[3] != (uint8_t)0xff))) {
-                            
-              status = HAL_UART_Transmit(&huart, buffer, len, timeout);
+              chunk = buffer;
+              chunk_len = len;
+#if (FWUPG_RESUMABLE == 1)
+              /* A truncated chunk is not relayed, the host sends it again */
+              if ((status != HAL_OK) || (chunkFailed == 1U)) {
+                PRINTMSG("chunk %lu timeout\n", chunkNext);
+                ack = NACK;
+                Host_Reply(&ack, 1);
+                continue;
+              }
+              if (chunkCrc == 1U) {
+                if ((len <= (uint16_t)(CHUNK_IDX_SZ + CHUNK_CRC_SZ)) ||
+                    (~Crc32_Update(0xFFFFFFFFU, buffer, (uint32_t)len - CHUNK_CRC_SZ) != Chunk_Get32(&buffer[len - CHUNK_CRC_SZ]))) {
+                  PRINTMSG("chunk %lu CRC error\n", chunkNext);
+                  ack = NACK;
+                  Host_Reply(&ack, 1);
+                  continue;
+                }
+                idx = Chunk_Get32(buffer);
+                if (idx != chunkNext) {
+                  /* a chunk already relayed (its ACK was lost) is dropped, a gap is refused */
+                  ack = (idx < chunkNext) ? (uint8_t)ACK : (uint8_t)NACK;
+                  Host_Reply(&ack, 1);
+                  continue;
+                }
+                chunk = &buffer[CHUNK_IDX_SZ];
+                chunk_len = len - (uint16_t)(CHUNK_IDX_SZ + CHUNK_CRC_SZ);
+              }
+              chunkNext++;
+#endif /* FWUPG_RESUMABLE */
+#if (FWUPG_STAGED == 1)
+              if (staging == 2U) {
+                ack = Stage_Write(chunk, chunk_len);
+#if (FWUPG_RESUMABLE == 1)
+                if (ack != (uint8_t)ACK) {
+                  chunkFailed = 1;
+                }
+#endif /* FWUPG_RESUMABLE */
+                Host_Reply(&ack, 1);
+                continue;
+              }
+#endif /* FWUPG_STAGED */
+#if (FWUPG_PIPELINED_RELAY == 1)
+              /* the half of the previous chunk is needed for the next one */
+              ack = (relayPending == 1U) ? Relay_Complete() : (uint8_t)ACK;
+              PRINTMSG("chunk len %d\n", chunk_len);
+              PRINTBYTES("rx_1", (uint8_t *)&ack, 1);
+#if (FWUPG_RESUMABLE == 1)
+              if (ack != (uint8_t)ACK) {
+                chunkFailed = 1;
+              }
+#endif /* FWUPG_RESUMABLE */
+
+              Relay_Start(chunk, chunk_len);
+              half ^= 1U;
+
+              /* the host sends the next chunk as soon as it gets the ACK */
+              status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_TIMEOUT);
+              if (status != HAL_OK) {
+                PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
+                Error_Handler();
+              }
+              PRINTBYTES("tx_2", &ack, 1);
+              ack = 0x00;
+#else
+              status = HAL_UART_Transmit(&huart, chunk, chunk_len, timeout);
               if (status != HAL_OK) {
                 PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
                 Error_Handler();
               }
-              PRINTMSG("chunk len %d\n", len);
-              PRINTBYTES("tx_1", buffer, 5); /* Print first 5 bytes */
-              PRINTBYTES("tx_1", buffer+len-5, 5); /* Print last 5 bytes */
+              PRINTMSG("chunk len %d\n", chunk_len);
+              PRINTBYTES("tx_1", chunk, 5); /* Print first 5 bytes */
+              PRINTBYTES("tx_1", chunk+chunk_len-5, 5); /* Print last 5 bytes */
               
               /* Receive the ACK */
               status = HAL_UART_Receive(&huart, &ack, 1, UART_READ_CHUNK_ACK_TIMEOUT);
@@ -420,6 +641,11 @@ static void Handle_Upgrading_Process(int *win_is_open)
                 Error_Handler();
               }              
               PRINTBYTES("rx_1", &ack, 1);                 
+#if (FWUPG_RESUMABLE == 1)
+              if (ack != (uint8_t)ACK) {
+                chunkFailed = 1;
+              }
+#endif /* FWUPG_RESUMABLE */
               status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_TIMEOUT);
               if (status != HAL_OK) {
                 PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
@@ -427,17 +653,46 @@ static void Handle_Upgrading_Process(int *win_is_open)
               }
               PRINTBYTES("tx_2", &ack, 1);
               ack = 0x00;                
+#endif /* FWUPG_PIPELINED_RELAY */
             }
         else {
           /* EOF reached */
-          /* Receive the CRC ACK */
-          status = HAL_UART_Receive(&huart, &ack, 1, UART_READ_CRC_ACK_TIMEOUT);
-          if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-            PRINTMSG("HAL_UART_1_Receive ERROR!!!");
-            Error_Handler();
-          }          
+#if (FWUPG_PIPELINED_RELAY == 1)
+          /* the last chunk is acknowledged before the CRC, a NACK is returned in place of the CRC ACK */
+          if (relayPending == 1U) {
+            ack = Relay_Complete();
+            if (ack != (uint8_t)ACK) {
+              PRINTBYTES("rx_1", &ack, 1);
+              status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_LONG_TIMEOUT);
+              if (status != HAL_OK) {
+                PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
+                Error_Handler();
+              }
+              PRINTBYTES("tx_2", &ack, 1);
+              break;
+            }
+          }
+#endif /* FWUPG_PIPELINED_RELAY */
+#if (FWUPG_STAGED == 1)
+          if (staging == 2U) {
+            /* Whole image checked, the Teseo is flashed from the MCU flash */
+            ack = Stage_Commit();
+            if (ack == (uint8_t)ACK) {
+              ack = Stage_Flash();
+            }
+            staging = 0;
+          }
+          else
+#endif /* FWUPG_STAGED */
+          {
+            /* Receive the CRC ACK */
+            status = HAL_UART_Receive(&huart, &ack, 1, UART_READ_CRC_ACK_TIMEOUT);
+            if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
+              PRINTMSG("HAL_UART_1_Receive ERROR!!!");
+              Error_Handler();
+            }          
+          }
           PRINTBYTES("rx_1", &ack, 1);
-          (void)osDelay(500);
           status = HAL_UART_Transmit(&io_huart, &ack, 1, UART_WRITE_LONG_TIMEOUT);
           if (status != HAL_OK) {
             PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
@@ -446,13 +701,9 @@ static void Handle_Upgrading_Process(int *win_is_open)
           PRINTBYTES("tx_2", &ack, 1);
           
           /* Reset the Teseo and transmit to the java upgrader the new fw version */
-          (void)osDelay(500);
-          
           GNSS_UART_DeInit();           
           GNSS_Reset();
           GNSS_UART_Init(DEFAULT_UART_BAUD_RATE);
-          
-          (void)osDelay(500);
 
           ver = Get_GNSS_FW_Version();
           (void)memcpy(ver_buf, ver, (uint32_t)strlen(ver));
@@ -469,25 +720,245 @@ static void Handle_Upgrading_Process(int *win_is_open)
   }
 }
 
+/*
+ * This function runs the Teseo flasher sequence (IDENTIFIER sync, Start Communication,
+ * Image Info and Flasher Ready) with the commands of a FWUPG_SYNC frame.
+ * It returns the ACK of the Teseo ready to be written, NACK if the sync failed.
+ */
+static uint8_t Teseo_Flasher_Start(uint8_t *buffer, int *synced)
+{
+  int trials;
+  int max_trials = 10;
+  uint8_t rsp[] = {0x00, 0x00, 0x00, 0x00}; /* array for the FWUPG_SYNC answer (0x83984073U) */
+  uint8_t rsp_len = (uint8_t)sizeof(rsp);
+  uint8_t offset;
+  uint16_t rx_len;
+  uint32_t deadline;
+  HAL_StatusTypeDef status;
+
+  Teseo_Rx_Register();
+  GNSS_Reset();
+
+  /* Send the IDENTIFIER command */
+  trials = 0;
+  while ((*synced == 0) && (trials < max_trials)) {
+    (void)memset(rsp, 0, rsp_len);                                        
+    Teseo_Rx_Start(rsp, rsp_len);
+    status = HAL_UART_Transmit(&huart, buffer, IDENTIFIER_CMD_LEN, UART_WRITE_SHORT_TIMEOUT);           
+    if (status != HAL_OK) {
+      PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
+      Error_Handler();
+    }                    
+    PRINTBYTES("tx_1", buffer, IDENTIFIER_CMD_LEN);
+    (void)Teseo_Rx_Wait(HAL_GetTick() + UART_READ_SYNC_TIMEOUT);
+
+    PRINTBYTES("rx_1", rsp, rsp_len);                      
+    /* Check the answer is the FWUPG_SYNC */
+    /**
+     * Unfortunately we are able to read only the first byte (0x73) out of the 
+     * four bytes (0x73, 0x40, 0x98, 0x83) indicating that the synchronization 
+     * went ok. To be investigated.
+     */
+    if (rsp[0] == (uint8_t)0x73) {
+      *synced = 1;                      
+    }
+    else {
+      trials++;
+    }
+  }
+  if (*synced == 0) {
+    PRINTMSG("Max number of trials reached!!! Not synced!!!\n");
+    return NACK;
+  }
+  /* Send Device Start Communication */
+  (void)memset(rsp, 0, rsp_len);
+  offset = IDENTIFIER_CMD_LEN;
+  Teseo_Rx_Start(rsp, 1);
+  status = HAL_UART_Transmit(&huart, &buffer[offset], START_COMMUNICATION_LEN, UART_WRITE_SHORT_TIMEOUT);
+  if (status != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
+    Error_Handler();
+  }
+  PRINTBYTES("tx_1", &buffer[offset], START_COMMUNICATION_LEN);
+  status = Teseo_Rx_Wait(HAL_GetTick() + UART_READ_TIMEOUT);
+  PRINTBYTES("rx_1", rsp, 1);
+  if ((status != HAL_OK) || (rsp[0] != (uint8_t)ACK)) {
+    return NACK;
+  }
+  /* Send Image Info */ 
+  offset = IDENTIFIER_CMD_LEN+START_COMMUNICATION_LEN;
+  status = HAL_UART_Transmit(&huart, &buffer[offset], IMAGE_INFO_LEN, UART_WRITE_TIMEOUT);
+  if (status != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
+    Error_Handler();
+  }           
+  PRINTBYTES("tx_1", buffer+offset, IMAGE_INFO_LEN);
+
+  /**
+   * Send Flasher Ready after Image Info until the 1st ACK comes, then wait for
+   * the 2nd and the 3rd (the Erase Memory) ACK.
+   * The idle line after the 1st ACK ends the reception and wakes up the thread at once.
+   */
+  (void)memset(rsp, 0, rsp_len);
+  offset = IDENTIFIER_CMD_LEN+START_COMMUNICATION_LEN+IMAGE_INFO_LEN;
+  Teseo_Rx_StartToIdle(rsp, 3);
+  deadline = HAL_GetTick() + UART_READ_FLASHER_READY_TIMEOUT;
+  while ((huart.RxState != HAL_UART_STATE_READY) && ((int32_t)(deadline - HAL_GetTick()) > 0)) {
+    status = HAL_UART_Transmit(&huart, &buffer[offset], FLASHER_READY_CMD_LEN, UART_WRITE_SHORT_TIMEOUT);
+    if (status != HAL_OK) {
+      Error_Handler();
+    }
+    PRINTBYTES("tx_1", &buffer[offset], FLASHER_READY_CMD_LEN);
+    Teseo_Rx_Sleep(1);
+  }
+  rx_len = 0;
+  deadline = HAL_GetTick() + UART_READ_READY_ACK_TIMEOUT;
+  status = Teseo_Rx_Wait(deadline);
+  while (status == HAL_OK) {
+    rx_len += (uint16_t)(huart.RxXferSize - huart.RxXferCount);
+    if (rx_len >= 3U) {
+      break;
+    }
+    Teseo_Rx_StartToIdle(&rsp[rx_len], (uint16_t)(3U - rx_len));
+    status = Teseo_Rx_Wait(deadline);
+  }
+  PRINTBYTES("rx_1", rsp, 3);
+
+  return (status == HAL_OK) ? rsp[0] : (uint8_t)NACK;
+}
+
+/*
+ * This function registers the RX callbacks of the Teseo UART, if enabled.
+ * The callbacks are set back to the default ones by the UART init.
+ */
+static void Teseo_Rx_Register(void)
+{
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && (USE_HAL_UART_REGISTER_CALLBACKS == 1U)
+  teseoRxThread = osThreadGetId();
+  (void)HAL_UART_RegisterCallback(&huart, HAL_UART_RX_COMPLETE_CB_ID, Teseo_RxCplt);
+  (void)HAL_UART_RegisterRxEventCallback(&huart, Teseo_RxEvent);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+}
+
+/*
+ * This function starts the IT reception of an answer of the Teseo.
+ */
+static void Teseo_Rx_Start(uint8_t *buf, uint16_t len)
+{
+  __HAL_UART_CLEAR_OREFLAG(&huart);
+  if (HAL_UART_Receive_IT(&huart, buf, len) != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Receive ERROR!!!");
+    Error_Handler();
+  }
+}
+
+/*
+ * This function starts the IT reception of an answer of the Teseo, ended by an idle line.
+ * The number of bytes received is RxXferSize - RxXferCount once the reception is over.
+ */
+static void Teseo_Rx_StartToIdle(uint8_t *buf, uint16_t len)
+{
+  __HAL_UART_CLEAR_OREFLAG(&huart);
+  if (HAL_UARTEx_ReceiveToIdle_IT(&huart, buf, len) != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Receive ERROR!!!");
+    Error_Handler();
+  }
+}
+
+/*
+ * This function sleeps at most timeout ms, less if the current reception ends.
+ */
+static void Teseo_Rx_Sleep(uint32_t timeout)
+{
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && (USE_HAL_UART_REGISTER_CALLBACKS == 1U)
+#if (osCMSIS < 0x20000U)
+  (void)osSignalWait(TESEO_RX_SIGNAL, timeout);
+#else
+  (void)osThreadFlagsWait(TESEO_RX_SIGNAL, osFlagsWaitAny, timeout);
+#endif /* osCMSIS */
+#else
+  (void)timeout;
+  (void)osDelay(1);
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+}
+
+/*
+ * This function waits for the end of the IT reception of an answer of the Teseo,
+ * at most until the deadline (HAL tick).
+ */
+static HAL_StatusTypeDef Teseo_Rx_Wait(uint32_t deadline)
+{
+  int32_t left;
+
+  while (huart.RxState != HAL_UART_STATE_READY) {
+    left = (int32_t)(deadline - HAL_GetTick());
+    if (left <= 0) {
+      (void)HAL_UART_AbortReceive(&huart);
+      return HAL_TIMEOUT;
+    }
+    Teseo_Rx_Sleep((uint32_t)left);
+  }
+  return HAL_OK;
+}
+
+#if defined(USE_HAL_UART_REGISTER_CALLBACKS) && (USE_HAL_UART_REGISTER_CALLBACKS == 1U)
+/*
+ * RX complete callback of the Teseo UART: it wakes up the upgrading thread.
+ */
+static void Teseo_RxCplt(UART_HandleTypeDef *h)
+{
+  (void)h;
+#if (osCMSIS < 0x20000U)
+  (void)osSignalSet(teseoRxThread, TESEO_RX_SIGNAL);
+#else
+  (void)osThreadFlagsSet(teseoRxThread, TESEO_RX_SIGNAL);
+#endif /* osCMSIS */
+}
+
+/*
+ * RX event callback of the Teseo UART (idle line or buffer full): it wakes up the upgrading thread.
+ */
+static void Teseo_RxEvent(UART_HandleTypeDef *h, uint16_t size)
+{
+  (void)size;
+  Teseo_RxCplt(h);
+}
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
 /*
  * This function sends the NMEA $PSTMGETSWVER command and returns
  * the firmware image version.
+ * The NMEA output is received by IT: each burst, ended by an idle line, is searched
+ * for the answer as soon as it is received.
  */
 static char* Get_GNSS_FW_Version(void) 
 {
   char* ver = NULL;
   HAL_StatusTypeDef status;  
   uint16_t buffer_sz = 512;
+  uint16_t rx_len;
+  uint32_t deadline;
 
+  Teseo_Rx_Register();
   while (ver == NULL) {
+    rx_len = 0;
+    Teseo_Rx_StartToIdle(rxBuffer, buffer_sz);
     status = HAL_UART_Transmit(&huart, (uint8_t *)"$PSTMGETSWVER,6\n\r", (uint16_t)sizeof("$PSTMGETSWVER,6\n\r"), UART_WRITE_TIMEOUT);
-    if (status == HAL_OK) {
-      status = HAL_UART_Receive(&huart, rxBuffer, buffer_sz, UART_READ_STRING_TIMEOUT);
-      if ((status != HAL_OK) && (status != HAL_TIMEOUT)) {
-        Error_Handler();
+    if (status != HAL_OK) {
+      (void)HAL_UART_AbortReceive(&huart);
+      continue;
+    }
+    /* a request sent while the Teseo boots is retried as soon as the NMEA output starts */
+    deadline = HAL_GetTick() + UART_READ_STRING_TIMEOUT;
+    while ((ver == NULL) && (Teseo_Rx_Wait(deadline) == HAL_OK)) {
+      rx_len += (uint16_t)(huart.RxXferSize - huart.RxXferCount);
+      ver = TESEO_Detect_Sentence("PSTMVER,BINIMG", rxBuffer, rx_len);
+      if ((ver == NULL) && (rx_len < buffer_sz)) {
+        Teseo_Rx_StartToIdle(&rxBuffer[rx_len], (uint16_t)(buffer_sz - rx_len));
+      }
+      else {
+        break;
       }
-      ver = TESEO_Detect_Sentence("PSTMVER,BINIMG", rxBuffer, buffer_sz);
-      (void)osDelay(500);
     }
   }
   return ver;
@@ -501,6 +972,11 @@ static char* TESEO_Detect_Sentence(const char *rsp, uint8_t *buf, uint32_t len)
   char *result = NULL;
   uint32_t i = 0;
   const unsigned long rsp_len = strlen(rsp);
+  uint32_t end = len;
+
+  if (len <= rsp_len) {
+    return NULL;
+  }
   len -= strlen(rsp);
   
   PRINTBYTES("rx_1", buf, len); 
@@ -518,14 +994,297 @@ static char* TESEO_Detect_Sentence(const char *rsp, uint8_t *buf, uint32_t len)
   }
   
   if (result) {
-    for (i = 0; result[i] != '*'; ++i);
-    result[i] = 0;
+    /* the sentence must be complete */
+    for (i = (uint32_t)(result - (char*)buf); (i < end) && (buf[i] != (uint8_t)'*'); ++i);
+    if (i < end) {
+      buf[i] = 0;
+    }
+    else {
+      result = NULL;
+    }
   }
     
   return result;
   
 }
 
+#if (FWUPG_PIPELINED_RELAY == 1)
+/*
+ * This function receives a FW chunk from the host by DMA.
+ */
+static HAL_StatusTypeDef Relay_Receive(uint8_t *buf, uint16_t len, uint32_t timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  if (HAL_UART_Receive_DMA(&io_huart, buf, len) != HAL_OK) {
+    return HAL_ERROR;
+  }
+  while (io_huart.RxState != HAL_UART_STATE_READY) {
+    if ((HAL_GetTick() - tickstart) > timeout) {
+      (void)HAL_UART_AbortReceive(&io_huart);
+      return HAL_TIMEOUT;
+    }
+    (void)osDelay(1);
+  }
+  return HAL_OK;
+}
+
+/*
+ * This function starts writing a FW chunk to the Teseo by DMA, its ACK is got
+ * by Relay_Complete().
+ */
+static void Relay_Start(uint8_t *buf, uint16_t len)
+{
+  relayAck = 0x00;
+  relayStart = HAL_GetTick();
+  /* listen before sending, the ACK can come as soon as the last byte is out */
+  if (HAL_UART_Receive_IT(&huart, (uint8_t *)&relayAck, 1) != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Receive ERROR!!!");
+    Error_Handler();
+  }
+  if (HAL_UART_Transmit_DMA(&huart, buf, len) != HAL_OK) {
+    PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
+    Error_Handler();
+  }
+  relayPending = 1;
+}
+
+/*
+ * This function waits for the end of the FW chunk write to the Teseo and returns
+ * its ACK (0x00 on timeout).
+ */
+static uint8_t Relay_Complete(void)
+{
+  uint8_t ack = 0x00;
+
+  while ((huart.gState != HAL_UART_STATE_READY) || (huart.RxState != HAL_UART_STATE_READY)) {
+    if ((HAL_GetTick() - relayStart) > (uint32_t)(UART_READ_LONG_TIMEOUT + UART_READ_CHUNK_ACK_TIMEOUT)) {
+      (void)HAL_UART_Abort(&huart);
+      relayPending = 0;
+      return ack;
+    }
+    (void)osDelay(1);
+  }
+  ack = relayAck;
+  relayPending = 0;
+  return ack;
+}
+#endif /* FWUPG_PIPELINED_RELAY */
+
+#if (FWUPG_RESUMABLE == 1) || (FWUPG_STAGED == 1)
+/*
+ * This function updates a CRC32 (IEEE 802.3, reflected): it starts from 0xFFFFFFFF
+ * and the result is complemented at the end.
+ */
+static uint32_t Crc32_Update(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i++) {
+    crc ^= buf[i];
+    for (uint8_t b = 0; b < 8U; b++) {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+/*
+ * This function sends an answer to the host.
+ */
+static void Host_Reply(uint8_t *buf, uint16_t len)
+{
+  HAL_StatusTypeDef status;
+
+  status = HAL_UART_Transmit(&io_huart, buf, len, UART_WRITE_TIMEOUT);
+  if (status != HAL_OK) {
+    PRINTMSG("HAL_UART_2_Transmit ERROR!!!");
+    Error_Handler();
+  }
+  PRINTBYTES("tx_2", buf, len);
+}
+#endif /* FWUPG_RESUMABLE || FWUPG_STAGED */
+
+#if (FWUPG_RESUMABLE == 1)
+/*
+ * This function reads a little endian 32 bits field of a framed chunk.
+ */
+static uint32_t Chunk_Get32(const uint8_t *buf)
+{
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+#endif /* FWUPG_RESUMABLE */
+
+#if (FWUPG_STAGED == 1)
+/*
+ * This function erases the staging region and keeps the FWUPG_SYNC frame of the image.
+ */
+static uint8_t Stage_Begin(const uint8_t *sync)
+{
+  FLASH_EraseInitTypeDef erase;
+  uint32_t error;
+  HAL_StatusTypeDef status;
+
+#if defined(USE_STM32L4XX_NUCLEO)
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+#if defined(FLASH_BANK_2)
+  erase.Banks = ((FWUPG_STAGE_ADDR - FLASH_BASE) < FLASH_BANK_SIZE) ? FLASH_BANK_1 : FLASH_BANK_2;
+  erase.Page = ((FWUPG_STAGE_ADDR - FLASH_BASE) % FLASH_BANK_SIZE) / FLASH_PAGE_SIZE;
+#else
+  erase.Banks = FLASH_BANK_1;
+  erase.Page = (FWUPG_STAGE_ADDR - FLASH_BASE) / FLASH_PAGE_SIZE;
+#endif /* FLASH_BANK_2 */
+  erase.NbPages = FWUPG_STAGE_SIZE / FLASH_PAGE_SIZE;
+#else
+  erase.TypeErase = FLASH_TYPEERASE_SECTORS;
+  erase.Sector = FWUPG_STAGE_SECTOR;
+  erase.NbSectors = FWUPG_STAGE_SECTOR_NBR;
+  erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+#endif /* USE_STM32L4XX_NUCLEO */
+
+  (void)HAL_FLASH_Unlock();
+  __HAL_FLASH_CLEAR_FLAG(STAGE_FLASH_ERRORS);
+  status = HAL_FLASHEx_Erase(&erase, &error);
+  (void)HAL_FLASH_Lock();
+  if (status != HAL_OK) {
+    PRINTMSG("stage erase error 0x%lx\n", error);
+    return NACK;
+  }
+
+  (void)memset(&stageHdr, 0xFF, sizeof(stageHdr));
+  (void)memcpy(stageHdr.sync, sync, UART_FWUPG_SYNC_SZ);
+  stageLen = 0;
+  stageChunkSz = 0;
+  stageCrc = 0xFFFFFFFFU;
+  return ACK;
+}
+
+/*
+ * This function appends a chunk to the staged image. All the chunks but the last one
+ * must have the size of the first one. The flash is programmed by STAGE_PROG_SZ words:
+ * only the last chunk may end on a partial word, which Stage_Program() pads.
+ */
+static uint8_t Stage_Write(const uint8_t *buf, uint16_t len)
+{
+  if (stageChunkSz == 0U) {
+    stageChunkSz = len;
+  }
+  /* A chunk after a padded one would start in the middle of a programmed word */
+  if (((stageLen % STAGE_PROG_SZ) != 0U) ||
+      ((stageLen % stageChunkSz) != 0U) || (len > stageChunkSz) ||
+      ((stageLen + len) > STAGE_DATA_SZ)) {
+    return NACK;
+  }
+  if (Stage_Program(STAGE_DATA_ADDR + stageLen, buf, len) != HAL_OK) {
+    return NACK;
+  }
+  stageCrc = Crc32_Update(stageCrc, buf, len);
+  stageLen += len;
+  return ACK;
+}
+
+/*
+ * This function checks the staged image read back from the flash and programs its header.
+ */
+static uint8_t Stage_Commit(void)
+{
+  uint32_t crc = ~Crc32_Update(0xFFFFFFFFU, (const uint8_t *)STAGE_DATA_ADDR, stageLen);
+
+  if ((stageLen == 0U) || (crc != ~stageCrc)) {
+    PRINTMSG("stage CRC error\n");
+    return NACK;
+  }
+  stageHdr.magic = STAGE_MAGIC;
+  stageHdr.image_len = stageLen;
+  stageHdr.chunk_sz = stageChunkSz;
+  stageHdr.image_crc = crc;
+  stageHdr.hdr_crc = ~Crc32_Update(0xFFFFFFFFU, (const uint8_t *)&stageHdr, offsetof(Stage_Header_t, hdr_crc));
+  if (Stage_Program(FWUPG_STAGE_ADDR, (const uint8_t *)&stageHdr, sizeof(stageHdr)) != HAL_OK) {
+    return NACK;
+  }
+  return ACK;
+}
+
+/*
+ * This function flashes the Teseo with the staged image and returns the CRC ACK.
+ */
+static uint8_t Stage_Flash(void)
+{
+  const Stage_Header_t *hdr = (const Stage_Header_t *)FWUPG_STAGE_ADDR;
+  uint8_t *image = (uint8_t *)STAGE_DATA_ADDR;
+  uint8_t sync[UART_FWUPG_SYNC_SZ];
+  uint32_t off;
+  uint16_t n;
+  uint8_t ack;
+  int synced = 0;
+  HAL_StatusTypeDef status;
+
+  if ((hdr->magic != STAGE_MAGIC) ||
+      (hdr->hdr_crc != ~Crc32_Update(0xFFFFFFFFU, (const uint8_t *)hdr, offsetof(Stage_Header_t, hdr_crc))) ||
+      (hdr->image_len > STAGE_DATA_SZ) || (hdr->chunk_sz == 0U) ||
+      (hdr->image_crc != ~Crc32_Update(0xFFFFFFFFU, image, hdr->image_len))) {
+    PRINTMSG("no valid staged image\n");
+    return NACK;
+  }
+  (void)memcpy(sync, hdr->sync, UART_FWUPG_SYNC_SZ);
+
+  GNSS_UART_DeInit();
+  GNSS_UART_Init(FWUPG_STAGE_BAUD_RATE);
+  ack = Teseo_Flasher_Start(sync, &synced);
+
+  for (off = 0; (ack == (uint8_t)ACK) && (off < hdr->image_len); off += n) {
+    n = (uint16_t)(((hdr->image_len - off) < hdr->chunk_sz) ? (hdr->image_len - off) : hdr->chunk_sz);
+    status = HAL_UART_Transmit(&huart, &image[off], n, UART_WRITE_LONG_TIMEOUT);
+    if (status != HAL_OK) {
+      PRINTMSG("HAL_UART_1_Transmit ERROR!!!");
+      return NACK;
+    }
+    ack = 0x00;
+    (void)HAL_UART_Receive(&huart, &ack, 1, UART_READ_CHUNK_ACK_TIMEOUT);
+    PRINTBYTES("rx_1", &ack, 1);
+  }
+  if (ack == (uint8_t)ACK) {
+    /* Receive the CRC ACK */
+    ack = 0x00;
+    (void)HAL_UART_Receive(&huart, &ack, 1, UART_READ_CRC_ACK_TIMEOUT);
+    PRINTBYTES("rx_1", &ack, 1);
+  }
+  return ack;
+}
+
+/*
+ * This function programs a buffer in the staging region, padding the last flash word with 0xFF.
+ */
+static HAL_StatusTypeDef Stage_Program(uint32_t addr, const uint8_t *buf, uint32_t len)
+{
+  HAL_StatusTypeDef status = HAL_OK;
+  uint64_t data;
+  uint32_t n;
+
+  (void)HAL_FLASH_Unlock();
+  for (uint32_t i = 0; (status == HAL_OK) && (i < len); i += STAGE_PROG_SZ) {
+    n = ((len - i) < STAGE_PROG_SZ) ? (len - i) : STAGE_PROG_SZ;
+    data = 0xFFFFFFFFFFFFFFFFULL;
+    (void)memcpy(&data, &buf[i], n);
+    status = HAL_FLASH_Program(STAGE_PROG_TYPE, addr + i, data);
+  }
+  (void)HAL_FLASH_Lock();
+  return status;
+}
+
+/*
+ * This function flashes the Teseo again with the image staged in the MCU flash.
+ */
+int FWUpgrade_Staged(void)
+{
+  uint8_t ack = Stage_Flash();
+
+  GNSS_UART_DeInit();
+  GNSS_Reset();
+  GNSS_UART_Init(DEFAULT_UART_BAUD_RATE);
+
+  return (ack == (uint8_t)ACK) ? 0 : -1;
+}
+#endif /* FWUPG_STAGED */
+
 #ifdef PRINT_BYTES_ON_TERMINAL_IO
 /*
  *  This function print on terminal IO the bytes read/written from/to both the UART.
@@ -43,6 +43,14 @@
  * @retval None
  */
 void FWUpgrade(void);
+
+/**	
+ * @brief  Function flashing the Teseo with the image stored in the MCU flash by
+ *         a staged upgrade (available when FWUPG_STAGED is 1)
+ * @param  None
+ * @retval 0 if the Teseo has been flashed, -1 otherwise
+ */
+int FWUpgrade_Staged(void);
 /**
  * @}
  */
@@ -42,6 +42,50 @@ extern "C" {
   *  @{
   */
 
+/** @defgroup GNSS_DATA_TYPES GNSS DATA TYPES
+  *  @{
+  */
+
+/**
+  * @brief Output buffer of the integer-only formatters (GNSS_DATA_Fmt* functions).
+  *        The formatters never need printf float support; the output is
+  *        truncated when the buffer is full and is always NUL terminated.
+  */
+typedef struct
+{
+  char *pBuf;     /**< Caller-supplied buffer */
+  uint32_t size;  /**< Size of pBuf in bytes */
+  uint32_t len;   /**< Number of characters written so far */
+} GNSS_DATA_Fmt_t;
+
+/**
+  * @brief Binary epoch record (GNSS_DATA_EncodeEpoch), all fields little endian:
+  *        | sync1 | sync2 | version | payload length | payload | CRC16 |
+  *        The CRC16-CCITT (0x1021, init 0xFFFF) covers version, length and payload.
+  *        Payload of version 1:
+  *         0 u32 UTC time of day (s)           20 u16 speed over ground (cm/s)
+  *         4 u8  day, 5 u8 month, 6 u8 year-2000 22 u16 course over ground (0.01 deg)
+  *         7 u8  GGA fix quality               24 u16 PDOP, 26 u16 HDOP, 28 u16 VDOP (x100)
+  *         8 i32 latitude (1e-7 deg, N > 0)    30 u8  GSA fix mode (1 none, 2 2D, 3 3D)
+  *        12 i32 longitude (1e-7 deg, E > 0)   31 u8  satellites used, 32 u8 in view
+  *        16 i32 altitude (cm)                 33 u8  n, number of satellite entries
+  *        34 n x { u16 PRN, u8 C/N0 (dB), bit 7 set if used in the fix }
+  *        Satellites in view are summed over the constellations, the n entries
+  *        (at most MAX_SAT_NUM) come from all the GSV sentences of the epoch.
+  */
+#define GNSS_DATA_EPOCH_SYNC1       0xA5U
+#define GNSS_DATA_EPOCH_SYNC2       0x5AU
+#define GNSS_DATA_EPOCH_VERSION     1U
+#define GNSS_DATA_EPOCH_HDR_SIZE    4U
+#define GNSS_DATA_EPOCH_FIXED_SIZE  34U
+#define GNSS_DATA_EPOCH_SAT_SIZE    3U
+#define GNSS_DATA_EPOCH_MAX_SIZE    (GNSS_DATA_EPOCH_HDR_SIZE + GNSS_DATA_EPOCH_FIXED_SIZE + \
+                                     (GNSS_DATA_EPOCH_SAT_SIZE * MAX_SAT_NUM) + 2U)
+
+/**
+  * @}
+  */
+
 /** @defgroup GNSS_DATA_FUNCTIONS GNSS DATA FUNCTIONS
   *  @brief Prototypes of the API allowing the application to interface the driver
   *  and interact with GNSS module (sending commands, retrieving parsed NMEA info, etc.).
@@ -49,6 +93,106 @@ extern "C" {
   *  @{
   */
 
+/**
+  * @brief  This function initializes a formatter on a caller-supplied buffer.
+  * @param  pFmt  The formatter
+  * @param  pBuf  The output buffer
+  * @param  size  The size of the output buffer
+  * @retval None
+  */
+void GNSS_DATA_FmtInit(GNSS_DATA_Fmt_t *pFmt, char *pBuf, uint32_t size);
+
+/**
+  * @brief  This function appends a character.
+  * @param  pFmt  The formatter
+  * @param  c     The character
+  * @retval None
+  */
+void GNSS_DATA_FmtChar(GNSS_DATA_Fmt_t *pFmt, char c);
+
+/**
+  * @brief  This function appends a string.
+  * @param  pFmt  The formatter
+  * @param  pStr  The NUL terminated string
+  * @retval None
+  */
+void GNSS_DATA_FmtStr(GNSS_DATA_Fmt_t *pFmt, const char *pStr);
+
+/**
+  * @brief  This function appends an unsigned integer (as "%0*u").
+  * @param  pFmt  The formatter
+  * @param  val   The value
+  * @param  width The minimum number of digits (zero padded)
+  * @retval None
+  */
+void GNSS_DATA_FmtUint(GNSS_DATA_Fmt_t *pFmt, uint32_t val, uint8_t width);
+
+/**
+  * @brief  This function appends a signed integer (as "%0*d").
+  * @param  pFmt  The formatter
+  * @param  val   The value
+  * @param  width The minimum number of characters, sign included (zero padded)
+  * @retval None
+  */
+void GNSS_DATA_FmtInt(GNSS_DATA_Fmt_t *pFmt, int32_t val, uint8_t width);
+
+/**
+  * @brief  This function appends a real number in fixed-point notation (as "%.*f").
+  * @param  pFmt     The formatter
+  * @param  val      The value (its integer part is saturated to 32 bits)
+  * @param  decimals The number of decimals (0 to 9)
+  * @retval None
+  */
+void GNSS_DATA_FmtFixed(GNSS_DATA_Fmt_t *pFmt, float64_t val, uint8_t decimals);
+
+/**
+  * @brief  This function appends an UTC time as hh:mm:ss.
+  * @param  pFmt  The formatter
+  * @param  pUtc  The UTC time
+  * @retval None
+  */
+void GNSS_DATA_FmtUtc(GNSS_DATA_Fmt_t *pFmt, const UTC_Info_t *pUtc);
+
+/**
+  * @brief  This function appends a NMEA (d)ddmm.mmmm coordinate as degrees, minutes and seconds.
+  * @param  pFmt      The formatter
+  * @param  coord     The coordinate as got from the NMEA sentence
+  * @param  hemi      The hemisphere character (N/S/E/W)
+  * @param  min_width The minimum number of digits of the minutes
+  * @retval None
+  */
+void GNSS_DATA_FmtCoord(GNSS_DATA_Fmt_t *pFmt, float64_t coord, uint8_t hemi, uint8_t min_width);
+
+/**
+  * @brief  This function renders the last GPGGA fix in a caller-supplied buffer as
+  *         a CSV line: hh:mm:ss,lat,lon,alt,sats,hdop,fix (decimal degrees, meters).
+  * @param  pGNSSParser_Data Handler of the GNSS data
+  * @param  pBuf             The output buffer
+  * @param  size             The size of the output buffer
+  * @retval The length of the line
+  */
+int32_t GNSS_DATA_FormatFix(GNSSParser_Data_t *pGNSSParser_Data, char *pBuf, uint32_t size);
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+/**
+  * @brief  This function encodes the last parsed epoch (GGA, RMC, GSA and GSV data)
+  *         as a binary record in a caller-supplied buffer.
+  * @param  pGNSSParser_Data Handler of the GNSS data
+  * @param  pBuf             The output buffer
+  * @param  size             The size of the output buffer (GNSS_DATA_EPOCH_MAX_SIZE is always enough)
+  * @retval The length of the record, -1 if the buffer is too small or the date is not known yet
+  */
+int32_t GNSS_DATA_EncodeEpoch(GNSSParser_Data_t *pGNSSParser_Data, uint8_t *pBuf, uint32_t size);
+
+/**
+  * @brief  This function sends the binary record of the last parsed epoch
+  *         through PRINT_BIN.
+  * @param  pGNSSParser_Data Handler of the GNSS data
+  * @retval None
+  */
+void GNSS_DATA_SendEpoch(GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* CONFIG_USE_EPOCH_BIN */
+
 /**
   * @brief  This function sends a command to the GNSS module.
   * @param  pCommand  The string with NMEA command to be sent to the GNSS module
@@ -140,26 +284,32 @@ void GNSS_DATA_GetPSTMSetParInfo(GNSSParser_Data_t *pGNSSParser_Data);
   */
 void GNSS_DATA_GetPSTMGetParInfo(GNSSParser_Data_t *pGNSSParser_Data);
 
+#if (GNSS_PARSER_USE_GEOFENCE_DATA == 1)
 /**
   * @brief  This function prints on the console the geofence infos each time an alarm is received
   * @param  pGNSSParser_Data Handler of the GNSS data
   * @retval None
   */
 void GNSS_DATA_GetGeofenceInfo(GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* GNSS_PARSER_USE_GEOFENCE_DATA */
 
+#if (GNSS_PARSER_USE_ODO_DATA == 1)
 /**
   * @brief  This function prints on the console the info about Odometer.
   * @param  pGNSSParser_Data Handler of the GNSS data
   * @retval None
   */
 void GNSS_DATA_GetOdometerInfo(const GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* GNSS_PARSER_USE_ODO_DATA */
 
+#if (GNSS_PARSER_USE_DATALOG_DATA == 1)
 /**
   * @brief  This function prints on the console the info about Datalog.
   * @param  pGNSSParser_Data Handler of the GNSS data
   * @retval None
   */
 void GNSS_DATA_GetDatalogInfo(const GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* GNSS_PARSER_USE_DATALOG_DATA */
 
 /**
   * @brief  This function gets the ACK from the GPS data.
@@ -256,6 +406,7 @@ void GNSS_DATA_EraseDatalog(void);
   */
 void GNSS_DATA_PassGen(uint32_t currentTime);
 
+#if (GNSS_PARSER_USE_AGNSS_DATA == 1)
 /**
   * @brief  This function prints on the console the info about DeviceId and Pwd.
   * @param  pGNSSParser_Data Handler of the GNSS data
@@ -269,6 +420,7 @@ void GNSS_DATA_GetPSTMPassInfo(GNSSParser_Data_t *pGNSSParser_Data);
   * @retval None
   */
 void GNSS_DATA_GetPSTMAGPSInfo(const GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* GNSS_PARSER_USE_AGNSS_DATA */
 
 /**
   * @}
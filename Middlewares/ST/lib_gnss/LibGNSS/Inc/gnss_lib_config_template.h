@@ -27,6 +27,13 @@ extern "C" {
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
 
+/* LibGNSS options */
+#define CONFIG_USE_EPOCH_BIN 0 /* Binary epoch records off */
+
+#define CONFIG_USE_LAZY_DECODE 0 /* GGA/GNS/GST/RMC/GSA/GSV decoded when parsing (1: when first read) */
+
+#define CONFIG_USE_LEAN_DATA 0 /* Full GNSS data layout (1: disabled features' holders dropped, no LibAGNSS) */
+
 /** @addtogroup MIDDLEWARES
   *  @{
   */
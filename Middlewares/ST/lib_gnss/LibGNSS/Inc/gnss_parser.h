@@ -27,6 +27,7 @@ extern "C" {
 #include "NMEA_parser.h"
 #include "gnss_geofence.h"
 #include "gnss_datalog.h"
+#include "gnss_lib_config.h"
 
 /** @addtogroup MIDDLEWARES
   *  @{
@@ -52,7 +53,42 @@ extern "C" {
 /**
   * @brief Constant that indicates the maximum number of positions that can be stored.
   */
+#ifndef MAX_STOR_POS
+#if (CONFIG_USE_LEAN_DATA == 1)
+#define MAX_STOR_POS 8
+#else
 #define MAX_STOR_POS 64
+#endif /* CONFIG_USE_LEAN_DATA */
+#endif /* MAX_STOR_POS */
+
+/**
+  * @brief Constants that tell whether the data holders of optional features are part of GNSSParser_Data_t.
+  *        The lean profile (CONFIG_USE_LEAN_DATA) keeps only the holders of the enabled features and drops
+  *        the assisted GNSS ones: it cannot be used with LibAGNSS.
+  */
+#if (CONFIG_USE_LEAN_DATA == 1)
+#if (CONFIG_USE_FEATURE == 1) || (CONFIG_USE_GEOFENCE == 1)
+#define GNSS_PARSER_USE_GEOFENCE_DATA 1
+#else
+#define GNSS_PARSER_USE_GEOFENCE_DATA 0
+#endif /* CONFIG_USE_FEATURE || CONFIG_USE_GEOFENCE */
+#if (CONFIG_USE_FEATURE == 1) || (CONFIG_USE_ODOMETER == 1)
+#define GNSS_PARSER_USE_ODO_DATA 1
+#else
+#define GNSS_PARSER_USE_ODO_DATA 0
+#endif /* CONFIG_USE_FEATURE || CONFIG_USE_ODOMETER */
+#if (CONFIG_USE_FEATURE == 1) || (CONFIG_USE_DATALOG == 1)
+#define GNSS_PARSER_USE_DATALOG_DATA 1
+#else
+#define GNSS_PARSER_USE_DATALOG_DATA 0
+#endif /* CONFIG_USE_FEATURE || CONFIG_USE_DATALOG */
+#define GNSS_PARSER_USE_AGNSS_DATA 0
+#else
+#define GNSS_PARSER_USE_GEOFENCE_DATA 1
+#define GNSS_PARSER_USE_ODO_DATA 1
+#define GNSS_PARSER_USE_DATALOG_DATA 1
+#define GNSS_PARSER_USE_AGNSS_DATA 1
+#endif /* CONFIG_USE_LEAN_DATA */
 
 /**
   * @brief Constant that indicates the length of the buffer that stores the GPS data read by the GPS expansion.
@@ -75,6 +111,31 @@ extern "C" {
   */
 #define NMEA_MSGS_NUM 19 /* Note: update this constant coherently to eMsg enum type */
 
+/**
+  * @brief Constant that indicates the number of time-stamped message types (GPGGA, GNS, GPGST and GPRMC).
+  */
+#define GNSS_PARSER_TIMED_NUM 4U
+
+#if (CONFIG_USE_LAZY_DECODE == 1)
+#if (CONFIG_USE_EPOCH_BIN == 1)
+/**
+  * @brief Constant that indicates the number of message types (GPGGA to GPRMC) stored raw and decoded on demand.
+  *        GSA and GSV are decoded at once: their satellites are accumulated over the epoch.
+  */
+#define GNSS_PARSER_LAZY_NUM 4U
+#else
+/**
+  * @brief Constant that indicates the number of message types (GPGGA to GSV) stored raw and decoded on demand.
+  */
+#define GNSS_PARSER_LAZY_NUM 6U
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+/**
+  * @brief Constant that indicates the size of the buffer holding a raw sentence (longer ones are decoded at once).
+  */
+#define GNSS_PARSER_RAW_LEN 96U
+#endif /* CONFIG_USE_LAZY_DECODE */
+
 /**
   * @}
   */
@@ -127,6 +188,57 @@ typedef enum
   PSTMGETPAR
 } eNMEAMsg;
 
+/**
+  * @brief Data structure that contains the GNSS time of the latest epoch and of each time-stamped sentence
+  */
+typedef struct
+{
+  int32_t date;     /**< Date (ddmmyy) the time was computed for */
+  int32_t tod;      /**< UTC time of day in ms the time was computed for */
+  int32_t rmc_tod;  /**< UTC time of day in ms of the latest RMC sentence */
+  GNSS_Time_t time; /**< GNSS time of the epoch, GNSS_TIME_INVALID until a date is received */
+  GNSS_Time_t msg_time[GNSS_PARSER_TIMED_NUM]; /**< GNSS time of the latest GPGGA, GNS, GPGST and GPRMC sentence */
+} GNSSParser_Epoch_t;
+
+#if (CONFIG_USE_LAZY_DECODE == 1)
+/**
+  * @brief Data structure that contains the latest raw sentence of each lazily decoded message type
+  */
+typedef struct
+{
+  uint8_t sentence[GNSS_PARSER_LAZY_NUM][GNSS_PARSER_RAW_LEN]; /**< Raw sentences, '\n' terminated */
+  uint32_t pending; /**< Bit n set when sentence[n] has not been decoded yet */
+} GNSSParser_Raw_t;
+#endif /* CONFIG_USE_LAZY_DECODE */
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+/**
+  * @brief Data structure that contains the satellites of the latest epoch, accumulated over
+  *        its GSA sentences (one per constellation) and GSV sentences (four satellites each)
+  */
+typedef struct
+{
+  int16_t view_prn[MAX_SAT_NUM]; /**< PRN of the satellites in view */
+  int16_t view_cn0[MAX_SAT_NUM]; /**< C/N0 in dB of the satellites in view */
+  int16_t used_prn[MAX_SAT_NUM]; /**< PRN of the satellites used in the fix */
+  uint8_t view_nbr;  /**< Number of entries of view_prn (at most MAX_SAT_NUM) */
+  uint8_t used_nbr;  /**< Number of entries of used_prn (at most MAX_SAT_NUM) */
+  uint8_t tot_sats;  /**< Satellites in view, summed over the constellations */
+  uint8_t restart;   /**< Set by a time-stamped sentence: the next GSA or GSV sentence starts a new epoch */
+} GNSSParser_Sats_t;
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+#if (CONFIG_USE_RX_STATS == 1)
+/**
+  * @brief Data structure that contains the parser statistics
+  */
+typedef struct
+{
+  uint32_t checksum_errors; /**< Sentences rejected by GNSS_PARSER_CheckMsg */
+  uint32_t msg_count[NMEA_MSGS_NUM]; /**< Sentences parsed, per message type */
+} GNSSParser_Stats_t;
+#endif /* CONFIG_USE_RX_STATS */
+
 /**
   * @brief Data structure that contains the GNSS data
   */
@@ -141,16 +253,34 @@ typedef struct
   GSV_Info_t   gsv_data;   /**< $--GSV Data holder */
 
   PSTMVER_Info_t pstmver_data;   /**< $PSTMVER Data holder */
+#if (GNSS_PARSER_USE_AGNSS_DATA == 1)
   PSTMPASSRTN_Info_t pstmpass_data; /**< $PSTMPASSRTN Data holder */
   PSTMAGPS_Info_t pstmagps_data; /**< $PSTMAGPS Data holder */
+#endif /* GNSS_PARSER_USE_AGNSS_DATA */
   PSTMSETPAROK_Info_t pstmsetparok_data; /**< Result from PSTMSETPAR command */
   PSTMGETPAR_Info_t pstmgetpar_data; /**< $PSTMGETPAR Data holder */
 
+#if (GNSS_PARSER_USE_GEOFENCE_DATA == 1)
   Geofence_Info_t geofence_data; /**< $PSTMGEOFENCE Data holder */
+#endif /* GNSS_PARSER_USE_GEOFENCE_DATA */
+#if (GNSS_PARSER_USE_ODO_DATA == 1)
   Odometer_Info_t odo_data; /**< $PSTMODO Data holder */
+#endif /* GNSS_PARSER_USE_ODO_DATA */
+#if (GNSS_PARSER_USE_DATALOG_DATA == 1)
   Datalog_Info_t datalog_data; /**< $PSTMDATALOG Data holder */
+#endif /* GNSS_PARSER_USE_DATALOG_DATA */
 
   OpResult_t result; /**< Operation result/status */
+  GNSSParser_Epoch_t epoch; /**< GNSS time of the latest epoch and sentences */
+#if (CONFIG_USE_LAZY_DECODE == 1)
+  GNSSParser_Raw_t raw; /**< Sentences waiting to be decoded */
+#endif /* CONFIG_USE_LAZY_DECODE */
+#if (CONFIG_USE_RX_STATS == 1)
+  GNSSParser_Stats_t stats; /**< Parser statistics */
+#endif /* CONFIG_USE_RX_STATS */
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  GNSSParser_Sats_t sats; /**< Satellites of the latest epoch */
+#endif /* CONFIG_USE_EPOCH_BIN */
 } GNSSParser_Data_t;
 
 /**
@@ -176,6 +306,17 @@ GNSSParser_Status_t GNSS_PARSER_Init(GNSSParser_Data_t *pGNSSParser_Data);
   */
 GNSSParser_Status_t GNSS_PARSER_CheckSanity(uint8_t *pSentence, uint64_t len);
 
+/**
+  * @brief  This function checks the sanity of a GNSS sentence received by the agent.
+  *         Same as GNSS_PARSER_CheckSanity, failures are counted in the agent
+  *         statistics when CONFIG_USE_RX_STATS is enabled.
+  * @param  pGNSSParser_Data The agent
+  * @param  pSentence The sentence
+  * @param  len The sentence length
+  * @retval GNSS_PARSER_OK on success GNSS_PARSER_ERROR otherwise
+  */
+GNSSParser_Status_t GNSS_PARSER_CheckMsg(GNSSParser_Data_t *pGNSSParser_Data, uint8_t *pSentence, uint64_t len);
+
 /**
   * @brief  This function dispatches a GNSS sentence to be parsed
   * @param  pGNSSParser_Data The agent
@@ -185,6 +326,27 @@ GNSSParser_Status_t GNSS_PARSER_CheckSanity(uint8_t *pSentence, uint64_t len);
   */
 GNSSParser_Status_t GNSS_PARSER_ParseMsg(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, uint8_t *pBuffer);
 
+/**
+  * @brief  This function returns the GNSS time (ms since the GPS epoch) of the latest sentence of a message type.
+  *         The date comes from the latest $--RMC sentence.
+  * @param  pGNSSParser_Data The agent
+  * @param  msg The message type (GPGGA, GNS, GPGST or GPRMC)
+  * @retval The GNSS time, GNSS_TIME_INVALID if not known
+  */
+GNSS_Time_t GNSS_PARSER_GetTime(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg);
+
+/**
+  * @brief  This function decodes the stored sentence of a message type, if not decoded yet.
+  *         With CONFIG_USE_LAZY_DECODE, GNSS_PARSER_ParseMsg only validates and stores
+  *         GPGGA, GNS, GPGST, GPRMC, GSA and GSV sentences (GSA and GSV are decoded at
+  *         once with CONFIG_USE_EPOCH_BIN): their data holder is up to date only after this call. It must be serialized with GNSS_PARSER_ParseMsg.
+  *         Without CONFIG_USE_LAZY_DECODE it does nothing.
+  * @param  pGNSSParser_Data The agent
+  * @param  msg The message type
+  * @retval GNSS_PARSER_ERROR if the stored sentence cannot be decoded, GNSS_PARSER_OK otherwise
+  */
+GNSSParser_Status_t GNSS_PARSER_Decode(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg);
+
 /**
   * @}
   */
@@ -16,7 +16,6 @@
   ******************************************************************************
   */
 /* Includes ------------------------------------------------------------------*/
-#include <math.h>
 #include <string.h>
 
 #include "gnss_data.h"
@@ -26,8 +25,6 @@
 #include "gnss_geofence.h"
 #include "gnss_lib_config.h"
 
-#include "teseo_liv3f_conf.h"
-
 /* Private defines -----------------------------------------------------------*/
 #define MSG_SZ (256)
 #define CMD_SZ (90)
@@ -41,19 +38,465 @@ static uint8_t gnssCmd[CMD_SZ];
 
 /* Private functions ---------------------------------------------------------*/
 
+/* Prints "pLabel[ hh:mm:ss ]\n\r" */
+static void GNSS_DATA_PrintUtc(const char *pLabel, const UTC_Info_t *pUtc)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, pLabel);
+  GNSS_DATA_FmtStr(&fmt, "[ ");
+  GNSS_DATA_FmtUtc(&fmt, pUtc);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+  PRINT_INFO((char *)msg);
+}
+
+/* Prints "pLabel[ <val> pEnd" with val as a zero padded integer */
+static void GNSS_DATA_PrintInt(const char *pLabel, int32_t val, uint8_t width, const char *pEnd)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, pLabel);
+  GNSS_DATA_FmtStr(&fmt, "[ ");
+  GNSS_DATA_FmtInt(&fmt, val, width);
+  GNSS_DATA_FmtStr(&fmt, pEnd);
+  PRINT_INFO((char *)msg);
+}
+
+/* Prints "pLabel[ <val> ]\n\r" with val in fixed-point notation */
+static void GNSS_DATA_PrintFixed(const char *pLabel, float64_t val, uint8_t decimals)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, pLabel);
+  GNSS_DATA_FmtStr(&fmt, "[ ");
+  GNSS_DATA_FmtFixed(&fmt, val, decimals);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+  PRINT_INFO((char *)msg);
+}
+
+/* Prints "pLabel[ <deg>' <min>'' <sec>\" <hemi> ]\n\r" */
+static void GNSS_DATA_PrintCoord(const char *pLabel, float64_t coord, uint8_t hemi, uint8_t min_width)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, pLabel);
+  GNSS_DATA_FmtStr(&fmt, "[ ");
+  GNSS_DATA_FmtCoord(&fmt, coord, hemi, min_width);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+  PRINT_INFO((char *)msg);
+}
+
+/* Prints "pLabel[ <str> pEnd" */
+static void GNSS_DATA_PrintStr(const char *pLabel, const char *pStr, const char *pEnd)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, pLabel);
+  GNSS_DATA_FmtStr(&fmt, "[ ");
+  GNSS_DATA_FmtStr(&fmt, pStr);
+  GNSS_DATA_FmtStr(&fmt, pEnd);
+  PRINT_INFO((char *)msg);
+}
+
+/* Puts to console the fields of a GPGGA sentence */
+static void GNSS_DATA_PrintGPGGA(const GPGGA_Info_t *pGPGGAInfo, const char *pAccLabel)
+{
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_PrintUtc("UTC:\t\t\t", &pGPGGAInfo->utc);
+  GNSS_DATA_PrintCoord("Latitude:\t\t", pGPGGAInfo->xyz.lat, pGPGGAInfo->xyz.ns, 1U);
+  GNSS_DATA_PrintCoord("Longitude:\t\t", pGPGGAInfo->xyz.lon, pGPGGAInfo->xyz.ew, 1U);
+  GNSS_DATA_PrintInt("Satellites locked:\t", pGPGGAInfo->sats, 1U, " ]\n\r");
+  GNSS_DATA_PrintFixed(pAccLabel, pGPGGAInfo->acc, 1U);
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Altitude:\t\t[ ");
+  GNSS_DATA_FmtFixed(&fmt, pGPGGAInfo->xyz.alt, 2U);
+  GNSS_DATA_FmtChar(&fmt, (char)(pGPGGAInfo->xyz.mis + 32U));
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+  PRINT_INFO((char *)msg);
+
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Geoid infos:\t\t[ ");
+  GNSS_DATA_FmtInt(&fmt, pGPGGAInfo->geoid.height, 1U);
+  GNSS_DATA_FmtChar(&fmt, (char)pGPGGAInfo->geoid.mis);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+  PRINT_INFO((char *)msg);
+
+  GNSS_DATA_PrintInt("Diff update:\t\t", pGPGGAInfo->update, 1U, " ]\n\r");
+}
+
 /* Public functions ----------------------------------------------------------*/
-int16_t minute_part(float64_t mod)
+
+/* Initializes a formatter on a caller-supplied buffer. */
+void GNSS_DATA_FmtInit(GNSS_DATA_Fmt_t *pFmt, char *pBuf, uint32_t size)
+{
+  pFmt->pBuf = pBuf;
+  pFmt->size = size;
+  pFmt->len = 0;
+  if (size != 0U)
+  {
+    pBuf[0] = '\0';
+  }
+}
+
+/* Appends a character; the output is truncated when the buffer is full. */
+void GNSS_DATA_FmtChar(GNSS_DATA_Fmt_t *pFmt, char c)
+{
+  if ((pFmt->len + 1U) < pFmt->size)
+  {
+    pFmt->pBuf[pFmt->len] = c;
+    pFmt->len++;
+    pFmt->pBuf[pFmt->len] = '\0';
+  }
+}
+
+/* Appends a string. */
+void GNSS_DATA_FmtStr(GNSS_DATA_Fmt_t *pFmt, const char *pStr)
+{
+  while (*pStr != '\0')
+  {
+    GNSS_DATA_FmtChar(pFmt, *pStr);
+    pStr++;
+  }
+}
+
+/* Appends an unsigned integer, zero padded to 'width' digits. */
+void GNSS_DATA_FmtUint(GNSS_DATA_Fmt_t *pFmt, uint32_t val, uint8_t width)
 {
-  int16_t minute_whole_part;
-  minute_whole_part = (int16_t) mod;
-  return minute_whole_part;
+  char digits[10];
+  uint8_t n = 0;
+
+  do
+  {
+    digits[n] = (char)('0' + (val % 10U));
+    val /= 10U;
+    n++;
+  } while (val != 0U);
+
+  while (width > n)
+  {
+    GNSS_DATA_FmtChar(pFmt, '0');
+    width--;
+  }
+  while (n > 0U)
+  {
+    n--;
+    GNSS_DATA_FmtChar(pFmt, digits[n]);
+  }
+}
+
+/* Appends a signed integer, zero padded to 'width' characters (sign included) as "%0*d" does. */
+void GNSS_DATA_FmtInt(GNSS_DATA_Fmt_t *pFmt, int32_t val, uint8_t width)
+{
+  if (val < 0)
+  {
+    GNSS_DATA_FmtChar(pFmt, '-');
+    GNSS_DATA_FmtUint(pFmt, (uint32_t)(-(val + 1)) + 1U, (width > 1U) ? (width - 1U) : 1U);
+  }
+  else
+  {
+    GNSS_DATA_FmtUint(pFmt, (uint32_t)val, width);
+  }
+}
+
+/* Appends a real number with 'decimals' (0 to 9) digits after the point, rounded as "%.*f" does.
+ * The integer and the fractional parts are converted separately so that no 64-bit
+ * arithmetic and no printf float support are needed.
+ */
+void GNSS_DATA_FmtFixed(GNSS_DATA_Fmt_t *pFmt, float64_t val, uint8_t decimals)
+{
+  static const uint32_t pow10[] =
+  {
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+  };
+  uint32_t ipart;
+  uint32_t fpart;
+
+  if (decimals > 9U)
+  {
+    decimals = 9U;
+  }
+  if (val < 0.0)
+  {
+    val = -val;
+    GNSS_DATA_FmtChar(pFmt, '-');
+  }
+  if (val >= 4294967295.0)
+  {
+    val = 4294967295.0;
+  }
+
+  ipart = (uint32_t)val;
+  fpart = (uint32_t)(((val - (float64_t)ipart) * (float64_t)pow10[decimals]) + 0.5);
+  if (fpart >= pow10[decimals])
+  {
+    ipart++;
+    fpart -= pow10[decimals];
+  }
+
+  GNSS_DATA_FmtUint(pFmt, ipart, 1U);
+  if (decimals > 0U)
+  {
+    GNSS_DATA_FmtChar(pFmt, '.');
+    GNSS_DATA_FmtUint(pFmt, fpart, decimals);
+  }
+}
+
+/* Appends an UTC time as hh:mm:ss. */
+void GNSS_DATA_FmtUtc(GNSS_DATA_Fmt_t *pFmt, const UTC_Info_t *pUtc)
+{
+  GNSS_DATA_FmtInt(pFmt, pUtc->hh, 2U);
+  GNSS_DATA_FmtChar(pFmt, ':');
+  GNSS_DATA_FmtInt(pFmt, pUtc->mm, 2U);
+  GNSS_DATA_FmtChar(pFmt, ':');
+  GNSS_DATA_FmtInt(pFmt, pUtc->ss, 2U);
+}
+
+/* Appends a NMEA (d)ddmm.mmmm coordinate as <deg>' <min>'' <sec>" <hemi>. */
+void GNSS_DATA_FmtCoord(GNSS_DATA_Fmt_t *pFmt, float64_t coord, uint8_t hemi, uint8_t min_width)
+{
+  int32_t deg = (int32_t)(coord / 100.0);
+  float64_t min = coord - ((float64_t)deg * 100.0);
+  int32_t imin = (int32_t)min;
+
+  GNSS_DATA_FmtInt(pFmt, deg, 1U);
+  GNSS_DATA_FmtStr(pFmt, "' ");
+  GNSS_DATA_FmtInt(pFmt, imin, min_width);
+  GNSS_DATA_FmtStr(pFmt, "'' ");
+  GNSS_DATA_FmtFixed(pFmt, (min - (float64_t)imin) * 60.0, 6U);
+  GNSS_DATA_FmtStr(pFmt, "\" ");
+  GNSS_DATA_FmtChar(pFmt, (char)hemi);
+}
+
+/* Renders the last GGA fix as a single CSV line. */
+int32_t GNSS_DATA_FormatFix(GNSSParser_Data_t *pGNSSParser_Data, char *pBuf, uint32_t size)
+{
+  const GPGGA_Info_t *gga = &pGNSSParser_Data->gpgga_data;
+  GNSS_DATA_Fmt_t fmt;
+  int32_t deg;
+  float64_t lat;
+  float64_t lon;
+
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPGGA);
+
+  deg = (int32_t)(gga->xyz.lat / 100.0);
+  lat = (float64_t)deg + ((gga->xyz.lat - ((float64_t)deg * 100.0)) / 60.0);
+  deg = (int32_t)(gga->xyz.lon / 100.0);
+  lon = (float64_t)deg + ((gga->xyz.lon - ((float64_t)deg * 100.0)) / 60.0);
+
+  GNSS_DATA_FmtInit(&fmt, pBuf, size);
+  GNSS_DATA_FmtUtc(&fmt, &gga->utc);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, (gga->xyz.ns == (uint8_t)'S') ? -lat : lat, 7U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, (gga->xyz.ew == (uint8_t)'W') ? -lon : lon, 7U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, gga->xyz.alt, 2U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtInt(&fmt, gga->sats, 1U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, gga->acc, 1U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtInt(&fmt, gga->valid, 1U);
+  GNSS_DATA_FmtStr(&fmt, "\r\n");
+
+  return (int32_t)fmt.len;
+}
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+/* Stores a 16-bit value, little endian. */
+static uint8_t *GNSS_DATA_Put16(uint8_t *pDst, uint32_t val)
+{
+  pDst[0] = (uint8_t)val;
+  pDst[1] = (uint8_t)(val >> 8);
+  return &pDst[2];
+}
+
+/* Stores a 32-bit value, little endian. */
+static uint8_t *GNSS_DATA_Put32(uint8_t *pDst, uint32_t val)
+{
+  pDst[0] = (uint8_t)val;
+  pDst[1] = (uint8_t)(val >> 8);
+  pDst[2] = (uint8_t)(val >> 16);
+  pDst[3] = (uint8_t)(val >> 24);
+  return &pDst[4];
+}
+
+/* Scales a non negative quantity to an unsigned 16-bit fixed-point value (saturated). */
+static uint32_t GNSS_DATA_ScaleU16(float64_t val, float64_t scale)
+{
+  float64_t x = (val * scale) + 0.5;
+
+  if (!(x > 0.0))
+  {
+    return 0U;
+  }
+  return (x >= 65535.0) ? 0xFFFFU : (uint32_t)x;
+}
+
+/* Converts a NMEA (d)ddmm.mmmm coordinate to signed 1e-7 degrees. */
+static int32_t GNSS_DATA_CoordE7(float64_t coord, uint8_t hemi)
+{
+  int32_t deg = (int32_t)(coord / 100.0);
+  float64_t e7 = (((float64_t)deg + ((coord - ((float64_t)deg * 100.0)) / 60.0)) * 1e7) + 0.5;
+  int32_t val = (int32_t)e7;
+
+  return ((hemi == (uint8_t)'S') || (hemi == (uint8_t)'W')) ? -val : val;
+}
+
+/* Converts a GNSS time to the UTC time of day (s) and date (day, month, year-2000).
+ * Returns -1 if the time is not known.
+ */
+static int32_t GNSS_DATA_ToUtc(GNSS_Time_t time, uint32_t *pTod, uint8_t *pDate)
+{
+  GNSS_Time_t utc_ms;
+  int32_t days;
+  int32_t era;
+  int32_t doe;
+  int32_t yoe;
+  int32_t doy;
+  int32_t mp;
+  int32_t year;
+  int32_t month;
+
+  if ((time == GNSS_TIME_INVALID) || (time < ((GNSS_Time_t)NMEA_GPS_LEAP_SECONDS * 1000ULL)))
+  {
+    return -1;
+  }
+  utc_ms = time - ((GNSS_Time_t)NMEA_GPS_LEAP_SECONDS * 1000ULL);
+  *pTod = (uint32_t)((utc_ms % 86400000ULL) / 1000ULL);
+
+  /* Civil date of the days from 1970-01-01 (GPS epoch is day 3657), March based year */
+  days = (int32_t)(utc_ms / 86400000ULL) + 3657 + 719468;
+  era = days / 146097;
+  doe = days - (era * 146097);
+  yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+  doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+  mp = ((5 * doy) + 2) / 153;
+  month = (mp < 10) ? (mp + 3) : (mp - 9);
+  year = yoe + (era * 400) + ((month <= 2) ? 1 : 0);
+
+  pDate[0] = (uint8_t)(doy - (((153 * mp) + 2) / 5) + 1);
+  pDate[1] = (uint8_t)month;
+  pDate[2] = (uint8_t)(year % 100);
+
+  return 0;
+}
+
+/* CRC16-CCITT (polynomial 0x1021, no reflection). */
+static uint16_t GNSS_DATA_Crc16(uint16_t crc, const uint8_t *pData, uint32_t len)
+{
+  uint32_t i;
+  uint8_t b;
+
+  for (i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t)((uint16_t)pData[i] << 8);
+    for (b = 0; b < 8U; b++)
+    {
+      crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* Encodes the last parsed epoch as a GNSS_DATA_EPOCH_VERSION binary record. */
+int32_t GNSS_DATA_EncodeEpoch(GNSSParser_Data_t *pGNSSParser_Data, uint8_t *pBuf, uint32_t size)
+{
+  const GPGGA_Info_t *gga = &pGNSSParser_Data->gpgga_data;
+  const GPRMC_Info_t *rmc = &pGNSSParser_Data->gprmc_data;
+  const GSA_Info_t *gsa = &pGNSSParser_Data->gsa_data;
+  const GNSSParser_Sats_t *sats = &pGNSSParser_Data->sats;
+  uint8_t *p = &pBuf[GNSS_DATA_EPOCH_HDR_SIZE];
+  uint8_t date[3];
+  uint32_t tod;
+  uint32_t len;
+  uint32_t cn0;
+  uint16_t crc;
+  uint32_t i;
+  uint32_t j;
+
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPRMC);
+
+  if (size < GNSS_DATA_EPOCH_MAX_SIZE)
+  {
+    return -1;
+  }
+
+  /* Date and time of day both come from the GNSS time of the GGA sentence: around
+   * midnight the date of the latest RMC sentence may belong to the previous day
+   */
+  if (GNSS_DATA_ToUtc(GNSS_PARSER_GetTime(pGNSSParser_Data, GPGGA), &tod, date) != 0)
+  {
+    return -1;
+  }
+  p = GNSS_DATA_Put32(p, tod);
+  *p++ = date[0];
+  *p++ = date[1];
+  *p++ = date[2];
+  *p++ = gga->valid;
+  p = GNSS_DATA_Put32(p, (uint32_t)GNSS_DATA_CoordE7(gga->xyz.lat, gga->xyz.ns));
+  p = GNSS_DATA_Put32(p, (uint32_t)GNSS_DATA_CoordE7(gga->xyz.lon, gga->xyz.ew));
+  p = GNSS_DATA_Put32(p, (uint32_t)(int32_t)((gga->xyz.alt * 100.0) + ((gga->xyz.alt < 0.0) ? -0.5 : 0.5)));
+  /* 1 knot = 51.4444 cm/s */
+  p = GNSS_DATA_Put16(p, GNSS_DATA_ScaleU16((float64_t)rmc->speed, 51.4444));
+  p = GNSS_DATA_Put16(p, GNSS_DATA_ScaleU16((float64_t)rmc->trackgood, 100.0));
+  p = GNSS_DATA_Put16(p, GNSS_DATA_ScaleU16((float64_t)gsa->pdop, 100.0));
+  p = GNSS_DATA_Put16(p, GNSS_DATA_ScaleU16((float64_t)gsa->hdop, 100.0));
+  p = GNSS_DATA_Put16(p, GNSS_DATA_ScaleU16((float64_t)gsa->vdop, 100.0));
+  *p++ = (uint8_t)gsa->current_mode;
+  *p++ = (uint8_t)gga->sats;
+  *p++ = sats->tot_sats;
+  *p++ = sats->view_nbr;
+
+  /* Satellite summary: the satellites in view over all the GSV sentences of the epoch,
+   * flagged when used in the fix by any of its GSA sentences
+   */
+  for (i = 0; i < (uint32_t)sats->view_nbr; i++)
+  {
+    cn0 = (sats->view_cn0[i] > 0x7F) ? 0x7FU : (uint32_t)sats->view_cn0[i];
+    for (j = 0; j < (uint32_t)sats->used_nbr; j++)
+    {
+      if (sats->used_prn[j] == sats->view_prn[i])
+      {
+        cn0 |= 0x80U;
+        break;
+      }
+    }
+    p = GNSS_DATA_Put16(p, (uint32_t)sats->view_prn[i]);
+    *p++ = (uint8_t)cn0;
+  }
+
+  len = (uint32_t)(p - &pBuf[GNSS_DATA_EPOCH_HDR_SIZE]);
+  pBuf[0] = GNSS_DATA_EPOCH_SYNC1;
+  pBuf[1] = GNSS_DATA_EPOCH_SYNC2;
+  pBuf[2] = GNSS_DATA_EPOCH_VERSION;
+  pBuf[3] = (uint8_t)len;
+  crc = GNSS_DATA_Crc16(0xFFFFU, &pBuf[2], len + 2U);
+  (void)GNSS_DATA_Put16(p, crc);
+
+  return (int32_t)(GNSS_DATA_EPOCH_HDR_SIZE + len + 2U);
 }
-float64_t seconds(float64_t mod, int16_t minute)
+
+/* Sends the binary record of the last parsed epoch. */
+void GNSS_DATA_SendEpoch(GNSSParser_Data_t *pGNSSParser_Data)
 {
-  float64_t seconds;
-  seconds = (mod - minute) * 60.0;
-  return seconds;
+  uint8_t rec[GNSS_DATA_EPOCH_MAX_SIZE];
+  int32_t len = GNSS_DATA_EncodeEpoch(pGNSSParser_Data, rec, sizeof(rec));
+
+  if (len > 0)
+  {
+    PRINT_BIN(rec, (uint32_t)len);
+  }
 }
+#endif /* CONFIG_USE_EPOCH_BIN */
+
 /* Sends a command to the GNSS module. */
 void GNSS_DATA_SendCommand(uint8_t *pCommand)
 {
@@ -76,59 +519,15 @@ void GNSS_DATA_SendCommand(uint8_t *pCommand)
 /* Puts to console data of correctly parsed GPGGA sentence */
 void GNSS_DATA_GetValidInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPGGA);
 
   if (pGNSSParser_Data->gpgga_data.valid > INVALID)
   {
-    float64_t lat_mod = fmod(pGNSSParser_Data->gpgga_data.xyz.lat, 100.0);
-    float64_t lon_mod = fmod(pGNSSParser_Data->gpgga_data.xyz.lon, 100.0);
-
-    (void)snprintf((char *)msg, MSG_SZ, "UTC:\t\t\t[ %02d:%02d:%02d ]\n\r",
-                   pGNSSParser_Data->gpgga_data.utc.hh,
-                   pGNSSParser_Data->gpgga_data.utc.mm,
-                   pGNSSParser_Data->gpgga_data.utc.ss);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Latitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                   (pGNSSParser_Data->gpgga_data.xyz.lat - lat_mod) / 100.0,
-                   minute_part(lat_mod),
-                   seconds(lat_mod, minute_part(lat_mod)),
-                   pGNSSParser_Data->gpgga_data.xyz.ns);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Longitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                   (pGNSSParser_Data->gpgga_data.xyz.lon - lon_mod) / 100.0,
-                   minute_part(lon_mod),
-                   seconds(lon_mod, minute_part(lon_mod)),
-                   pGNSSParser_Data->gpgga_data.xyz.ew);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Satellites locked:\t[ %d ]\n\r",
-                   pGNSSParser_Data->gpgga_data.sats);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "HDOP:\t\t\t[ %.1f ]\n\r",
-                   pGNSSParser_Data->gpgga_data.acc);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Altitude:\t\t[ %.2f%c ]\n\r",
-                   pGNSSParser_Data->gpgga_data.xyz.alt,
-                   (pGNSSParser_Data->gpgga_data.xyz.mis + 32U));
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Geoid infos:\t\t[ %d%c ]\n\r",
-                   pGNSSParser_Data->gpgga_data.geoid.height,
-                   pGNSSParser_Data->gpgga_data.geoid.mis);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Diff update:\t\t[ %d ]\n\r",
-                   pGNSSParser_Data->gpgga_data.update);
-    PRINT_INFO((char *)msg);
-
+    GNSS_DATA_PrintGPGGA(&pGNSSParser_Data->gpgga_data, "HDOP:\t\t\t");
   }
   else
   {
-    (void)snprintf((char *)msg, MSG_SZ,  "Last position wasn't valid.\n\n\r");
-    PRINT_INFO((char *)msg);
+    PRINT_INFO("Last position wasn't valid.\n\n\r");
   }
 
   PRINT_INFO("\n\n\r>");
@@ -138,8 +537,11 @@ void GNSS_DATA_GetValidInfo(GNSSParser_Data_t *pGNSSParser_Data)
 int32_t GNSS_DATA_TrackGotPos(GNSSParser_Data_t *pGNSSParser_Data, uint32_t how_many, uint32_t time)
 {
   int32_t tracked = 0;
+  GNSS_DATA_Fmt_t fmt;
+
   for (uint16_t i = 0; i < (uint16_t)how_many; i++)
   {
+    (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPGGA);
     if (pGNSSParser_Data->gpgga_data.valid == INVALID)
     {
       break;
@@ -147,57 +549,17 @@ int32_t GNSS_DATA_TrackGotPos(GNSSParser_Data_t *pGNSSParser_Data, uint32_t how_
 
     tracked++;
 
-    (void)snprintf((char *)msg, MSG_SZ,  "Position %d just get.\r\n", i + 1U);
+    GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+    GNSS_DATA_FmtStr(&fmt, "Position ");
+    GNSS_DATA_FmtUint(&fmt, i + 1U, 1U);
+    GNSS_DATA_FmtStr(&fmt, " just get.\r\n");
 
     PRINT_INFO((char *)msg);
     if (pGNSSParser_Data->debug == DEBUG_ON)
     {
-      float64_t lat_mod = fmod(pGNSSParser_Data->gpgga_data.xyz.lat, 100.0);
-      float64_t lon_mod = fmod(pGNSSParser_Data->gpgga_data.xyz.lon, 100.0);
-
       PRINT_INFO("Debug ON.\r\n");
 
-      (void)snprintf((char *)msg, MSG_SZ,  "UTC:\t\t\t[ %02d:%02d:%02d ]\n\r",
-                     pGNSSParser_Data->gpgga_data.utc.hh,
-                     pGNSSParser_Data->gpgga_data.utc.mm,
-                     pGNSSParser_Data->gpgga_data.utc.ss);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Latitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                     (pGNSSParser_Data->gpgga_data.xyz.lat - lat_mod) / 100.0,
-                     minute_part(lat_mod),
-                     seconds(lat_mod, minute_part(lat_mod)),
-                     pGNSSParser_Data->gpgga_data.xyz.ns);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Longitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                     (pGNSSParser_Data->gpgga_data.xyz.lon - lon_mod) / 100.0,
-                     minute_part(lon_mod),
-                     seconds(lon_mod, minute_part(lon_mod)),
-                     pGNSSParser_Data->gpgga_data.xyz.ew);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Satellites locked:\t[ %d ]\n\r",
-                     pGNSSParser_Data->gpgga_data.sats);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "HDOP:\t\t\t[ %.1f ]\n\r",
-                     pGNSSParser_Data->gpgga_data.acc);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Altitude:\t\t[ %.2f%c ]\n\r",
-                     pGNSSParser_Data->gpgga_data.xyz.alt,
-                     (pGNSSParser_Data->gpgga_data.xyz.mis + 32U));
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Geoid infos:\t\t[ %d%c ]\n\r",
-                     pGNSSParser_Data->gpgga_data.geoid.height,
-                     pGNSSParser_Data->gpgga_data.geoid.mis);
-      PRINT_INFO((char *)msg);
-
-      (void)snprintf((char *)msg, MSG_SZ, "Diff update:\t\t[ %d ]\n\r",
-                     pGNSSParser_Data->gpgga_data.update);
-      PRINT_INFO((char *)msg);
+      GNSS_DATA_PrintGPGGA(&pGNSSParser_Data->gpgga_data, "HDOP:\t\t\t");
 
       PRINT_INFO("\n\n\r");
     }
@@ -213,53 +575,17 @@ int32_t GNSS_DATA_TrackGotPos(GNSSParser_Data_t *pGNSSParser_Data, uint32_t how_
 /*  Puts to console all the position got by a tracking position process */
 void GNSS_DATA_PrintTrackedPositions(uint32_t how_many)
 {
+  GNSS_DATA_Fmt_t fmt;
+
   for (uint16_t i = 0; i < (uint16_t)how_many; i++)
   {
-    float64_t lat_mod = fmod(stored_positions[i].xyz.lat, 100.0);
-    float64_t lon_mod = fmod(stored_positions[i].xyz.lon, 100.0);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Position n. %d:\r\n", i + 1U);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "UTC:\t\t\t[ %02d:%02d:%02d ]\n\r",
-                   stored_positions[i].utc.hh, stored_positions[i].utc.mm, stored_positions[i].utc.ss);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Latitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                   (stored_positions[i].xyz.lat - lat_mod) / 100.0,
-                   minute_part(lat_mod),
-                   seconds(lat_mod, minute_part(lat_mod)),
-                   stored_positions[i].xyz.ns);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Longitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                   (stored_positions[i].xyz.lon - lon_mod) / 100.0,
-                   minute_part(lon_mod),
-                   seconds(lon_mod, minute_part(lon_mod)),
-                   stored_positions[i].xyz.ew);
+    GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+    GNSS_DATA_FmtStr(&fmt, "Position n. ");
+    GNSS_DATA_FmtUint(&fmt, i + 1U, 1U);
+    GNSS_DATA_FmtStr(&fmt, ":\r\n");
     PRINT_INFO((char *)msg);
 
-    (void)snprintf((char *)msg, MSG_SZ,  "Satellites locked:\t[ %d ]\n\r",
-                   stored_positions[i].sats);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Position accuracy:\t[ %.1f ]\n\r",
-                   stored_positions[i].acc);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Altitude:\t\t[ %.2f%c ]\n\r",
-                   stored_positions[i].xyz.alt,
-                   (stored_positions[i].xyz.mis + 32U));
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Geoid infos:\t\t[ %d%c ]\n\r",
-                   stored_positions[i].geoid.height,
-                   stored_positions[i].geoid.mis);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ,  "Diff update:\t\t[ %d ]\n\r",
-                   stored_positions[i].update);
-    PRINT_INFO((char *)msg);
+    GNSS_DATA_PrintGPGGA(&stored_positions[i], "Position accuracy:\t");
 
     PRINT_INFO("\r\n\n>");
   }
@@ -268,11 +594,10 @@ void GNSS_DATA_PrintTrackedPositions(uint32_t how_many)
 /* Puts to console the info about Fix data for single or combined satellite navigation system. */
 void GNSS_DATA_GetGNSInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GNS);
   PRINT_INFO("\r\n");
 
-  (void)snprintf((char *)msg, MSG_SZ,  "Constellation:\t\t[ %s ]\n\r",
-                 pGNSSParser_Data->gns_data.constellation);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintStr("Constellation:\t\t", (char *)pGNSSParser_Data->gns_data.constellation, " ]\n\r");
 
   if (strcmp((char *)pGNSSParser_Data->gns_data.constellation, "$GPGNS") == 0)
   {
@@ -303,42 +628,13 @@ void GNSS_DATA_GetGNSInfo(GNSSParser_Data_t *pGNSSParser_Data)
     /* nothing to do */
   }
 
-  float64_t lat_mod = fmod(pGNSSParser_Data->gns_data.xyz.lat, 100.0);
-  float64_t lon_mod = fmod(pGNSSParser_Data->gns_data.xyz.lon, 100.0);
-  (void)snprintf((char *)msg, MSG_SZ,  "UTC:\t\t\t[ %02d:%02d:%02d ]\n\r",
-                 pGNSSParser_Data->gns_data.utc.hh,
-                 pGNSSParser_Data->gns_data.utc.mm,
-                 pGNSSParser_Data->gns_data.utc.ss);
-  PRINT_INFO((char *)msg);
-  (void)snprintf((char *)msg, MSG_SZ, "Latitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                 (pGNSSParser_Data->gns_data.xyz.lat - lat_mod) / 100.0,
-                 minute_part(lat_mod),
-                 seconds(lat_mod, minute_part(lat_mod)),
-                 pGNSSParser_Data->gns_data.xyz.ns);
-
-  PRINT_INFO((char *)msg);
-  (void)snprintf((char *)msg, MSG_SZ, "Longitude:\t\t[ %.0f' %d'' %f\" %c ]\n\r",
-                 (pGNSSParser_Data->gns_data.xyz.lon - lon_mod) / 100.0,
-                 minute_part(lon_mod),
-                 seconds(lon_mod, minute_part(lon_mod)),
-                 pGNSSParser_Data->gns_data.xyz.ew);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Satellites locked:\t[ %d ]\n\r",
-                 pGNSSParser_Data->gns_data.sats);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "HDOP:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gns_data.hdop);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Altitude:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gns_data.xyz.alt);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Geoid infos:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gns_data.geo_sep);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintUtc("UTC:\t\t\t", &pGNSSParser_Data->gns_data.utc);
+  GNSS_DATA_PrintCoord("Latitude:\t\t", pGNSSParser_Data->gns_data.xyz.lat, pGNSSParser_Data->gns_data.xyz.ns, 1U);
+  GNSS_DATA_PrintCoord("Longitude:\t\t", pGNSSParser_Data->gns_data.xyz.lon, pGNSSParser_Data->gns_data.xyz.ew, 1U);
+  GNSS_DATA_PrintInt("Satellites locked:\t", pGNSSParser_Data->gns_data.sats, 1U, " ]\n\r");
+  GNSS_DATA_PrintFixed("HDOP:\t\t\t", pGNSSParser_Data->gns_data.hdop, 1U);
+  GNSS_DATA_PrintFixed("Altitude:\t\t", pGNSSParser_Data->gns_data.xyz.alt, 1U);
+  GNSS_DATA_PrintFixed("Geoid infos:\t\t", pGNSSParser_Data->gns_data.geo_sep, 1U);
 
   PRINT_INFO("\n\n\r>");
 }
@@ -347,41 +643,17 @@ void GNSS_DATA_GetGNSInfo(GNSSParser_Data_t *pGNSSParser_Data)
 /* Puts to console the info about GPS Pseudorange Noise Statistics */
 void GNSS_DATA_GetGPGSTInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPGST);
   PRINT_INFO("\r\n");
 
-  (void)snprintf((char *)msg, MSG_SZ,  "UTC:\t\t\t[ %02d:%02d:%02d ]\n\r",
-                 pGNSSParser_Data->gpgst_data.utc.hh,
-                 pGNSSParser_Data->gpgst_data.utc.mm,
-                 pGNSSParser_Data->gpgst_data.utc.ss);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "EHPE:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.EHPE);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Semi-major Dev:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.semi_major_dev);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Semi-minor Dev:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.semi_minor_dev);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Semi-maior Angle:\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.semi_major_angle);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Lat Err Dev:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.lat_err_dev);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Lon Err Dev:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.lon_err_dev);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Alt Err Dev:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gpgst_data.alt_err_dev);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintUtc("UTC:\t\t\t", &pGNSSParser_Data->gpgst_data.utc);
+  GNSS_DATA_PrintFixed("EHPE:\t\t\t", pGNSSParser_Data->gpgst_data.EHPE, 1U);
+  GNSS_DATA_PrintFixed("Semi-major Dev:\t\t", pGNSSParser_Data->gpgst_data.semi_major_dev, 1U);
+  GNSS_DATA_PrintFixed("Semi-minor Dev:\t\t", pGNSSParser_Data->gpgst_data.semi_minor_dev, 1U);
+  GNSS_DATA_PrintFixed("Semi-maior Angle:\t", pGNSSParser_Data->gpgst_data.semi_major_angle, 1U);
+  GNSS_DATA_PrintFixed("Lat Err Dev:\t\t", pGNSSParser_Data->gpgst_data.lat_err_dev, 1U);
+  GNSS_DATA_PrintFixed("Lon Err Dev:\t\t", pGNSSParser_Data->gpgst_data.lon_err_dev, 1U);
+  GNSS_DATA_PrintFixed("Alt Err Dev:\t\t", pGNSSParser_Data->gpgst_data.alt_err_dev, 1U);
 
   PRINT_INFO("\n\n\r>");
 
@@ -391,16 +663,20 @@ void GNSS_DATA_GetGPGSTInfo(GNSSParser_Data_t *pGNSSParser_Data)
 /* Puts to console the info about Recommended Minimum Specific GPS/Transit data got by the most recent reception process. */
 void GNSS_DATA_GetGPRMCInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
+  GNSS_DATA_Fmt_t fmt;
+  int32_t date;
+
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPRMC);
+  date = pGNSSParser_Data->gprmc_data.date;
+
   PRINT_INFO("\r\n");
 
-  (void)snprintf((char *)msg, MSG_SZ,  "UTC:\t\t\t\t[ %02d:%02d:%02d ]\n\r",
-                 pGNSSParser_Data->gprmc_data.utc.hh,
-                 pGNSSParser_Data->gprmc_data.utc.mm,
-                 pGNSSParser_Data->gprmc_data.utc.ss);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintUtc("UTC:\t\t\t\t", &pGNSSParser_Data->gprmc_data.utc);
 
-  (void)snprintf((char *)msg, MSG_SZ, "Status:\t\t\t\t[ %c ]\t\t",
-                 pGNSSParser_Data->gprmc_data.status);
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Status:\t\t\t\t[ ");
+  GNSS_DATA_FmtChar(&fmt, (char)pGNSSParser_Data->gprmc_data.status);
+  GNSS_DATA_FmtStr(&fmt, " ]\t\t");
   PRINT_INFO((char *)msg);
   if (pGNSSParser_Data->gprmc_data.status == (uint8_t)'A')
   {
@@ -415,55 +691,33 @@ void GNSS_DATA_GetGPRMCInfo(GNSSParser_Data_t *pGNSSParser_Data)
     PRINT_INFO("-- Unknown status\n\r");
   }
 
-  float64_t lat_mod = fmod(pGNSSParser_Data->gprmc_data.xyz.lat, 100.0);
-  float64_t lon_mod = fmod(pGNSSParser_Data->gprmc_data.xyz.lon, 100.0);
+  GNSS_DATA_PrintCoord("Latitude:\t\t\t", pGNSSParser_Data->gprmc_data.xyz.lat, pGNSSParser_Data->gprmc_data.xyz.ns, 2U);
+  GNSS_DATA_PrintCoord("Longitude:\t\t\t", pGNSSParser_Data->gprmc_data.xyz.lon, pGNSSParser_Data->gprmc_data.xyz.ew, 2U);
+  GNSS_DATA_PrintFixed("Speed over ground (knots):\t", pGNSSParser_Data->gprmc_data.speed, 1U);
+  GNSS_DATA_PrintFixed("Trackgood:\t\t\t", pGNSSParser_Data->gprmc_data.trackgood, 1U);
 
-  (void)snprintf((char *)msg, MSG_SZ, "Latitude:\t\t\t[ %.0f' %02d'' %f\" %c ]\n\r",
-                 (pGNSSParser_Data->gprmc_data.xyz.lat - lat_mod) / 100.0,
-                 minute_part(lat_mod),
-                 seconds(lat_mod, minute_part(lat_mod)),
-                 pGNSSParser_Data->gprmc_data.xyz.ns);
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Date (ddmmyy):\t\t\t[ ");
+  GNSS_DATA_FmtInt(&fmt, date / 10000, 2U);
+  GNSS_DATA_FmtInt(&fmt, (date / 100) % 100, 2U);
+  GNSS_DATA_FmtInt(&fmt, date % 100, 2U);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
   PRINT_INFO((char *)msg);
 
-  (void)snprintf((char *)msg, MSG_SZ, "Longitude:\t\t\t[ %.0f' %02d'' %f\" %c ]\n\r",
-                 (pGNSSParser_Data->gprmc_data.xyz.lon - lon_mod) / 100.0,
-                 minute_part(lon_mod),
-                 seconds(lon_mod, minute_part(lon_mod)),
-                 pGNSSParser_Data->gprmc_data.xyz.ew);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Speed over ground (knots):\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gprmc_data.speed);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Trackgood:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gprmc_data.trackgood);
-  PRINT_INFO((char *)msg);
-
-  /*
-    (void)snprintf((char *)msg, MSG_SZ, "Date (ddmmyy):\t\t\t[ %ld ]\n\r",
-                   pGNSSParser_Data->gprmc_data.date);
-  */ /* Replaced by the following implementation for compatibility with AC6 and gcc compilers */
-  (void)snprintf((char *)msg, MSG_SZ, "Date (ddmmyy):\t\t\t[ %02d%02d%02d ]\n\r",
-                 (int16_t)((pGNSSParser_Data->gprmc_data.date / 10000)),
-                 (int16_t)((pGNSSParser_Data->gprmc_data.date / 100) - (100 * (pGNSSParser_Data->gprmc_data.date / 10000))),
-                 (int16_t)(pGNSSParser_Data->gprmc_data.date - (100 * (pGNSSParser_Data->gprmc_data.date / 100))));
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "Magnetic Variation:\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gprmc_data.mag_var);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintFixed("Magnetic Variation:\t\t", pGNSSParser_Data->gprmc_data.mag_var, 1U);
 
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Magnetic Var. Direction:\t[ ");
   if ((pGNSSParser_Data->gprmc_data.mag_var_dir != (uint8_t)'E') &&
       (pGNSSParser_Data->gprmc_data.mag_var_dir != (uint8_t)'W'))
   {
-    (void)snprintf((char *)msg, MSG_SZ, "Magnetic Var. Direction:\t[ - ]\n\r");
+    GNSS_DATA_FmtChar(&fmt, '-');
   }
   else
   {
-    (void)snprintf((char *)msg, MSG_SZ, "Magnetic Var. Direction:\t[ %c ]\n\r",
-                   pGNSSParser_Data->gprmc_data.mag_var_dir);
+    GNSS_DATA_FmtChar(&fmt, (char)pGNSSParser_Data->gprmc_data.mag_var_dir);
   }
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
   PRINT_INFO((char *)msg);
 
   PRINT_INFO("\n\n\r>");
@@ -474,11 +728,13 @@ void GNSS_DATA_GetGPRMCInfo(GNSSParser_Data_t *pGNSSParser_Data)
 /* Puts to console the info about GSA satellites got by the most recent reception process. */
 void GNSS_DATA_GetGSAInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
+  GNSS_DATA_Fmt_t fmt;
+
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GSA);
+
   PRINT_INFO("\r\n");
 
-  (void)snprintf((char *)msg, MSG_SZ,  "Constellation:\t\t[ %s ]\t",
-                 pGNSSParser_Data->gsa_data.constellation);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintStr("Constellation:\t\t", (char *)pGNSSParser_Data->gsa_data.constellation, " ]\t");
 
   if (strcmp((char *)pGNSSParser_Data->gsa_data.constellation, "$GPGSA") == 0)
   {
@@ -505,8 +761,10 @@ void GNSS_DATA_GetGSAInfo(GNSSParser_Data_t *pGNSSParser_Data)
     /* nothing to do */
   }
 
-  (void)snprintf((char *)msg, MSG_SZ,  "Operating Mode:\t\t[ %c ]\t\t",
-                 pGNSSParser_Data->gsa_data.operating_mode);
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Operating Mode:\t\t[ ");
+  GNSS_DATA_FmtChar(&fmt, (char)pGNSSParser_Data->gsa_data.operating_mode);
+  GNSS_DATA_FmtStr(&fmt, " ]\t\t");
   PRINT_INFO((char *)msg);
 
   if (pGNSSParser_Data->gsa_data.operating_mode == (uint8_t)'A')
@@ -522,9 +780,7 @@ void GNSS_DATA_GetGSAInfo(GNSSParser_Data_t *pGNSSParser_Data)
     PRINT_INFO("-- Unknown op mode\n\r");
   }
 
-  (void)snprintf((char *)msg, MSG_SZ, "Current Mode:\t\t[ %d ]\t\t",
-                 pGNSSParser_Data->gsa_data.current_mode);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintInt("Current Mode:\t\t", pGNSSParser_Data->gsa_data.current_mode, 1U, " ]\t\t");
 
   if (pGNSSParser_Data->gsa_data.current_mode == 1)
   {
@@ -546,22 +802,18 @@ void GNSS_DATA_GetGSAInfo(GNSSParser_Data_t *pGNSSParser_Data)
   int16_t *sat_prn = (int16_t *)(pGNSSParser_Data->gsa_data.sat_prn);
   for (uint8_t i = 0; i < 12U; i++)
   {
-    (void)snprintf((char *)msg, MSG_SZ, "SatPRN%02d:\t\t[ %d ]\n\r", i + 1U,
-                   (*(&sat_prn[i])));
+    GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+    GNSS_DATA_FmtStr(&fmt, "SatPRN");
+    GNSS_DATA_FmtUint(&fmt, i + 1U, 2U);
+    GNSS_DATA_FmtStr(&fmt, ":\t\t[ ");
+    GNSS_DATA_FmtInt(&fmt, *(&sat_prn[i]), 1U);
+    GNSS_DATA_FmtStr(&fmt, " ]\n\r");
     PRINT_INFO((char *)msg);
   }
 
-  (void)snprintf((char *)msg, MSG_SZ, "PDOP:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gsa_data.pdop);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "HDOP:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gsa_data.hdop);
-  PRINT_INFO((char *)msg);
-
-  (void)snprintf((char *)msg, MSG_SZ, "VDOP:\t\t\t[ %.01f ]\n\r",
-                 pGNSSParser_Data->gsa_data.vdop);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintFixed("PDOP:\t\t\t", pGNSSParser_Data->gsa_data.pdop, 1U);
+  GNSS_DATA_PrintFixed("HDOP:\t\t\t", pGNSSParser_Data->gsa_data.hdop, 1U);
+  GNSS_DATA_PrintFixed("VDOP:\t\t\t", pGNSSParser_Data->gsa_data.vdop, 1U);
 
   PRINT_INFO("\n\n\r>");
 
@@ -572,18 +824,26 @@ void GNSS_DATA_GetGSAInfo(GNSSParser_Data_t *pGNSSParser_Data)
 void GNSS_DATA_GetGSVInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
   int16_t i;
-  int16_t tot_sats = pGNSSParser_Data->gsv_data.tot_sats;
-  int16_t current_sats = pGNSSParser_Data->gsv_data.current_sats;
-  int16_t amount = pGNSSParser_Data->gsv_data.amount;
-  int16_t number = pGNSSParser_Data->gsv_data.number;
+  int16_t tot_sats;
+  int16_t current_sats;
+  int16_t amount;
+  int16_t number;
+  GNSS_DATA_Fmt_t fmt;
+
+  char degree_ext_ASCII_char = (char)248;
+
+  /* Per-satellite rows: label suffix and value */
+  const char *sat_label[] = { "PRN:\t\t[ ", "Elev (", "Azim (", "CN0 (dB):\t\t[ " };
 
-  uint8_t degree_ext_ASCII_char = 248;
+  (void)GNSS_PARSER_Decode(pGNSSParser_Data, GSV);
+  tot_sats = pGNSSParser_Data->gsv_data.tot_sats;
+  current_sats = pGNSSParser_Data->gsv_data.current_sats;
+  amount = pGNSSParser_Data->gsv_data.amount;
+  number = pGNSSParser_Data->gsv_data.number;
 
   PRINT_INFO("\r\n");
 
-  (void)snprintf((char *)msg, MSG_SZ,  "Constellation:\t\t[ %s ]\t",
-                 pGNSSParser_Data->gsv_data.constellation);
-  PRINT_INFO((char *)msg);
+  GNSS_DATA_PrintStr("Constellation:\t\t", (char *)pGNSSParser_Data->gsv_data.constellation, " ]\t");
 
   if (strcmp((char *)pGNSSParser_Data->gsv_data.constellation, "$GPGSV") == 0)
   {
@@ -614,34 +874,44 @@ void GNSS_DATA_GetGSVInfo(GNSSParser_Data_t *pGNSSParser_Data)
     /* nothing to do */
   }
 
-  (void)snprintf((char *)msg, MSG_SZ, "GSV message:\t\t[ %d of %d ]\n\r", number, amount);
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "GSV message:\t\t[ ");
+  GNSS_DATA_FmtInt(&fmt, number, 1U);
+  GNSS_DATA_FmtStr(&fmt, " of ");
+  GNSS_DATA_FmtInt(&fmt, amount, 1U);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
   PRINT_INFO((char *)msg);
 
-  (void)snprintf((char *)msg, MSG_SZ, "Num of Satellites:\t[ %d of %d ]\n\r", pGNSSParser_Data->gsv_data.current_sats,
-                 tot_sats);
+  GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+  GNSS_DATA_FmtStr(&fmt, "Num of Satellites:\t[ ");
+  GNSS_DATA_FmtInt(&fmt, current_sats, 1U);
+  GNSS_DATA_FmtStr(&fmt, " of ");
+  GNSS_DATA_FmtInt(&fmt, tot_sats, 1U);
+  GNSS_DATA_FmtStr(&fmt, " ]\n\r");
   PRINT_INFO((char *)msg);
 
   PRINT_INFO("\n\r");
 
   for (i = 0; i < current_sats; i++)
   {
-    (void)snprintf((char *)msg, MSG_SZ, "Sat%02dPRN:\t\t[ %03d ]\n\r", i + 1 + ((number - 1)*GSV_MSG_SATS),
-                   pGNSSParser_Data->gsv_data.gsv_sat_i[i].prn);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Sat%02dElev (%c):\t\t[ %03d ]\n\r", i + 1 + ((number - 1)*GSV_MSG_SATS),
-                   degree_ext_ASCII_char,
-                   pGNSSParser_Data->gsv_data.gsv_sat_i[i].elev);
-    PRINT_INFO((char *)msg);
+    const GSV_SAT_Info_t *sat = &pGNSSParser_Data->gsv_data.gsv_sat_i[i];
+    int16_t val[] = { sat->prn, sat->elev, sat->azim, sat->cn0 };
 
-    (void)snprintf((char *)msg, MSG_SZ, "Sat%02dAzim (%c):\t\t[ %03d ]\n\r", i + 1 + ((number - 1)*GSV_MSG_SATS),
-                   degree_ext_ASCII_char,
-                   pGNSSParser_Data->gsv_data.gsv_sat_i[i].azim);
-    PRINT_INFO((char *)msg);
-
-    (void)snprintf((char *)msg, MSG_SZ, "Sat%02dCN0 (dB):\t\t[ %03d ]\n\r", i + 1 + ((number - 1)*GSV_MSG_SATS),
-                   pGNSSParser_Data->gsv_data.gsv_sat_i[i].cn0);
-    PRINT_INFO((char *)msg);
+    for (uint8_t f = 0; f < 4U; f++)
+    {
+      GNSS_DATA_FmtInit(&fmt, (char *)msg, MSG_SZ);
+      GNSS_DATA_FmtStr(&fmt, "Sat");
+      GNSS_DATA_FmtInt(&fmt, i + 1 + ((number - 1)*GSV_MSG_SATS), 2U);
+      GNSS_DATA_FmtStr(&fmt, sat_label[f]);
+      if ((f == 1U) || (f == 2U))
+      {
+        GNSS_DATA_FmtChar(&fmt, degree_ext_ASCII_char);
+        GNSS_DATA_FmtStr(&fmt, "):\t\t[ ");
+      }
+      GNSS_DATA_FmtInt(&fmt, val[f], 3U);
+      GNSS_DATA_FmtStr(&fmt, " ]\n\r");
+      PRINT_INFO((char *)msg);
+    }
 
     PRINT_INFO("\n\r");
   }
@@ -733,6 +1003,7 @@ void GNSS_DATA_GetPSTMGetParInfo(GNSSParser_Data_t *pGNSSParser_Data)
   PRINT_INFO("\r\n>");
 }
 
+#if (GNSS_PARSER_USE_GEOFENCE_DATA == 1)
 /* Puts to console the geofence infos each time an alarm is received. */
 void GNSS_DATA_GetGeofenceInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
@@ -821,7 +1092,9 @@ void GNSS_DATA_GetGeofenceInfo(GNSSParser_Data_t *pGNSSParser_Data)
 
   PRINT_INFO("\n\r>");
 }
+#endif /* GNSS_PARSER_USE_GEOFENCE_DATA */
 
+#if (GNSS_PARSER_USE_ODO_DATA == 1)
 /* Puts to console the info about Odometer. */
 void GNSS_DATA_GetOdometerInfo(const GNSSParser_Data_t *pGNSSParser_Data)
 {
@@ -877,7 +1150,9 @@ void GNSS_DATA_GetOdometerInfo(const GNSSParser_Data_t *pGNSSParser_Data)
 
   return;
 }
+#endif /* GNSS_PARSER_USE_ODO_DATA */
 
+#if (GNSS_PARSER_USE_DATALOG_DATA == 1)
 /* Puts to console the info about Datalog. */
 void GNSS_DATA_GetDatalogInfo(const GNSSParser_Data_t *pGNSSParser_Data)
 {
@@ -960,6 +1235,7 @@ void GNSS_DATA_GetDatalogInfo(const GNSSParser_Data_t *pGNSSParser_Data)
   PRINT_INFO("\n\r>");
 
 }
+#endif /* GNSS_PARSER_USE_DATALOG_DATA */
 
 /* Puts to console the confirmation of an updated message list. */
 void GNSS_DATA_GetMsglistAck(const GNSSParser_Data_t *pGNSSParser_Data)
@@ -1023,13 +1299,21 @@ void GNSS_DATA_EnableGeofence(int toggle)
 /* Configures Geofence */
 void GNSS_DATA_ConfigGeofence(void *gnss_geofence)
 {
-  (void)snprintf((char *)gnssCmd, CMD_SZ, "$PSTMGEOFENCECFG,%d,%d,%d,%lf,%lf,%lf",
-                 ((GNSSGeofence_t *)gnss_geofence)->id,
-                 ((GNSSGeofence_t *)gnss_geofence)->enabled,
-                 ((GNSSGeofence_t *)gnss_geofence)->tolerance,
-                 ((GNSSGeofence_t *)gnss_geofence)->lat,
-                 ((GNSSGeofence_t *)gnss_geofence)->lon,
-                 ((GNSSGeofence_t *)gnss_geofence)->radius);
+  GNSS_DATA_Fmt_t fmt;
+
+  GNSS_DATA_FmtInit(&fmt, (char *)gnssCmd, CMD_SZ);
+  GNSS_DATA_FmtStr(&fmt, "$PSTMGEOFENCECFG,");
+  GNSS_DATA_FmtInt(&fmt, ((GNSSGeofence_t *)gnss_geofence)->id, 1U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtInt(&fmt, ((GNSSGeofence_t *)gnss_geofence)->enabled, 1U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtInt(&fmt, ((GNSSGeofence_t *)gnss_geofence)->tolerance, 1U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, ((GNSSGeofence_t *)gnss_geofence)->lat, 6U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, ((GNSSGeofence_t *)gnss_geofence)->lon, 6U);
+  GNSS_DATA_FmtChar(&fmt, ',');
+  GNSS_DATA_FmtFixed(&fmt, ((GNSSGeofence_t *)gnss_geofence)->radius, 6U);
 
   GNSS_DATA_SendCommand(gnssCmd);
 }
@@ -1125,6 +1409,7 @@ void GNSS_DATA_PassGen(uint32_t gpsTime)
   GNSS_DATA_SendCommand(gnssCmd);
 }
 
+#if (GNSS_PARSER_USE_AGNSS_DATA == 1)
 /* Puts to console the info about Password generation for A-GNSS. */
 void GNSS_DATA_GetPSTMPassInfo(GNSSParser_Data_t *pGNSSParser_Data)
 {
@@ -1264,6 +1549,7 @@ void GNSS_DATA_GetPSTMAGPSInfo(const GNSSParser_Data_t *pGNSSParser_Data)
 
   return;
 }
+#endif /* GNSS_PARSER_USE_AGNSS_DATA */
 #endif /* ASSISTED_GNSS */
 
 __weak uint8_t GNSS_PRINT(char *pBuffer)
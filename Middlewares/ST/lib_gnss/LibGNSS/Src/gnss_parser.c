@@ -19,6 +19,32 @@
 #include <string.h>
 #include "gnss_parser.h"
 
+/* Private variables ---------------------------------------------------------*/
+#if (CONFIG_USE_LAZY_DECODE == 1)
+/* Sentence headers accepted by the NMEA parser of each lazily decoded message type, in eNMEAMsg order */
+static const char *const GNSS_PARSER_Headers[GNSS_PARSER_LAZY_NUM][7] =
+{
+  { "$GPGGA", "$GNGGA", NULL },                                  /* GPGGA */
+  { "$GPGNS", "$GAGNS", "$BDGNS", "$QZGNS", "$GNGNS", NULL },    /* GNS */
+  { "$GPGST", "$GNGST", NULL },                                  /* GPGST */
+  { "$GPRMC", "$GNRMC", NULL },                                  /* GPRMC */
+#if (CONFIG_USE_EPOCH_BIN == 0)
+  { "$GPGSA", "$GLGSA", "$GAGSA", "$BDGSA", "$GNGSA", NULL },    /* GSA */
+  { "$GPGSV", "$GLGSV", "$GAGSV", "$BDGSV", "$QZGSV", "$GNGSV", NULL } /* GSV */
+#endif /* CONFIG_USE_EPOCH_BIN */
+};
+#endif /* CONFIG_USE_LAZY_DECODE */
+
+/* Private function prototypes -----------------------------------------------*/
+static GNSSParser_Status_t GNSS_PARSER_Dispatch(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, uint8_t *pBuffer);
+static void GNSS_PARSER_StampTime(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, const UTC_Info_t *pUTC,
+                                  const uint8_t *pBuffer);
+#if (CONFIG_USE_EPOCH_BIN == 1)
+static void GNSS_PARSER_AddSats(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg);
+#endif /* CONFIG_USE_EPOCH_BIN */
+#if (CONFIG_USE_LAZY_DECODE == 1)
+static GNSSParser_Status_t GNSS_PARSER_Store(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, const uint8_t *pBuffer);
+#endif /* CONFIG_USE_LAZY_DECODE */
 
 /* Exported functions --------------------------------------------------------*/
 
@@ -47,12 +73,30 @@ GNSSParser_Status_t GNSS_PARSER_Init(GNSSParser_Data_t *pGNSSParser_Data)
     (void)memset((void *)(&pGNSSParser_Data->gsa_data), 0, sizeof(GSA_Info_t));
     (void)memset((void *)(&pGNSSParser_Data->gsv_data), 0, sizeof(GSV_Info_t));
     (void)memset((void *)(&pGNSSParser_Data->pstmver_data), 0, sizeof(PSTMVER_Info_t));
+#if (GNSS_PARSER_USE_AGNSS_DATA == 1)
     (void)memset((void *)(&pGNSSParser_Data->pstmpass_data), 0, sizeof(PSTMPASSRTN_Info_t));
     (void)memset((void *)(&pGNSSParser_Data->pstmagps_data), 0, sizeof(PSTMAGPS_Info_t));
+#endif /* GNSS_PARSER_USE_AGNSS_DATA */
+#if (GNSS_PARSER_USE_GEOFENCE_DATA == 1)
     (void)memset((void *)(&pGNSSParser_Data->geofence_data), 0, sizeof(Geofence_Info_t));
+#endif /* GNSS_PARSER_USE_GEOFENCE_DATA */
+#if (GNSS_PARSER_USE_ODO_DATA == 1)
     (void)memset((void *)(&pGNSSParser_Data->odo_data), 0, sizeof(Odometer_Info_t));
+#endif /* GNSS_PARSER_USE_ODO_DATA */
+#if (GNSS_PARSER_USE_DATALOG_DATA == 1)
     (void)memset((void *)(&pGNSSParser_Data->datalog_data), 0, sizeof(Datalog_Info_t));
+#endif /* GNSS_PARSER_USE_DATALOG_DATA */
     (void)memset((void *)(&pGNSSParser_Data->result), 0, sizeof(OpResult_t));
+    (void)memset((void *)(&pGNSSParser_Data->epoch), 0, sizeof(GNSSParser_Epoch_t));
+#if (CONFIG_USE_LAZY_DECODE == 1)
+    pGNSSParser_Data->raw.pending = 0U;
+#endif /* CONFIG_USE_LAZY_DECODE */
+#if (CONFIG_USE_RX_STATS == 1)
+    (void)memset((void *)(&pGNSSParser_Data->stats), 0, sizeof(GNSSParser_Stats_t));
+#endif /* CONFIG_USE_RX_STATS */
+#if (CONFIG_USE_EPOCH_BIN == 1)
+    (void)memset((void *)(&pGNSSParser_Data->sats), 0, sizeof(GNSSParser_Sats_t));
+#endif /* CONFIG_USE_EPOCH_BIN */
 
     ret = GNSS_PARSER_OK;
   }
@@ -92,23 +136,110 @@ GNSSParser_Status_t GNSS_PARSER_CheckSanity(uint8_t *pSentence, uint64_t len)
   return ret;
 }
 
+GNSSParser_Status_t GNSS_PARSER_CheckMsg(GNSSParser_Data_t *pGNSSParser_Data, uint8_t *pSentence, uint64_t len)
+{
+  GNSSParser_Status_t ret = GNSS_PARSER_CheckSanity(pSentence, len);
+
+#if (CONFIG_USE_RX_STATS == 1)
+  if (ret != GNSS_PARSER_OK)
+  {
+    pGNSSParser_Data->stats.checksum_errors++;
+  }
+#else
+  (void)pGNSSParser_Data;
+#endif /* CONFIG_USE_RX_STATS */
+
+  return ret;
+}
+
 GNSSParser_Status_t GNSS_PARSER_ParseMsg(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, uint8_t *pBuffer)
+{
+  GNSSParser_Status_t ret;
+
+#if (CONFIG_USE_LAZY_DECODE == 1)
+  if (msg < GNSS_PARSER_LAZY_NUM)
+  {
+    ret = GNSS_PARSER_Store(pGNSSParser_Data, msg, pBuffer);
+  }
+  else
+#endif /* CONFIG_USE_LAZY_DECODE */
+  {
+    ret = GNSS_PARSER_Dispatch(pGNSSParser_Data, msg, pBuffer);
+  }
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  /* The time-stamped sentences of an epoch come before its GSA and GSV sentences */
+  if ((ret == GNSS_PARSER_OK) && (msg < GNSS_PARSER_TIMED_NUM))
+  {
+    pGNSSParser_Data->sats.restart = 1U;
+  }
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+#if (CONFIG_USE_RX_STATS == 1)
+  if ((ret == GNSS_PARSER_OK) && (msg < (uint8_t)NMEA_MSGS_NUM))
+  {
+    pGNSSParser_Data->stats.msg_count[msg]++;
+  }
+#endif /* CONFIG_USE_RX_STATS */
+
+  return ret;
+}
+
+GNSS_Time_t GNSS_PARSER_GetTime(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg)
+{
+  GNSS_Time_t time = GNSS_TIME_INVALID;
+
+  if (msg < GNSS_PARSER_TIMED_NUM)
+  {
+    (void)GNSS_PARSER_Decode(pGNSSParser_Data, msg);
+    time = pGNSSParser_Data->epoch.msg_time[msg];
+  }
+
+  return time;
+}
+
+GNSSParser_Status_t GNSS_PARSER_Decode(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg)
+{
+  GNSSParser_Status_t ret = GNSS_PARSER_OK;
+
+#if (CONFIG_USE_LAZY_DECODE == 1)
+  if ((msg < GNSS_PARSER_LAZY_NUM) && ((pGNSSParser_Data->raw.pending & (1UL << msg)) != 0U))
+  {
+    pGNSSParser_Data->raw.pending &= ~(1UL << msg);
+    ret = GNSS_PARSER_Dispatch(pGNSSParser_Data, msg, pGNSSParser_Data->raw.sentence[msg]);
+  }
+#else
+  (void)pGNSSParser_Data;
+  (void)msg;
+#endif /* CONFIG_USE_LAZY_DECODE */
+
+  return ret;
+}
+
+/* Private functions ---------------------------------------------------------*/
+
+static GNSSParser_Status_t GNSS_PARSER_Dispatch(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, uint8_t *pBuffer)
 {
   ParseStatus_t status = PARSE_FAIL;
+  UTC_Info_t *pUTC = NULL;
 
   switch (msg)
   {
     case GPGGA:
       status = NMEA_ParseGPGGA(&pGNSSParser_Data->gpgga_data, pBuffer);
+      pUTC = &pGNSSParser_Data->gpgga_data.utc;
       break;
     case GNS:
       status = NMEA_ParseGNS(&pGNSSParser_Data->gns_data, pBuffer);
+      pUTC = &pGNSSParser_Data->gns_data.utc;
       break;
     case GPGST:
       status = NMEA_ParseGPGST(&pGNSSParser_Data->gpgst_data, pBuffer);
+      pUTC = &pGNSSParser_Data->gpgst_data.utc;
       break;
     case GPRMC:
       status = NMEA_ParseGPRMC(&pGNSSParser_Data->gprmc_data, pBuffer);
+      pUTC = &pGNSSParser_Data->gprmc_data.utc;
       break;
     case GSA:
       status = NMEA_ParseGSA(&pGNSSParser_Data->gsa_data, pBuffer);
@@ -119,21 +250,29 @@ GNSSParser_Status_t GNSS_PARSER_ParseMsg(GNSSParser_Data_t *pGNSSParser_Data, ui
     case PSTMVER:
       status = NMEA_ParsePSTMVER(&pGNSSParser_Data->pstmver_data, pBuffer);
       break;
+#if (GNSS_PARSER_USE_AGNSS_DATA == 1)
     case PSTMPASSRTN:
       status = NMEA_ParsePSTMPASSRTN(&pGNSSParser_Data->pstmpass_data, pBuffer);
       break;
     case PSTMAGPSSTATUS:
       status = NMEA_ParsePSTMAGPS(&pGNSSParser_Data->pstmagps_data, pBuffer);
       break;
+#endif /* GNSS_PARSER_USE_AGNSS_DATA */
+#if (GNSS_PARSER_USE_GEOFENCE_DATA == 1)
     case PSTMGEOFENCE:
       status = NMEA_ParsePSTMGeofence(&pGNSSParser_Data->geofence_data, pBuffer);
       break;
+#endif /* GNSS_PARSER_USE_GEOFENCE_DATA */
+#if (GNSS_PARSER_USE_ODO_DATA == 1)
     case PSTMODO:
       status = NMEA_ParsePSTMOdo(&pGNSSParser_Data->odo_data, pBuffer);
       break;
+#endif /* GNSS_PARSER_USE_ODO_DATA */
+#if (GNSS_PARSER_USE_DATALOG_DATA == 1)
     case PSTMDATALOG:
       status = NMEA_ParsePSTMDatalog(&pGNSSParser_Data->datalog_data, pBuffer);
       break;
+#endif /* GNSS_PARSER_USE_DATALOG_DATA */
     case PSTMSGL:
       status = NMEA_ParsePSTMsgl(&pGNSSParser_Data->result, pBuffer);
       break;
@@ -153,5 +292,208 @@ GNSSParser_Status_t GNSS_PARSER_ParseMsg(GNSSParser_Data_t *pGNSSParser_Data, ui
       break;
   }
 
+  if ((status != PARSE_FAIL) && (pUTC != NULL))
+  {
+    GNSS_PARSER_StampTime(pGNSSParser_Data, msg, pUTC, pBuffer);
+  }
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  if ((status != PARSE_FAIL) && ((msg == (uint8_t)GSA) || (msg == (uint8_t)GSV)))
+  {
+    GNSS_PARSER_AddSats(pGNSSParser_Data, msg);
+  }
+#endif /* CONFIG_USE_EPOCH_BIN */
+
   return ((status == PARSE_FAIL) ? GNSS_PARSER_ERROR : GNSS_PARSER_OK);
 }
+
+/* Stores the GNSS time of the sentence epoch.
+ * The date is the one of the latest RMC sentence, moved by a day when the time of day
+ * wrapped around midnight between the two sentences. The time is computed once per epoch.
+ */
+static void GNSS_PARSER_StampTime(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, const UTC_Info_t *pUTC,
+                                  const uint8_t *pBuffer)
+{
+  GNSSParser_Epoch_t *pEpoch = &pGNSSParser_Data->epoch;
+  int32_t tod;
+  int32_t ref;
+  int32_t date;
+  int16_t ms = 0;
+  int16_t scale = 100;
+  uint32_t i = 0U;
+
+  /* UTC_Info_t holds whole seconds: take the milliseconds from the "hhmmss.sss" field */
+  while ((pBuffer[i] != (uint8_t)',') && (pBuffer[i] != (uint8_t)'\n') && (pBuffer[i] != 0U))
+  {
+    i++;
+  }
+  if (pBuffer[i] == (uint8_t)',')
+  {
+    i++;
+    while ((pBuffer[i] >= (uint8_t)'0') && (pBuffer[i] <= (uint8_t)'9'))
+    {
+      i++;
+    }
+    if (pBuffer[i] == (uint8_t)'.')
+    {
+      i++;
+      while ((scale > 0) && (pBuffer[i] >= (uint8_t)'0') && (pBuffer[i] <= (uint8_t)'9'))
+      {
+        ms += (int16_t)(pBuffer[i] - (uint8_t)'0') * scale;
+        scale /= 10;
+        i++;
+      }
+    }
+  }
+
+  tod = ((((int32_t)pUTC->hh * 3600) + ((int32_t)pUTC->mm * 60) + (int32_t)pUTC->ss) * 1000) + (int32_t)ms;
+
+  if (msg == (uint8_t)GPRMC)
+  {
+    pEpoch->rmc_tod = tod;
+  }
+  else
+  {
+    /* The date comes from RMC: it must be up to date before stamping other sentences */
+    (void)GNSS_PARSER_Decode(pGNSSParser_Data, GPRMC);
+  }
+  date = pGNSSParser_Data->gprmc_data.date;
+  ref = pEpoch->rmc_tod;
+
+  if ((tod != pEpoch->tod) || (date != pEpoch->date) || (pEpoch->time == GNSS_TIME_INVALID))
+  {
+    pEpoch->date = date;
+    pEpoch->tod = tod;
+    pEpoch->time = NMEA_ToGNSSTime(date, pUTC, ms);
+
+    if (pEpoch->time != GNSS_TIME_INVALID)
+    {
+      if ((tod - ref) > (12 * 3600 * 1000))
+      {
+        pEpoch->time -= 86400000ULL;
+      }
+      else if ((ref - tod) > (12 * 3600 * 1000))
+      {
+        pEpoch->time += 86400000ULL;
+      }
+      else
+      {
+        /* Same day as the RMC sentence */
+      }
+    }
+  }
+
+  pEpoch->msg_time[msg] = pEpoch->time;
+}
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+/* Adds the satellites of the GSA or GSV sentence just decoded to the lists of the epoch.
+ * The first GSA or GSV sentence following a time-stamped one empties the lists.
+ */
+static void GNSS_PARSER_AddSats(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg)
+{
+  GNSSParser_Sats_t *pSats = &pGNSSParser_Data->sats;
+  const GSA_Info_t *gsa = &pGNSSParser_Data->gsa_data;
+  const GSV_Info_t *gsv = &pGNSSParser_Data->gsv_data;
+  uint32_t tot;
+  int32_t i;
+
+  if (pSats->restart != 0U)
+  {
+    pSats->view_nbr = 0U;
+    pSats->used_nbr = 0U;
+    pSats->tot_sats = 0U;
+    pSats->restart = 0U;
+  }
+
+  if (msg == (uint8_t)GSA)
+  {
+    for (i = 0; (i < MAX_SAT_NUM) && (pSats->used_nbr < (uint8_t)MAX_SAT_NUM); i++)
+    {
+      if (gsa->sat_prn[i] != 0)
+      {
+        pSats->used_prn[pSats->used_nbr] = (int16_t)gsa->sat_prn[i];
+        pSats->used_nbr++;
+      }
+    }
+  }
+  else
+  {
+    /* The first sentence of each constellation gives its satellites in view */
+    if (gsv->number == 1)
+    {
+      tot = (uint32_t)pSats->tot_sats + (uint32_t)gsv->tot_sats;
+      pSats->tot_sats = (tot > 0xFFU) ? 0xFFU : (uint8_t)tot;
+    }
+    for (i = 0; (i < GSV_MSG_SATS) && (pSats->view_nbr < (uint8_t)MAX_SAT_NUM); i++)
+    {
+      if (gsv->gsv_sat_i[i].prn != 0)
+      {
+        pSats->view_prn[pSats->view_nbr] = gsv->gsv_sat_i[i].prn;
+        pSats->view_cn0[pSats->view_nbr] = gsv->gsv_sat_i[i].cn0;
+        pSats->view_nbr++;
+      }
+    }
+  }
+}
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+#if (CONFIG_USE_LAZY_DECODE == 1)
+/* Keeps the sentence for a later GNSS_PARSER_Decode() if its header belongs to the message type */
+static GNSSParser_Status_t GNSS_PARSER_Store(GNSSParser_Data_t *pGNSSParser_Data, uint8_t msg, const uint8_t *pBuffer)
+{
+  GNSSParser_Status_t ret = GNSS_PARSER_ERROR;
+  char header[8];
+  uint32_t len = 0U;
+
+  if (pBuffer == NULL)
+  {
+    return ret;
+  }
+
+  /* The header is everything up to the first field separator */
+  while ((len < (sizeof(header) - 1U)) && (pBuffer[len] != (uint8_t)',') &&
+         (pBuffer[len] != (uint8_t)'*') && (pBuffer[len] != (uint8_t)'\n') && (pBuffer[len] != 0U))
+  {
+    header[len] = (char)pBuffer[len];
+    len++;
+  }
+  header[len] = '\0';
+
+  if ((pBuffer[len] != (uint8_t)',') && (pBuffer[len] != (uint8_t)'*'))
+  {
+    return ret;
+  }
+
+  for (uint8_t h = 0; GNSS_PARSER_Headers[msg][h] != NULL; h++)
+  {
+    if (strcmp(header, GNSS_PARSER_Headers[msg][h]) == 0)
+    {
+      ret = GNSS_PARSER_OK;
+      break;
+    }
+  }
+
+  if (ret == GNSS_PARSER_OK)
+  {
+    /* Copy up to and including the '\n' the NMEA parser stops at */
+    while ((len < GNSS_PARSER_RAW_LEN) && (pBuffer[len] != (uint8_t)'\n') && (pBuffer[len] != 0U))
+    {
+      len++;
+    }
+
+    if ((len < GNSS_PARSER_RAW_LEN) && (pBuffer[len] == (uint8_t)'\n'))
+    {
+      (void)memcpy(pGNSSParser_Data->raw.sentence[msg], pBuffer, len + 1U);
+      pGNSSParser_Data->raw.pending |= (1UL << msg);
+    }
+    else
+    {
+      /* Too long to be kept: decode it now */
+      pGNSSParser_Data->raw.pending &= ~(1UL << msg);
+      ret = GNSS_PARSER_Dispatch(pGNSSParser_Data, msg, (uint8_t *)pBuffer);
+    }
+  }
+
+  return ret;
+}
+#endif /* CONFIG_USE_LAZY_DECODE */
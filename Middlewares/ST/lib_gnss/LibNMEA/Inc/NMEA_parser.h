@@ -25,6 +25,7 @@ extern "C" {
 
 /* Includes ------------------------------------------------------------------*/
 #include <stdint.h>
+#include "gnss_lib_config.h"
 
 /** @defgroup MIDDLEWARES MIDDLEWARES
   *  @{
@@ -76,6 +77,15 @@ extern "C" {
   * @brief Constant that indicates the maximum length of a string.
   */
 #define MAX_STR_LEN 32
+
+/**
+  * @brief Constant that indicates the length of the constellation (sentence header) strings.
+  */
+#if (CONFIG_USE_LEAN_DATA == 1)
+#define NMEA_CONSTELLATION_LEN 8
+#else
+#define NMEA_CONSTELLATION_LEN MAX_STR_LEN
+#endif /* CONFIG_USE_LEAN_DATA */
 #define MAX_FIELDS 6
 
 
@@ -93,6 +103,18 @@ extern "C" {
   * @brief Constant that indicates the maximum number of geofence circles.
   */
 #define MAX_GEOFENCES_NUM (8U)
+
+/**
+  * @brief Constant that indicates the GPS-UTC offset in seconds (leap seconds since the GPS epoch).
+  */
+#ifndef NMEA_GPS_LEAP_SECONDS
+#define NMEA_GPS_LEAP_SECONDS 18
+#endif /* NMEA_GPS_LEAP_SECONDS */
+
+/**
+  * @brief Constant for a GNSS_Time_t value that is not known (no date received yet).
+  */
+#define GNSS_TIME_INVALID 0ULL
 /**
   * @}
   */
@@ -127,6 +149,11 @@ typedef float float32_t;
   */
 typedef double float64_t;
 
+/**
+  * @brief GNSS time: milliseconds since the GPS epoch (1980-01-06 00:00:00), GPS time scale
+  */
+typedef uint64_t GNSS_Time_t;
+
 /**
   * @brief Enumeration structure that contains the two states of a parsing process
   */
@@ -234,7 +261,7 @@ typedef struct
   */
 typedef struct
 {
-  uint8_t constellation[MAX_STR_LEN]; /**< Constellation enabled: GPGNS (GPS), GLGNS (GLONASS), GAGNS (GALILEO), BDGNS (BEIDOU), QZGNS (QZSS), GNGNS (more than one) */
+  uint8_t constellation[NMEA_CONSTELLATION_LEN]; /**< Constellation enabled: GPGNS (GPS), GLGNS (GLONASS), GAGNS (GALILEO), BDGNS (BEIDOU), QZGNS (QZSS), GNGNS (more than one) */
   UTC_Info_t utc;        /**< UTC Time */
   Coords_t xyz;          /**< Coords data member */
   uint8_t gps_mode;      /**< N = NO Fix, A = Autonomous, D = Differential GPS, E = Estimated (dead reckoning mode) */
@@ -284,7 +311,7 @@ typedef struct
   */
 typedef struct
 {
-  uint8_t constellation[MAX_STR_LEN]; /**< Constellation enabled: GPGSA (GPS), GLGSA (GLONASS), GAGSA (GALILEO), BDGSA (BEIDOU), GNGSA (more than one) */
+  uint8_t constellation[NMEA_CONSTELLATION_LEN]; /**< Constellation enabled: GPGSA (GPS), GLGSA (GLONASS), GAGSA (GALILEO), BDGSA (BEIDOU), GNGSA (more than one) */
   uint8_t operating_mode;             /**< Operating Mode: 'M' = Manual, 'A' = Auto (2D/3D) */
   int16_t current_mode;               /**< Current Mode: 1. no fix available, 2. 2D, 3. 3D */
   int32_t sat_prn[MAX_SAT_NUM];       /**< Satellites list used in position fix (max N 12) */
@@ -299,7 +326,7 @@ typedef struct
   */
 typedef struct
 {
-  uint8_t constellation[MAX_STR_LEN];    /**< Constellation enabled: GPGSV (GPS), GLGSV (GLONASS), GAGSV (GALILEO), BDGSV (BEIDOU), QZGSV (QZSS), GNGSV (more than one) */
+  uint8_t constellation[NMEA_CONSTELLATION_LEN];    /**< Constellation enabled: GPGSV (GPS), GLGSV (GLONASS), GAGSV (GALILEO), BDGSV (BEIDOU), QZGSV (QZSS), GNGSV (more than one) */
   int16_t amount;                        /**< Total amount of GSV messages, max. 3 */
   int16_t number;                        /**< Continued GSV number of this message */
   int16_t tot_sats;                      /**< Total Number of Satellites in view, max. 12 */
@@ -568,6 +595,15 @@ void NMEA_Copy_Data(GPGGA_Info_t *pInfo, GPGGA_Info_t GPGGAInfo);
   */
 uint32_t char2int(uint8_t c);
 
+/**
+  * @brief  This function converts a UTC date and time of day to GNSS time
+  * @param  date The date as ddmmyy (as in the $GPRMC sentence)
+  * @param  pUTC The UTC time of day
+  * @param  ms   The milliseconds of the time of day
+  * @retval The GNSS time, GNSS_TIME_INVALID if the date is not valid
+  */
+GNSS_Time_t NMEA_ToGNSSTime(int32_t date, const UTC_Info_t *pUTC, int16_t ms);
+
 /**
   * @}
   */
@@ -161,7 +161,7 @@ static int32_t NMEA_CheckGSVMsg(const char header[])
  */
 static void NMEA_ResetGSVMsg(GSV_Info_t *pGSVInfo)
 {
-  (void)memset(pGSVInfo->constellation, 0, (size_t)MAX_STR_LEN);
+  (void)memset(pGSVInfo->constellation, 0, (size_t)NMEA_CONSTELLATION_LEN);
   pGSVInfo->amount = 0;
   pGSVInfo->number = 0;
   pGSVInfo->current_sats = 0;
@@ -627,7 +627,7 @@ ParseStatus_t NMEA_ParseGNS(GNS_Info_t *pGNSInfo, uint8_t NMEA[])
 
     if (valid_msg == TRUE)
     {
-      (void)strncpy((char *)pGNSInfo->constellation, (char *)app[0], MAX_STR_LEN);
+      (void)strncpy((char *)pGNSInfo->constellation, (char *)app[0], NMEA_CONSTELLATION_LEN);
       scan_utc(app[1], &pGNSInfo->utc);
       pGNSInfo->xyz.lat = strtod((char *)app[2], NULL);
       pGNSInfo->xyz.ns = *((uint8_t *)app[3]);
@@ -823,7 +823,7 @@ ParseStatus_t NMEA_ParseGSA(GSA_Info_t *pGSAInfo, uint8_t NMEA[])
 
     if (valid_msg == TRUE)
     {
-      (void)strncpy((char *)pGSAInfo->constellation, (char *)app[0], MAX_STR_LEN);
+      (void)strncpy((char *)pGSAInfo->constellation, (char *)app[0], NMEA_CONSTELLATION_LEN);
       pGSAInfo->operating_mode = *((uint8_t *)app[1]);
       pGSAInfo->current_mode = strtol((char *)app[2], NULL, BASE);
 
@@ -894,7 +894,7 @@ ParseStatus_t NMEA_ParseGSV(GSV_Info_t *pGSVInfo, uint8_t NMEA[])
     {
       NMEA_ResetGSVMsg(pGSVInfo);
 
-      (void)strncpy((char *)pGSVInfo->constellation, (char *)app[0], MAX_STR_LEN);
+      (void)strncpy((char *)pGSVInfo->constellation, (char *)app[0], NMEA_CONSTELLATION_LEN);
       pGSVInfo->amount = strtol((char *)app[1], NULL, BASE);
       pGSVInfo->number = strtol((char *)app[2], NULL, BASE);
       pGSVInfo->tot_sats = strtol((char *)app[3], NULL, BASE);
@@ -1795,3 +1795,46 @@ uint32_t char2int(uint8_t c)
   return ret;
 }
 
+/**
+  * @brief  Function that converts a UTC date and time of day to GNSS time
+  * @param  date The date as ddmmyy
+  * @param  pUTC The UTC time of day
+  * @param  ms   The milliseconds of the time of day
+  * @retval The GNSS time, GNSS_TIME_INVALID if the date is not valid
+  */
+GNSS_Time_t NMEA_ToGNSSTime(int32_t date, const UTC_Info_t *pUTC, int16_t ms)
+{
+  int32_t day = date / 10000;
+  int32_t month = (date / 100) % 100;
+  int32_t year = date % 100;
+  int32_t days;
+  int32_t secs;
+
+  if ((day < 1) || (day > 31) || (month < 1) || (month > 12))
+  {
+    return GNSS_TIME_INVALID;
+  }
+
+  /* Two digit years are taken in the 1980-2079 window */
+  year += (year < 80) ? 2000 : 1900;
+
+  /* Days from 1970-01-01 of the civil date (March based year) */
+  if (month <= 2)
+  {
+    year--;
+    month += 12;
+  }
+  days = (365 * year) + (year / 4) - (year / 100) + (year / 400) + (((153 * (month - 3)) + 2) / 5) + day - 719469;
+
+  /* GPS epoch is 1980-01-06, day 3657 from 1970-01-01 */
+  days -= 3657;
+  if (days < 0)
+  {
+    return GNSS_TIME_INVALID;
+  }
+
+  secs = ((int32_t)pUTC->hh * 3600) + ((int32_t)pUTC->mm * 60) + (int32_t)pUTC->ss + NMEA_GPS_LEAP_SECONDS;
+
+  return (((GNSS_Time_t)(uint32_t)days * 86400000ULL) + ((GNSS_Time_t)(uint32_t)secs * 1000ULL)) + (GNSS_Time_t)(uint16_t)ms;
+}
+
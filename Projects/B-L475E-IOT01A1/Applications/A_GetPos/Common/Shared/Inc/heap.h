@@ -37,5 +37,19 @@ void heap_free(void  *p);
 
 void heap_stat(uint32_t *heap_max,uint32_t *heap_current, uint32_t *stacksize)  ;
 
+/* Arena (bump) allocator: the blocks are carved from an 8 byte aligned buffer of the
+   caller and are all released at once by heap_arena_reset() */
+typedef struct
+{
+  uint8_t *base;
+  size_t size;
+  size_t used;
+  size_t peak;   /* watermark of used since heap_arena_init() */
+} heap_arena_t;
+
+void heap_arena_init(heap_arena_t *arena, void *buf, size_t size);
+void *heap_arena_alloc(heap_arena_t *arena, size_t size);
+void heap_arena_reset(heap_arena_t *arena);
+
 #endif  /* __HEAP_H__ */
 
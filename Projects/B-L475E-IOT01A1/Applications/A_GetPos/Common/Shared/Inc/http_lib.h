@@ -56,6 +56,13 @@ typedef enum {
   HTTP_REQUEST_DELETE
 } http_request_t;
 
+/**
+ * @brief   Consumer of a response body received by http_recv_stream().
+ *          Called once per received piece of the body, in order.
+ * @retval  0 to go on, <0 to abort the reception.
+ */
+typedef int (*http_body_cb_t)(void *arg, const uint8_t *data, uint32_t length);
+
 /**
  * @brief   Create an HTTP session.
  * @note    The internal session context is allocated by the callee.
@@ -162,7 +169,22 @@ int http_recv(http_handle_t hnd, uint8_t * buffer, uint32_t length);
  *            HTTP_ERR (<0)  Failure
  */
 int http_recv_response(http_handle_t hnd, uint8_t * buffer, uint32_t buffer_length);
-int http_recv_chunked(http_handle_t hnd, uint8_t * buffer, uint32_t length, int *http_status);
+
+/**
+ * @brief   Receive a response and pass its body to a consumer as it arrives,
+ *          without buffering it. Both the chunked transfer encoding and the
+ *          Content-Length: body are handled.
+ * @param   In:       Handle
+ * @param   In:       cb          body consumer.
+ * @param   In:       arg         argument passed to cb.
+ * @param   Out:      http_status HTTP status of the response.
+ * @note    The session is left open for the next request only when the body
+ *          was received in full and the server keeps the connection alive:
+ *          check it with http_is_open().
+ * @retval  size of the body passed to cb
+ *            HTTP_ERR (<0)  Failure, or reception aborted by cb
+ */
+int http_recv_stream(http_handle_t hnd, http_body_cb_t cb, void *arg, int *http_status);
 
 /**
  * @brief   Set network socket option for an HTTP session.
@@ -250,7 +272,6 @@ bool http_is_open(const http_handle_t hnd);
  *            NULL    Body part was not found.
  */
 uint8_t * http_find_body(uint8_t * http_message, uint32_t *length);
-uint8_t * http_find_chunk(uint8_t * http_message, uint32_t *length, int *chunk_len);
 
 /**
  * @brief   Get the HTTP response status in headers.
@@ -280,6 +301,13 @@ int http_response_validate(uint8_t * http_response, uint32_t length);
  */
 uint32_t http_content_length(uint8_t * buffer, uint32_t length);
 int http_transfer_is_chunked(uint8_t * buffer, uint32_t len);
+/**
+ * @brief   Tell whether the headers ask to close the connection after the response.
+ * @param   In:       buffer      buffer containing headers.
+ * @param   In:       len         buffer size.
+ * @retval  1 if "Connection: close" is found, 0 otherwise.
+ */
+int http_connection_is_close(uint8_t * buffer, uint32_t len);
 
 #ifdef __cplusplus
 }
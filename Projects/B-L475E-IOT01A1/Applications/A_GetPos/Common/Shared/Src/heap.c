@@ -85,6 +85,37 @@ void heap_stat(uint32_t *heap_max,uint32_t *heap_current,uint32_t *stack_size)
   *stack_size = stack_max_size;
 }
 
+void heap_arena_init(heap_arena_t *arena, void *buf, size_t size)
+{
+  arena->base = (uint8_t*)buf;
+  arena->size = size;
+  arena->used = 0;
+  arena->peak = 0;
+}
+
+/* 8 byte aligned blocks, NULL when the arena is full */
+void *heap_arena_alloc(heap_arena_t *arena, size_t size)
+{
+  size_t n = (size + 7) & ~((size_t)7);
+  uint8_t *p;
+
+  if ((arena->base == NULL) || (n < size) || (n > (arena->size - arena->used)))
+  {
+    heaplog("ARENA run out of memory (%u bytes)\n", (unsigned int)size);
+    return NULL;
+  }
+  p = arena->base + arena->used;
+  arena->used += n;
+  if (arena->used > arena->peak) arena->peak = arena->used;
+
+  return p;
+}
+
+void heap_arena_reset(heap_arena_t *arena)
+{
+  arena->used = 0;
+}
+
 #ifdef HEAP_DEBUG
 static  void heap_abort(void)
 {
@@ -17,6 +17,7 @@
   */
 /* Includes ------------------------------------------------------------------*/
 #include <string.h>
+#include <ctype.h>
 #include "main.h"
 #include "http_lib.h"
 #include "msg.h"
@@ -50,32 +51,22 @@ typedef struct {
   uint8_t buffer[HTTP_BUFFER_SIZE];   /**< work buffer  */
 } http_context_t;
 
+/** 
+ * @brief Parsing state of a body received by http_recv_stream(). 
+ */
+typedef enum {
+  HTTP_BODY_CHUNK_SIZE = 0,           /**< hex size line of a chunk */
+  HTTP_BODY_CHUNK_EXT,                /**< rest of the size line: extensions, CR */
+  HTTP_BODY_DATA,                     /**< chunk or Content-Length data */
+  HTTP_BODY_DATA_END,                 /**< CR-LF closing a chunk */
+  HTTP_BODY_TRAILER,                  /**< trailer lines after the last chunk, up to an empty line */
+  HTTP_BODY_DONE
+} http_body_state_t;
+
 /* Private variables ---------------------------------------------------------*/
 /* Private function prototypes -----------------------------------------------*/
 uint8_t * http_find_headers(uint8_t * http_message, uint32_t len);
 
-int http_recv_payload(http_handle_t hnd,
-                      uint8_t *buffer,
-                      uint32_t buffer_length,
-                      uint8_t *recv_buf,
-                      uint32_t recv_buf_len,
-                      int content_length,
-                      int recv_len);
-
-int http_recv_chunks(http_handle_t hnd,
-                     uint8_t *buffer,
-                     uint32_t buffer_length,
-                     uint8_t *recv_buf,
-                     uint32_t recv_buf_len,
-                     int recv_len);
-
-int http_append_chunk(http_handle_t hnd,
-                      uint8_t *dst_buffer,
-                      uint32_t *dst_offset,
-                      uint32_t dst_length,
-                      uint8_t *src_buffer,
-                      uint32_t src_length);
-
 /* Functions Definition ------------------------------------------------------*/
 
 int http_create_session(http_handle_t * const pHnd, const char *host, int port, http_proto_t protocol)
@@ -328,208 +319,151 @@ int http_recv_response(http_handle_t hnd, uint8_t * buffer, uint32_t buffer_leng
   }
 }
 
-int http_append_chunk(http_handle_t hnd,
-                      uint8_t *dst_buffer,
-                      uint32_t *dst_offset,
-                      uint32_t dst_length,
-                      uint8_t *src_buffer,
-                      uint32_t src_length)
+int http_recv_stream(http_handle_t hnd, http_body_cb_t cb, void *arg, int *http_status)
 {
   http_context_t * pCtx = (http_context_t *) hnd;
+  uint8_t recv_buf[1024];
+  http_body_state_t state;
+  uint8_t *p = NULL;
+  uint32_t len = 0;
+  uint32_t left = 0;
+  uint32_t n = 0;
+  uint32_t body_length = 0;
+  uint32_t line_length = 0;
   int received = 0;
-  int recv_size = 0;
-  int chunk_length = 0;
-
-  uint8_t *chunk = NULL;
-  uint32_t offset = *dst_offset;
+  int rc = 0;
+  bool chunked = false;
+  bool keep_alive = false;
 
-  uint8_t trailer_buf[2];
-
-  //find the start of the chunk within src_buffer
-  chunk = http_find_chunk(src_buffer, &src_length, &chunk_length);
-
-  if(chunk != NULL && chunk_length > 0 &&
-       (chunk_length <= dst_length-offset))
+  //the headers may come in several pieces
+  do
   {
-    //append the chunk to dst_buffer
-    memcpy(dst_buffer+offset, chunk, src_length);
-
-    //loop to complete a single chunk
-    do
+    rc = net_sock_recv(pCtx->sock, recv_buf + received, sizeof(recv_buf) - received);
+    if (rc <= 0)
     {
-      recv_size = chunk_length-src_length;
-      //msg_debug("recv_size=%d\n", recv_size);
-      if(recv_size == 0)
-      {
-        break;
-      }
-      received = net_sock_recv(pCtx->sock, dst_buffer+offset+src_length, recv_size);
-      if(received > 0)
-      {
-        src_length += received;
-        //msg_debug("received=%d src_length=%d\n", received, src_length);
-      }
-    } while(received > 0);
-
-    *dst_offset += src_length;
-    //msg_debug("dst_offset=%d\n", *dst_offset);
-
-    //each chunk is closed by a "\r\n" sequence, hence move to the beginning of the next chunk
-    net_sock_recv(pCtx->sock, trailer_buf, 2);
+      pCtx->connection_is_open = false;
+      return (rc < 0) ? rc : HTTP_ERR;
+    }
+    received += rc;
+    len = received;
+    p = http_find_body(recv_buf, &len);
+  } while ((p == NULL) && ((uint32_t)received < sizeof(recv_buf)));
+  if (p == NULL)
+  {
+    pCtx->connection_is_open = false;
+    return HTTP_ERR;
+  }
+  //check the HTTP status of the response
+  *http_status = http_response_status(recv_buf, received);
+  printf("status=%d\n", *http_status);
+  keep_alive = !http_connection_is_close(recv_buf, (uint32_t)(p - recv_buf));
 
-    return HTTP_OK;
+  if (http_transfer_is_chunked(recv_buf, received))
+  {
+    msg_debug("response is chunked\n");
+    chunked = true;
+    state = HTTP_BODY_CHUNK_SIZE;
   }
   else
   {
-    return HTTP_ERR;
+    //without Content-Length: the body ends when the server closes the connection
+    left = http_content_length(recv_buf, received);
+    msg_debug("content_length=%lu\n", left);
+    keep_alive = keep_alive && (left != 0);
+    left = (left != 0) ? left : UINT32_MAX;
+    state = HTTP_BODY_DATA;
   }
-}
-
-int http_recv_chunked(http_handle_t hnd, uint8_t *buffer, uint32_t buffer_length, int *http_status)
-{
-  http_context_t * pCtx = (http_context_t *) hnd;
-  uint8_t recv_buf[1024];
-
-  uint32_t body_length = 0;
-
-  int received = 0;
 
-  memset(recv_buf, 0, sizeof(recv_buf));
-  received = net_sock_recv(pCtx->sock, recv_buf, sizeof(recv_buf));
-  //msg_debug("http_recv received=%d recv_buf=\n%.*s\n", received, received, recv_buf);
-  if(received > 0)
-  {
-    int content_length = 0;
-    //check the HTTP status of the response
-    *http_status = http_response_status(recv_buf, received);
-    printf("status=%d\n", *http_status);
-    //check the HTTP content length of the response
-    content_length = http_content_length(recv_buf, received);
-    msg_debug("content_length=%d\n", content_length);
-    //check if the 'Transfer-Encoding: chunked' is included in the HTTP headers
-    if(http_transfer_is_chunked(recv_buf, received))
-    {
-      msg_debug("response is chunked\n");
-      body_length = http_recv_chunks(hnd,
-                                     buffer,
-                                     buffer_length,
-                                     recv_buf,
-                                     sizeof(recv_buf),
-                                     received);
-    }
-    else
+  while (state != HTTP_BODY_DONE)
+  {
+    while ((len > 0) && (state != HTTP_BODY_DONE))
     {
-      msg_debug("response is not chunked\n");
-      body_length = http_recv_payload(hnd,
-                                      buffer,
-                                      buffer_length,
-                                      recv_buf,
-                                      sizeof(recv_buf),
-                                      content_length,
-                                      received);
-    }
-  }
-  return body_length;
-
-}
+      switch (state)
+      {
+        case HTTP_BODY_CHUNK_SIZE:
+        case HTTP_BODY_CHUNK_EXT:
+          if (*p == '\n')
+          {
+            //the last chunk has a zero size, the body ends with its trailer
+            state = (left != 0) ? HTTP_BODY_DATA : HTTP_BODY_TRAILER;
+            line_length = 0;
+          }
+          else if ((state == HTTP_BODY_CHUNK_SIZE) && isxdigit(*p))
+          {
+            left = (left << 4) | (uint32_t)(isdigit(*p) ? (*p - '0') : ((tolower(*p) - 'a') + 10));
+          }
+          else
+          {
+            state = HTTP_BODY_CHUNK_EXT;
+          }
+          p++;
+          len--;
+          break;
 
-int http_recv_chunks(http_handle_t hnd,
-                     uint8_t *buffer,
-                     uint32_t buffer_length,
-                     uint8_t *recv_buf,
-                     uint32_t recv_buf_len,
-                     int recv_len)
-{
-  http_context_t * pCtx = (http_context_t *) hnd;
-  uint8_t* pBody = NULL;
-  uint32_t body_offset = 0;
-  uint32_t len = 0;
+        case HTTP_BODY_DATA:
+          n = MIN(len, left);
+          if (cb(arg, p, n) < 0)
+          {
+            //the rest of the body is not read: the connection cannot be reused
+            pCtx->connection_is_open = false;
+            return HTTP_ERR;
+          }
+          body_length += n;
+          p += n;
+          len -= n;
+          left -= n;
+          if (left == 0)
+          {
+            state = chunked ? HTTP_BODY_DATA_END : HTTP_BODY_DONE;
+          }
+          break;
 
-  int received = recv_len;
+        case HTTP_BODY_TRAILER:
+          //the trailer fields are skipped, the empty line closes the body
+          if (*p == '\n')
+          {
+            state = (line_length == 0) ? HTTP_BODY_DONE : HTTP_BODY_TRAILER;
+            line_length = 0;
+          }
+          else if (*p != '\r')
+          {
+            line_length++;
+          }
+          p++;
+          len--;
+          break;
 
-  while(received > 0)
-  {
-    len = recv_len;
-    if(pBody == NULL)
-    {
-      pBody = http_find_body(recv_buf, &len);
-      if(pBody == NULL)
-      {
-        break;
-      }
-      if(http_append_chunk(hnd,
-                           buffer,
-                           &body_offset,
-                           buffer_length,
-                           pBody,
-                           len) != HTTP_OK)
-      {
-        break;
+        case HTTP_BODY_DATA_END:
+        default:
+          if (*p == '\n')
+          {
+            state = HTTP_BODY_CHUNK_SIZE;
+          }
+          p++;
+          len--;
+          break;
       }
     }
-    else
+    if (state == HTTP_BODY_DONE)
     {
-      if(http_append_chunk(hnd,
-                           buffer,
-                           &body_offset,
-                           buffer_length,
-                           recv_buf,
-                           len) != HTTP_OK)
-      {
-        break;
-      }
+      break;
     }
-
-    memset(recv_buf, 0, recv_buf_len);
-    received = net_sock_recv(pCtx->sock, recv_buf, recv_buf_len);
-    msg_debug("net_sock_recv received=%d recv_buf=\n%.*s\n", received, received, recv_buf);
+    received = net_sock_recv(pCtx->sock, recv_buf, sizeof(recv_buf));
+    msg_debug("net_sock_recv received=%d\n", received);
+    if (received <= 0)
+    {
+      break;
+    }
+    p = recv_buf;
+    len = received;
   }
-
-  return body_offset;
-}
-
-int http_recv_payload(http_handle_t hnd,
-                      uint8_t *buffer,
-                      uint32_t buffer_length,
-                      uint8_t *recv_buf,
-                      uint32_t recv_buf_len,
-                      int content_length,
-                      int recv_len)
-{
-  http_context_t * pCtx = (http_context_t *) hnd;
-
-  uint8_t* pBody = NULL;
-  uint32_t len = 0;
-
-  int recv_size = 0;
-  int received = 0;
-
-  len = recv_len;
-  pBody = http_find_body(recv_buf, &len);
-  if(pBody != NULL && content_length > 0 && (content_length <= buffer_length))
+  //data after the body would be taken as the start of the next response
+  if ((state != HTTP_BODY_DONE) || (len != 0) || !keep_alive)
   {
-    //append the piece of body already received to destination buffer
-    memcpy(buffer, pBody, len);
-
-    //loop to recv all remaining data bytes
-    do
-    {
-      recv_size = content_length - len;
-      //msg_debug("recv_size=%d\n", recv_size);
-      if(recv_size == 0)
-      {
-        break;
-      }
-      received = net_sock_recv(pCtx->sock, buffer+len, recv_size);
-      if(received > 0)
-      {
-        len += received;
-        //msg_debug("received=%d len=%d\n", received, len);
-      }
-    } while(received > 0);
+    pCtx->connection_is_open = false;
   }
 
-  return len;
+  return body_length;
 }
 
 int http_get(const http_handle_t hnd,
@@ -835,42 +769,6 @@ uint8_t * http_find_body(uint8_t * http_message, uint32_t *len)
   return NULL;
 }
 
-uint8_t * http_find_chunk(uint8_t * http_message, uint32_t *len, int *chunk_len)
-{
-  uint8_t *p = NULL;
-  char len_str[8] = {0};
-  int i = 0;
-
-  if((*len) < 2)
-  {
-    *len = 0;
-    return NULL;
-  }
-
-  p = http_message;
-  while ((*len) >= 2)
-  {
-    /* the HTTP message chunk is after an empty line (CR-LF) */
-    if (p[0] == '\r'
-        && p[1] == '\n')
-    {
-      *len = (*len) - 2;
-      *chunk_len = (int)strtol(len_str, NULL, 16); // HexToInt
-      return p+2;
-    }
-    else
-    {
-      len_str[i] = *(p);
-    }
-    p++;
-    i++;
-    (*len)--;
-  }
-  *len = 0;
-  /* if not found, return NULL */
-  return NULL;
-}
-
 /**
   * @brief  return the status code from an HTTP response
   * @arg    http_response: pointer to full HTTP response
@@ -983,3 +881,21 @@ int http_transfer_is_chunked(uint8_t * buffer, uint32_t len)
   return 0;
 }
 
+int http_connection_is_close(uint8_t * buffer, uint32_t len)
+{
+  uint8_t *p = NULL;
+  unsigned int length = 0;
+
+#define CONNECTION "Connection: "
+#define CONNECTION_CLOSE "close"
+  for( p = buffer, length = len;
+       (length > sizeof(CONNECTION)) ;
+       p++, length-- )
+  {
+    if (strncasecmp((char *)p, CONNECTION, sizeof(CONNECTION)-1)==0)
+    {
+      return (strncasecmp((char*)p+(sizeof(CONNECTION)-1), CONNECTION_CLOSE, (sizeof(CONNECTION_CLOSE)-1))==0) ? 1 : 0;
+    }
+  }
+  return 0;
+}
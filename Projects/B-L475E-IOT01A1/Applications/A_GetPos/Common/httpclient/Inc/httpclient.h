@@ -22,12 +22,14 @@
  extern "C" {
 #endif
 
+#include "http_lib.h"
+
 void httpclient_test(void const *arg);
-int httpclient_rxn(char *rxn_server_res,
-                   char *rxn_server_auth,
-                   uint8_t *buffer,
-                   uint32_t buffer_size,
-                   char *JsonData);
+int httpclient_rxn_stream(char *rxn_server_res,
+                          char *rxn_server_auth,
+                          http_body_cb_t body_cb,
+                          void *arg,
+                          char *JsonData);
 int httpclient_init(void);
 void httpclient_deinit(void);
 
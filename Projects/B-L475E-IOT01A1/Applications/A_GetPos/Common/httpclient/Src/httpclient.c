@@ -26,10 +26,19 @@
 
 /* Global variables ---------------------------------------------------------*/
 /* Private typedef -----------------------------------------------------------*/
+/* Counts the body bytes passed on to the consumer of a stream */
+typedef struct
+{
+  http_body_cb_t cb;
+  void *arg;
+  uint32_t count;
+} rxn_body_t;
+
 /* Private defines -----------------------------------------------------------*/
 #define NET_READ_TIMEOUT  "2000"
 
-#define BUF_SIZE (20480)
+#define RXN_SERVER_NAME   "api.location.io"
+#define RXN_SERVER_PORT   80
 
 /* Private macros ------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
@@ -37,15 +46,20 @@ http_handle_t Handle;
 const char Httpbin_org_server_name[] = "httpbin.org";
 const char * RootCA = ROOT_CERTIFICATE;
 
+/* The network is brought up once, and the RXN session is kept open between requests */
+static bool net_is_up = false;
+static http_handle_t RxnHandle = NULL;
+
 /* Private function prototypes -----------------------------------------------*/
 int test_http_get_recv(http_handle_t http_handle);
 int test_http_post_send(http_handle_t http_handle);
-int rxn_http_post_send(http_handle_t http_handle,
-                       char *rxn_server_name,
-                       char *rxn_server_auth,
-                       uint8_t *data_buffer,
-                       uint32_t data_buffer_size,
-                       char *JsonData);
+int rxn_http_post_request(http_handle_t http_handle,
+                          char *rxn_server_name,
+                          char *rxn_server_auth,
+                          char *JsonData);
+int rxn_http_connect(char *rxn_server_name, int rxn_server_port);
+static void rxn_http_close(void);
+static int rxn_body_count(void *arg, const uint8_t *data, uint32_t length);
 int test_http_delete_send(http_handle_t http_handle);
 int test_http_put_send(http_handle_t http_handle);
 int test_http_get(http_handle_t http_handle);
@@ -153,16 +167,14 @@ int test_http_post_send(http_handle_t http_handle)
 }
 
 /**
-  * @brief  rxn http post send
+  * @brief  rxn http post request
   * @param  None
-  * @retval None
+  * @retval size sent, <0 on error
   */
-int rxn_http_post_send(http_handle_t http_handle,
-                       char *rxn_server_name,
-                       char *rxn_server_auth,
-                       uint8_t *data_buffer,
-                       uint32_t data_buffer_size,
-                       char *JsonData)
+int rxn_http_post_request(http_handle_t http_handle,
+                          char *rxn_server_name,
+                          char *rxn_server_auth,
+                          char *JsonData)
 {
   uint8_t buffer[1024];
   char content_length_value[16];
@@ -170,11 +182,9 @@ int rxn_http_post_send(http_handle_t http_handle,
   char rxn_server_res[] = "/rxn-api/locationApi";
 
   int ret = 0;
-  int status = 0;
 
   printf("POST SEND rxn(size of buffer=%d).\n", sizeof(buffer));
   memset(buffer, 0, sizeof(buffer));
-  //memset(seed, 0, sizeof(uint8_t)*BUF_SIZE);
 
   ret = http_create_request(HTTP_REQUEST_POST, rxn_server_name, rxn_server_res, buffer, sizeof(buffer));
   msg_debug("http*_create_request() ret=%d\n", ret);
@@ -194,6 +204,9 @@ int rxn_http_post_send(http_handle_t http_handle,
   ret = http_add_header(buffer, sizeof(buffer), "Authorization", rxn_server_auth);
   msg_debug("http_add_header() ret=%d\n", ret);
 
+  ret = http_add_header(buffer, sizeof(buffer), "Connection", "keep-alive");
+  msg_debug("http_add_header() ret=%d\n", ret);
+
   /* body */
   ret = http_add_body(buffer, sizeof(buffer), (uint8_t*)JsonData, strlen(JsonData));
   msg_debug("http_add_body() ret=%d\n", ret);
@@ -201,10 +214,6 @@ int rxn_http_post_send(http_handle_t http_handle,
   ret = http_send(http_handle, buffer, ret);
   msg_debug("http_send() ret=%d\n", ret);
 
-  /* receive response */  
-  ret = http_recv_chunked(http_handle, data_buffer, data_buffer_size, &status);
-  //printf("response body size=%lu:\n%.*s\n", ret, ret, data_buffer);
-
   return ret;
 }
 
@@ -513,23 +522,15 @@ void httpclient_test(void const *arg)
 }
 
 /**
-  * @brief  rxn http client
+  * @brief  rxn http connect: opens the connection to the rxn server
   * @param  None
-  * @retval None
+  * @retval 0 on success, <0 on error
   */
-int httpclient_rxn(char *rxn_server_res,
-                   char *rxn_server_auth,
-                   uint8_t *buffer,
-                   uint32_t buffer_size,
-                   char *JsonData)
+int rxn_http_connect(char *rxn_server_name, int rxn_server_port)
 {
   int ret = 0;
   http_proto_t rxn_http_proto = HTTP_PROTO_HTTP;
-  char rxn_server_name[] = "api.location.io";
-  int rxn_server_port = 80;
 
-  printf("\n**** HTTP client rxn ****\n\n");
-  
   printf("Opening connection to server %s.\n", rxn_server_name);
 
   ret = http_create_session(&Handle, (char*)rxn_server_name, rxn_server_port, rxn_http_proto);
@@ -552,30 +553,109 @@ int httpclient_rxn(char *rxn_server_res,
     printf("error opening connection (%d)\n", ret);
     return ret;
   }
-  
-  ret = rxn_http_post_send(Handle,
-                           rxn_server_name,
-                           rxn_server_auth,
-                           buffer,
-                           buffer_size,
-                           JsonData);
-  msg_debug("rxn_http_post_send() ret=%d\n", ret);
 
-  http_close(Handle);
-  
-  return ret;
+  return 0;
 }
 
 /**
-  * @brief  Initialize application
+  * @brief  rxn http close: closes the kept session to the rxn server
   * @param  None
   * @retval None
   */
+static void rxn_http_close(void)
+{
+  if (RxnHandle != NULL)
+  {
+    (void)http_close(RxnHandle);
+    RxnHandle = NULL;
+  }
+}
+
+/**
+  * @brief  rxn body count: passes the body to the consumer, counting the bytes
+  * @param  None
+  * @retval as the consumer
+  */
+static int rxn_body_count(void *arg, const uint8_t *data, uint32_t length)
+{
+  rxn_body_t *body = (rxn_body_t *)arg;
+
+  body->count += length;
+
+  return body->cb(body->arg, data, length);
+}
+
+/**
+  * @brief  rxn http client, the response body is passed to body_cb as it is received.
+  *         The connection to the server is kept open for the next request: it is
+  *         reopened once when a kept connection fails before any byte of the body.
+  * @param  None
+  * @retval size of the body, <0 on error
+  */
+int httpclient_rxn_stream(char *rxn_server_res,
+                          char *rxn_server_auth,
+                          http_body_cb_t body_cb,
+                          void *arg,
+                          char *JsonData)
+{
+  int ret = 0;
+  int status = 0;
+  char rxn_server_name[] = RXN_SERVER_NAME;
+  rxn_body_t body = { body_cb, arg, 0 };
+  bool reused;
+
+  printf("\n**** HTTP client rxn (stream) ****\n\n");
+
+  do
+  {
+    reused = (RxnHandle != NULL);
+    if (!reused)
+    {
+      Handle = NULL;
+      ret = rxn_http_connect(rxn_server_name, RXN_SERVER_PORT);
+      RxnHandle = Handle;
+      if (ret < 0)
+      {
+        /* The network may be down: bring it up again on the next request */
+        httpclient_deinit();
+        return ret;
+      }
+    }
+    else
+    {
+      printf("Reusing connection to server %s.\n", rxn_server_name);
+    }
+
+    ret = rxn_http_post_request(RxnHandle, rxn_server_name, rxn_server_auth, JsonData);
+    if (ret >= 0)
+    {
+      ret = http_recv_stream(RxnHandle, rxn_body_count, &body, &status);
+      msg_debug("http_recv_stream() ret=%d\n", ret);
+    }
+    if ((ret < 0) || !http_is_open(RxnHandle))
+    {
+      rxn_http_close();
+    }
+  } while ((ret < 0) && reused && (body.count == 0U));
+
+  return ret;
+}
+
+/**
+  * @brief  Initialize application: brings the network up, once
+  * @param  None
+  * @retval 0 on success, -1 on error
+  */
 int httpclient_init(void)
 {
   net_ipaddr_t ipAddress;
   net_macaddr_t macAddr;
   
+  if (net_is_up)
+  {
+    return 0;
+  }
+
   printf("\n**** HTTP client init ****\n");
 
   if (net_init(&hnet, NET_IF, (net_if_init)) != NET_OK)
@@ -592,6 +672,7 @@ int httpclient_init(void)
   else
   {
     printf("error getting mac address\n");
+    net_deinit(hnet, (net_if_deinit));
 
     return -1;
   }
@@ -605,6 +686,7 @@ int httpclient_init(void)
   if (net_get_ip_address(hnet, &ipAddress) != NET_OK)
   {
     msg_error("error retrieving IP address");
+    net_deinit(hnet, (net_if_deinit));
     return -1;
   }
   else
@@ -622,18 +704,24 @@ int httpclient_init(void)
   }
 
   /* end of configuration verification */
+  net_is_up = true;
   
   return 0;
 }
 
 /**
-  * @brief  deinit application
+  * @brief  deinit application: closes the kept session and brings the network down
   * @param  None
   * @retval None
   */
 void httpclient_deinit(void)
 {
-  net_deinit(hnet, (net_if_deinit));
+  rxn_http_close();
+  if (net_is_up)
+  {
+    net_deinit(hnet, (net_if_deinit));
+    net_is_up = false;
+  }
 }
 
 /* needed by cloud.c */
@@ -85,6 +85,14 @@ void AppAGNSS_ConvertPRSeed(int seedMask);
   */
 void AppAGNSS_ConvertRTSeed(int seedMask);
 
+/**
+  * @brief  Send the seeds still valid in the flash cache (CONFIG_USE_SEED_CACHE)
+  * @param  seedMask Constellation mask
+  * @param  seedReq Type of Assisted GNSS (PR/RT)
+  * @retval Mask of the constellations sent from the cache
+  */
+int AppAGNSS_RestoreSeed(int seedMask, seed_req_t seedReq);
+
 /**
   * @}
   */
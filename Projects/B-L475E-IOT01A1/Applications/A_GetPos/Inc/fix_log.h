@@ -0,0 +1,85 @@
+/**
+  ******************************************************************************
+  * @file    fix_log.h
+  * @author  SRA Application Team
+  * @brief   Header for fix_log.c: append-only log of GNSS fixes in the
+  *          internal flash memory.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FIX_LOG_H
+#define FIX_LOG_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "gnss_parser.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The log area is a ring of flash pages at the end of the second bank.
+ * It must be kept out of the linker ROM regions of all the toolchains.
+ * A page holds 85 records, the ring 5440: one fix every FIXLOG_PERIOD
+ * seconds keeps about 3.7 days of positions, and each page is erased once
+ * per lap, i.e. every 3.8 days (about 100 cycles a year).
+ * Logging every fix at 1 Hz would keep 1.5 hours only and erase each page
+ * 16 times a day.
+ */
+#ifndef FIXLOG_BASE_ADDR
+#define FIXLOG_BASE_ADDR    0x080E0000U
+#endif /* FIXLOG_BASE_ADDR */
+
+#ifndef FIXLOG_PAGE_NBR
+#define FIXLOG_PAGE_NBR     64U
+#endif /* FIXLOG_PAGE_NBR */
+
+/* Minimum time between two logged fixes, in seconds */
+#ifndef FIXLOG_PERIOD
+#define FIXLOG_PERIOD       60U
+#endif /* FIXLOG_PERIOD */
+
+#define FIXLOG_OK      0
+#define FIXLOG_ERROR  -1
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief One fix as stored in flash (3 double-words).
+  */
+typedef struct
+{
+  uint32_t utc;      /**< UTC time, hhmmss */
+  uint32_t date;     /**< Date, ddmmyy (0 if no RMC has been received yet) */
+  int32_t  lat;      /**< Latitude in 1e-7 degrees, north positive */
+  int32_t  lon;      /**< Longitude in 1e-7 degrees, east positive */
+  int32_t  alt;      /**< Altitude in decimeters */
+  uint8_t  sats;     /**< Number of satellites used */
+  uint8_t  valid;    /**< GGA fix quality */
+  uint16_t crc;      /**< CRC16-CCITT of the previous fields */
+} FIXLOG_Record_t;
+
+/* Exported functions --------------------------------------------------------*/
+int32_t  FIXLOG_Init(void);
+int32_t  FIXLOG_Sample(const GNSSParser_Data_t *pGNSSParser_Data, FIXLOG_Record_t *pRecord);
+int32_t  FIXLOG_Append(const FIXLOG_Record_t *pRecord);
+int32_t  FIXLOG_Read(uint32_t *pCursor, FIXLOG_Record_t *pRecords, uint32_t nbr);
+int32_t  FIXLOG_Erase(void);
+uint32_t FIXLOG_GetCount(void);
+void     FIXLOG_Print(const FIXLOG_Record_t *pRecord);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIX_LOG_H */
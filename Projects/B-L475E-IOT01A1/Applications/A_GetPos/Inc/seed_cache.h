@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    seed_cache.h
+  * @author  SRA Application Team
+  * @brief   Header for seed_cache.c: converted A-GNSS seeds kept in the
+  *          internal flash memory with their validity window.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef SEED_CACHE_H
+#define SEED_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include "assisted_gnss.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The cache area is made of one slot per seed request (PR/RT) and constellation,
+ * just below the fix log. It must be kept out of the linker ROM regions of all
+ * the toolchains.
+ */
+#ifndef SEEDCACHE_BASE_ADDR
+#define SEEDCACHE_BASE_ADDR    0x080D0000U
+#endif /* SEEDCACHE_BASE_ADDR */
+
+#define SEEDCACHE_SLOT_SIZE    (4U * 2048U)
+#define SEEDCACHE_SLOT_NBR     8U
+
+/* Validity of a seed from the time it is downloaded */
+#ifndef SEEDCACHE_PR_VALIDITY
+#define SEEDCACHE_PR_VALIDITY  (3U * SECS_PER_DAY)
+#endif /* SEEDCACHE_PR_VALIDITY */
+
+#ifndef SEEDCACHE_RT_VALIDITY
+#define SEEDCACHE_RT_VALIDITY  (2U * SECS_PER_HOUR)
+#endif /* SEEDCACHE_RT_VALIDITY */
+
+#define SEEDCACHE_OK      0
+#define SEEDCACHE_ERROR  -1
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief One piece of the data of a seed, stored back to back with the others.
+  */
+typedef struct
+{
+  const void *data;
+  uint32_t    len;
+} SEEDCACHE_Seg_t;
+
+/* Exported functions --------------------------------------------------------*/
+int32_t        SEEDCACHE_Store(seed_req_t seedReq, seed_type_t seedType, uint32_t gpsStart, uint32_t gpsEnd,
+                               const SEEDCACHE_Seg_t *pSegs, uint32_t nbr);
+const uint8_t *SEEDCACHE_Get(seed_req_t seedReq, seed_type_t seedType, uint32_t gpsNow, uint32_t *pLen);
+int32_t        SEEDCACHE_Erase(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEED_CACHE_H */
@@ -46,6 +46,20 @@ extern "C" {
 
 #define CONFIG_USE_DATALOG 0 /* Datalog off */
 
+#define CONFIG_USE_QUEUE_PRIO 0 /* Queue full: the incoming sentence is dropped */
+
+#define CONFIG_USE_QUEUE_BATCH 0 /* Consumer task dequeues one sentence at a time */
+
+#define CONFIG_USE_QUEUE_BCAST 0 /* Single reader of the NMEA stream */
+
+#define CONFIG_USE_STATIC_BUS 0 /* Driver calls the bus through the IO function pointers */
+
+#define CONFIG_USE_TRACE 0 /* Receive path trace off */
+
+#define CONFIG_USE_FIXLOG 0 /* Fix log in MCU flash off */
+
+#define CONFIG_USE_SEED_CACHE 0 /* A-GNSS seed cache in MCU flash off */
+
 #if (GNSS_DEBUG == 1)
 #define PRINT_DBG(pBuffer)  GNSS_PRINT(pBuffer)
 #else
@@ -23,27 +23,129 @@
 #include "assisted_gnss.h"
 #include "gnss_ephemeris.h"
 #include "gnss_almanac.h"
+#include "http_lib.h"
 #include "httpclient.h"
-#include "cJSON.h"
 #include "mbedtls/base64.h"
+#include "heap.h"
 #include "gnss1a1_conf.h"
+#include "teseo_liv3f_conf.h"
+
+#if (CONFIG_USE_SEED_CACHE == 1)
+#include "seed_cache.h"
+#endif /* CONFIG_USE_SEED_CACHE */
 
 /* Defines -------------------------------------------------------------------*/
 /* #define PRINT_JSON */
 #define PROPAGATE_PR_SEED
 #define PROPAGATE_RT_SEED
 
+/* Max number of values decoded from the "body" of the seed */
+#define SEED_REC_MAX      20U
+/* Max nesting of the seed JSON */
+#define SEED_DEPTH_MAX    8U
+/* Max length (with the terminator) of the keys looked for */
+#define SEED_KEY_MAX      16U
+/* Bytes checked at the beginning and at the end of the seed */
+#define SEED_HEAD_LEN     20U
+#define SEED_TAIL_LEN     15U
+
+/* Decoded EPH/ALM entries of a RT conversion */
+#define SEED_RT_SAT_MAX   64U
+
+/* Seed refresh session: the records decoded from a PR seed of all the constellations,
+   or the records and decoded EPH/ALM of a RT seed of one constellation */
+#define SEED_ARENA_PR_SIZE  ((4U * (MAX_BLOCK_TYPE_SIZE + MAX_TIME_MODEL_SIZE + MAX_SLOT_FREQ_SIZE)) + \
+                             BUF_SIZE_5K + (3U * BUF_SIZE_4K))
+#define SEED_ARENA_RT_SIZE  ((3U * BUF_SIZE_2K) + \
+                             (SEED_RT_SAT_MAX * (sizeof(ephemeris_raw_t) + sizeof(almanac_raw_t))))
+/* 8 bytes of alignment per block */
+#define SEED_ARENA_SIZE     (((SEED_ARENA_PR_SIZE > SEED_ARENA_RT_SIZE) ? SEED_ARENA_PR_SIZE : SEED_ARENA_RT_SIZE) + \
+                             (8U * (SEED_REC_MAX + 2U)))
+
+/* Private types -------------------------------------------------------------*/
+/* A value decoded on the fly: body.<group>.<key> (PR) or body[].<key> (RT) */
+typedef struct
+{
+  const char *group;     /* NULL when body is an array */
+  const char *key;
+  uint8_t *buf;          /* base64 values are decoded here */
+  size_t size;
+  size_t len;
+  int32_t *num;          /* integer values are stored here */
+  uint8_t done;
+} seed_rec_t;
+
+/* State of the decoder, kept from one received chunk to the next */
+typedef struct
+{
+  char type[SEED_DEPTH_MAX];                 /* '{' or '[' */
+  char key[SEED_DEPTH_MAX][SEED_KEY_MAX];    /* last key of each object */
+  uint16_t key_len[SEED_DEPTH_MAX];          /* SEED_KEY_MAX when too long */
+  uint32_t depth;
+  uint32_t body;                             /* depth of the body container */
+  uint8_t expect_key;
+  uint8_t in_key;
+  uint8_t in_str;
+  uint8_t in_num;
+  uint8_t esc;
+  seed_rec_t *rec;                           /* record of the value being scanned */
+  uint8_t quad[4];                           /* base64 characters not decoded yet */
+  uint8_t quad_len;
+  int32_t num;
+  uint8_t neg;
+  uint8_t frac;
+  uint32_t count;                            /* bytes received */
+  uint32_t max;                              /* bytes expected at most */
+  uint8_t head[SEED_HEAD_LEN];
+  uint8_t tail[SEED_TAIL_LEN];               /* circular, the oldest byte at count % SEED_TAIL_LEN */
+  int err;
+} seed_stream_t;
+
+#if (CONFIG_USE_SEED_CACHE == 1)
+/* Converted PR seed as kept in the cache, followed by the seed itself */
+typedef struct
+{
+  int32_t curr_secs;
+  int32_t next_gps_time;
+  int32_t next_secs;
+  uint32_t seed_size;
+  uint16_t nsat;
+  uint16_t max_satid;
+  uint32_t reserved;
+  uint8_t block_types[MAX_BLOCK_TYPE_SIZE];
+  uint8_t slot_freq[MAX_SLOT_FREQ_SIZE];
+  uint8_t time_model[MAX_TIME_MODEL_SIZE];
+} seed_cache_pr_t;
+
+/* Converted RT seed as kept in the cache, followed by the decoded EPH and ALM */
+typedef struct
+{
+  uint32_t num_sat_eph;
+  uint32_t num_sat_alm;
+  uint8_t sat_id[SEED_RT_SAT_MAX];
+} seed_cache_rt_t;
+
+#define SEED_CACHE_RT_LEN   (sizeof(seed_cache_rt_t) + \
+                             (SEED_RT_SAT_MAX * (sizeof(ephemeris_raw_t) + sizeof(almanac_raw_t))))
+#endif /* CONFIG_USE_SEED_CACHE */
+
 /* Global variables ----------------------------------------------------------*/
 
 extern RTC_HandleTypeDef hrtc;
 
 /* Private variables ---------------------------------------------------------*/
 static seed_info_t seed_info;
+static seed_rec_t seed_rec[SEED_REC_MAX];
+static uint32_t seed_rec_nbr;
+static seed_stream_t seed_stream;
+/* All the buffers of a seed refresh, released at once when it ends */
+static uint64_t seed_arena_buf[(SEED_ARENA_SIZE + 7U) / 8U];
+static heap_arena_t seed_arena;
 
 /* Private functions -----------------------------------------------------------*/
 
 /* Checks the seed validity */
-static int seed_valid(uint8_t *seed, int32_t len, seed_req_t seedReq)
+static int seed_valid(seed_req_t seedReq)
 {
   uint8_t pr_open[]  = "[{\"ee\":{\"body\"";
   uint8_t pr_close[] = "\"status\":200}}]";
@@ -68,17 +170,24 @@ static int seed_valid(uint8_t *seed, int32_t len, seed_req_t seedReq)
     return -1;
   }
 
-  if (len <= 0)
+  if ((seed_stream.err != 0) || (seed_stream.count < (SEED_HEAD_LEN + SEED_TAIL_LEN)))
   {
     return -1;
   }
-  /* Examine the beginning of the buffer, it should be [{\"ee\":{\"body\" */
-  if (memcmp((void *)seed, (void *)open, strlen((char *)open)) != 0)
+  /* Examine the beginning of the seed, it should be [{\"ee\":{\"body\" */
+  if (memcmp((void *)seed_stream.head, (void *)open, strlen((char *)open)) != 0)
   {
     return -2;
   }
   /* Examine the last 15 bytes of the seed, if they are \"status\":200}}] then the seed is complete */
-  if (memcmp((void *)(seed + (len - 15)), (void *)close, strlen((char *)close)) != 0)
+  for (uint32_t i = 0; i < SEED_TAIL_LEN; i++)
+  {
+    if (seed_stream.tail[(seed_stream.count + i) % SEED_TAIL_LEN] != close[i])
+    {
+      return -3;
+    }
+  }
+  if (seed_stream.depth != 0U)
   {
     return -3;
   }
@@ -86,338 +195,569 @@ static int seed_valid(uint8_t *seed, int32_t len, seed_req_t seedReq)
   return 0;
 }
 
-/* Prints seed in Json format */
-#ifdef PRINT_JSON
-static void printJson(uint8_t *jsonBuffer)
+/* Looks for the record of body.<group>.<key> */
+static seed_rec_t *findSeedRec(const char *group, const char *key)
 {
-  cJSON *root = cJSON_Parse((char *)jsonBuffer);
-
-  if (root != NULL)
+  for (uint32_t i = 0; i < seed_rec_nbr; i++)
   {
-    char *str = cJSON_Print(root);
-    /* Free memory */
-    if (str != NULL)
+    seed_rec_t *rec = &seed_rec[i];
+
+    if ((strcmp(rec->key, key) == 0) &&
+        (((group == NULL) && (rec->group == NULL)) ||
+         ((group != NULL) && (rec->group != NULL) && (strcmp(rec->group, group) == 0))))
     {
-      (void)printf("root_str=%s\n", str);
-      free(str);
+      return rec;
     }
-    cJSON_Delete(root);
   }
+
+  return NULL;
 }
-#endif /* PRINT_JSON */
 
-/* Decodes Leap Sec part */
-static int decodeJsonLeapsec(void)
+/* Adds a record decoded from base64 into a buffer of size bytes */
+static int addSeedRec(const char *group, const char *key, size_t size)
 {
-  /* First, parse the whole seed */
-  cJSON *root = cJSON_Parse((char *)seed_info.jsonBuffer);
-  if (root == NULL)
+  seed_rec_t *rec;
+
+  if (seed_rec_nbr == SEED_REC_MAX)
   {
     return -1;
   }
-
-  cJSON *child = root->child;
-  while (child != NULL && strcmp(child->string, "body") != 0)
+  rec = &seed_rec[seed_rec_nbr];
+  (void)memset(rec, 0, sizeof(seed_rec_t));
+  rec->buf = (uint8_t *)heap_arena_alloc(&seed_arena, sizeof(uint8_t) * size);
+  if (rec->buf == NULL)
   {
-    child = child->child;
+    return -1;
   }
-  if (child != NULL)
+  (void)memset(rec->buf, 0, sizeof(uint8_t) * size);
+  rec->group = group;
+  rec->key = key;
+  rec->size = size;
+  seed_rec_nbr++;
+
+  return 0;
+}
+
+/* Adds a record holding an integer */
+static int addSeedInt(const char *group, const char *key, int32_t *num)
+{
+  if (seed_rec_nbr == SEED_REC_MAX)
   {
-    int items_count = cJSON_GetArraySize(child);
-    for (int i = 0; i < items_count; i++)
-    {
-      /* Get the JSON element and then get the values */
-      cJSON *item = cJSON_GetArrayItem(child, i);
-      if (strcmp(item->string, "leap") == 0)
-      {
-        seed_info.curr_secs = cJSON_GetObjectItem(item, "currSecs")->valueint;
-        seed_info.next_gps_time = cJSON_GetObjectItem(item, "nextGpsTime")->valueint;
-        seed_info.next_secs = cJSON_GetObjectItem(item, "nextSecs")->valueint;
-        printf("curr_secs(%ld), next_gps_time(%ld) next_secs(%ld)\n", seed_info.curr_secs, seed_info.next_gps_time,
-               seed_info.next_secs);
-        break;
-      }
-    }
+    return -1;
   }
-  /* Free memory */
-  cJSON_Delete(root);
+  (void)memset(&seed_rec[seed_rec_nbr], 0, sizeof(seed_rec_t));
+  seed_rec[seed_rec_nbr].group = group;
+  seed_rec[seed_rec_nbr].key = key;
+  seed_rec[seed_rec_nbr].num = num;
+  seed_rec_nbr++;
 
   return 0;
 }
 
-/* Parses JSON containing Seed info (PR-GNSS) */
-static size_t decodeJsonSeed(seed_type_t seed_type)
+/* Releases the decoded records, and all the buffers of the seed refresh */
+static void freeSeedRec(void)
 {
-  char req[8] = {0};
-  size_t len_block_type;
-  size_t len_slot_freq;
-  size_t len_time_model;
-  size_t len_seed = 0;
-
-  /* First, parse the whole seed */
-  cJSON *root = cJSON_Parse((char *)seed_info.jsonBuffer);
-  if (root == NULL)
+  if (seed_arena.base == NULL)
   {
-    AGNSS_PRINT_OUT("ERROR: Json root is NULL\n");
-    return 0;
+    heap_arena_init(&seed_arena, seed_arena_buf, sizeof(seed_arena_buf));
+  }
+  else if (seed_rec_nbr != 0U)
+  {
+    printf("Seed arena: %u/%u bytes used (peak %u)\n", seed_arena.used, seed_arena.size, seed_arena.peak);
+  }
+  else
+  {
+    /* Nothing to report */
+  }
+  for (uint32_t i = 0; i < seed_rec_nbr; i++)
+  {
+    seed_rec[i].buf = NULL;
   }
+  seed_rec_nbr = 0;
+  heap_arena_reset(&seed_arena);
+}
+
+/* Constellation names used as group (PR) or key (RT) in the seed */
+static const char *seedName(seed_type_t seed_type, seed_req_t seedReq, int nkc)
+{
+  static const char *const pr_name[] = { "gps", "glonass", "galileo", "beidou" };
+  static const char *const eph_name[] = { "GPS:1NAC", "GLO:2NAC", "GAL:2NAC", "BDS:2NAC" };
+  static const char *const alm_name[] = { "GPS:1ALM", "GLO:2ALM", "GAL:2ALM", "BDS:2ALM" };
 
-  switch (seed_type)
+  if ((seed_type < GPS_SEED) || (seed_type > BEI_SEED))
   {
-    case GPS_SEED:
-      strcpy(req, "gps");
-      break;
-    case GLO_SEED:
-      strcpy(req, "glonass");
-      break;
-    case GAL_SEED:
-      strcpy(req, "galileo");
-      break;
-    case BEI_SEED:
-      strcpy(req, "beidou");
-      break;
-    default:
-      AGNSS_PRINT_OUT("ERROR: Unknown constellation\n");
+    AGNSS_PRINT_OUT("ERROR: Unknown constellation\n");
+    return NULL;
   }
+  if (seedReq == PR_SEED)
+  {
+    return pr_name[seed_type - GPS_SEED];
+  }
+
+  return (nkc != 0) ? alm_name[seed_type - GPS_SEED] : eph_name[seed_type - GPS_SEED];
+}
 
-  cJSON *child = root->child;
-  while (child != NULL && strcmp(child->string, "body") != 0)
+/* Sets up the records of the values to be decoded from the seed, before the download */
+static int initSeedRec(int seedMask, seed_req_t seedReq)
+{
+  /* same buffer sizes as when the whole JSON was buffered */
+  static const uint16_t pr_size[] = { BUF_SIZE_5K, BUF_SIZE_4K, BUF_SIZE_4K, BUF_SIZE_4K };
+  static const uint16_t eph_size[] = { BUF_SIZE_3K, BUF_SIZE_2K, BUF_SIZE_2K, BUF_SIZE_2K };
+  static const uint16_t alm_size[] = { BUF_SIZE_2K, BUF_SIZE_2K, BUF_SIZE_1K, BUF_SIZE_1K };
+  int ret = 0;
+
+  freeSeedRec();
+  seed_info.curr_secs = 0;
+  seed_info.next_gps_time = 0;
+  seed_info.next_secs = 0;
+  if (seedReq == PR_SEED)
   {
-    child = child->child;
+    ret |= addSeedInt("leap", "currSecs", &seed_info.curr_secs);
+    ret |= addSeedInt("leap", "nextGpsTime", &seed_info.next_gps_time);
+    ret |= addSeedInt("leap", "nextSecs", &seed_info.next_secs);
   }
-  if (child != NULL)
+  for (seed_type_t t = GPS_SEED; (t <= BEI_SEED) && (ret == 0); t++)
   {
-    int items_count = cJSON_GetArraySize(child);
-    for (int i = 0; i < items_count; i++)
+    if ((seedMask & (1 << (t - GPS_SEED))) == 0)
     {
-      /* Get the JSON element and then get the values */
-      cJSON *item = cJSON_GetArrayItem(child, i);
-      if (strcmp(item->string, req) == 0)
+      continue;
+    }
+    if (seedReq == PR_SEED)
+    {
+      ret |= addSeedRec(seedName(t, seedReq, 0), "blockTypes", MAX_BLOCK_TYPE_SIZE);
+      ret |= addSeedRec(seedName(t, seedReq, 0), "timeModel", MAX_TIME_MODEL_SIZE);
+      ret |= addSeedRec(seedName(t, seedReq, 0), "slotFreq", MAX_SLOT_FREQ_SIZE);
+      ret |= addSeedRec(seedName(t, seedReq, 0), "seed", pr_size[t - GPS_SEED]);
+    }
+    else
+    {
+      ret |= addSeedRec(NULL, seedName(t, seedReq, 0), eph_size[t - GPS_SEED]);
+      if (t == GLO_SEED)
       {
-        /* Get the JSON element and then get the values */
-        cJSON *bt_item = cJSON_GetObjectItem(item, "blockTypes");
-        if (bt_item != NULL)
-        {
-          char *block_types_str = bt_item->valuestring;
-          mbedtls_base64_decode(seed_info.block_types,
-                                MAX_BLOCK_TYPE_SIZE,
-                                &len_block_type,
-                                (unsigned char *)block_types_str,
-                                strlen(block_types_str));
-          /* printf( "Block Types (base64):\n" ); */
-          /* for(int k=0; k<len_block_type; k++) */
-          /* printf( "0x%02X,", seed_info.block_types[k] );  */
-          /* printf( "\n" ); */
-        }
-        /* Get the JSON element and then get the values */
-        cJSON *tm_item = cJSON_GetObjectItem(item, "timeModel");
-        if (tm_item != NULL)
-        {
-          char *time_model_str = tm_item->valuestring;
-          mbedtls_base64_decode(seed_info.time_model,
-                                MAX_TIME_MODEL_SIZE,
-                                &len_time_model,
-                                (unsigned char *)time_model_str,
-                                strlen(time_model_str));
-          /* printf( "Time Model (base64):\n" ); */
-          /* for(int k=0; k<len_time_model; k++) */
-          /* printf( "0x%02X,", seed_info.time_model[k] ); */
-          /* printf( "\n" ); */
-        }
-        /* Get the JSON element and then get the values */
-        cJSON *sf_item = cJSON_GetObjectItem(item, "slotFreq");
-        if (sf_item != NULL)
-        {
-          char *slot_freq_str = sf_item->valuestring;
-          mbedtls_base64_decode(seed_info.slot_freq,
-                                MAX_SLOT_FREQ_SIZE,
-                                &len_slot_freq,
-                                (unsigned char *)slot_freq_str,
-                                strlen(slot_freq_str));
-          /* printf( "Slot Freq (base64):\n" ); */
-          /* for(int k=0; k<len_slot_freq; k++) */
-          /* printf( "0x%02X,", seed_info.slot_freq[k] ); */
-          /* printf( "\n" ); */
-        }
-        /* Get the JSON element and then get the values */
-        cJSON *s_item = cJSON_GetObjectItem(item, "seed");
-        if (s_item != NULL)
-        {
-          char *seed_str = s_item->valuestring;
-          mbedtls_base64_decode(seed_info.seed,
-                                seed_info.seed_size,
-                                &len_seed,
-                                (unsigned char *)seed_str,
-                                strlen(seed_str));
-
-          printf("Seed (seed_size %d, base64 - len %d):\n", seed_info.seed_size, len_seed);
-          /* for(int k=0; k<len_seed; k++) */
-          /* printf( "0x%02X,", seed_info.seed[k]); */
-          /* printf( "\n" ); */
-        }
+        ret |= addSeedRec(NULL, "GLO:2NKC", eph_size[t - GPS_SEED]);
       }
+      ret |= addSeedRec(NULL, seedName(t, seedReq, 1), alm_size[t - GPS_SEED]);
+      /* only the first constellation is converted in RT */
+      break;
     }
   }
-  /* Free memory */
-  cJSON_Delete(root);
+  if (ret != 0)
+  {
+    freeSeedRec();
+  }
 
-  return len_seed;
+  return ret;
 }
 
-/* Parses JSON containing Ephemeris info (RT-GNSS) */
-static void decodeJsonEph(seed_type_t seed_type)
+/* Completes the record of the value just scanned */
+static void endSeedValue(seed_stream_t *s)
 {
-  char req[10] = {0};
-  char req_nkc[10] = {0};
-  size_t len_eph_seed = 0;
-  size_t len_eph_nkc_seed = 0;
+  seed_rec_t *rec = s->rec;
 
-  /* First, parse the whole seed */
-  cJSON *root = cJSON_Parse((char *)seed_info.jsonBuffer);
-  if (root == NULL)
+  if (rec == NULL)
   {
-    AGNSS_PRINT_OUT("ERROR: EPH Json root is NULL\n");
     return;
   }
+  if (rec->num != NULL)
+  {
+    *rec->num = (s->neg != 0U) ? -s->num : s->num;
+  }
+  else if (s->quad_len != 0U)
+  {
+    /* not a multiple of 4 characters */
+    s->err = -1;
+  }
+  else
+  {
+    printf("%s%s%s decoded (%d bytes)\n", (rec->group != NULL) ? rec->group : "",
+           (rec->group != NULL) ? "." : "", rec->key, rec->len);
+  }
+  rec->done = 1;
+  s->rec = NULL;
+}
 
-  switch (seed_type)
+/* Decodes the base64 characters of the value, 4 at a time */
+static void decodeSeedChar(seed_stream_t *s, uint8_t c)
+{
+  seed_rec_t *rec = s->rec;
+  size_t len = 0;
+
+  if ((rec == NULL) || (rec->buf == NULL))
   {
-    case GPS_SEED:
-      strcpy(req, "GPS:1NAC");
-      break;
-    case GLO_SEED:
-      strcpy(req, "GLO:2NAC");
-      strcpy(req_nkc, "GLO:2NKC");
-      break;
-    case GAL_SEED:
-      strcpy(req, "GAL:2NAC");
-      break;
-    case BEI_SEED:
-      strcpy(req, "BDS:2NAC");
-      break;
-    default:
-      AGNSS_PRINT_OUT("ERROR: Unknown constellation\n");
+    return;
   }
+  s->quad[s->quad_len++] = c;
+  if (s->quad_len == 4U)
+  {
+    s->quad_len = 0;
+    if (mbedtls_base64_decode(&rec->buf[rec->len], rec->size - rec->len, &len, s->quad, 4) != 0)
+    {
+      s->err = -1;
+      return;
+    }
+    rec->len += len;
+  }
+}
 
-  cJSON *child = root->child;
-  while (child != NULL && strcmp(child->string, "body") != 0)
+/* Looks for the record of a value starting at the current position */
+static void startSeedValue(seed_stream_t *s)
+{
+  const char *group = NULL;
+
+  s->rec = NULL;
+  s->quad_len = 0;
+  /* A value of a member of the objects inside body */
+  if ((s->body == 0U) || (s->depth != (s->body + 1U)) || (s->type[s->depth - 1U] != '{') ||
+      (s->key_len[s->depth - 1U] >= SEED_KEY_MAX))
   {
-    child = child->child;
+    return;
   }
-  if (child != NULL)
+  if (s->type[s->body - 1U] == '{')
   {
-    int items_count = cJSON_GetArraySize(child);
-    for (int i = 0; i < items_count; i++)
+    if (s->key_len[s->body - 1U] >= SEED_KEY_MAX)
     {
-      cJSON *subitem = cJSON_GetArrayItem(child, i);
-      cJSON *eph = cJSON_GetObjectItem(subitem, req);
-      if (eph != NULL)
+      return;
+    }
+    group = s->key[s->body - 1U];
+  }
+  s->rec = findSeedRec(group, s->key[s->depth - 1U]);
+}
+
+/* Scans one character of the seed JSON */
+static void scanSeedChar(seed_stream_t *s, char c)
+{
+  uint32_t d;
+
+  if (s->in_str != 0U)
+  {
+    if ((s->esc == 0U) && (c == '\\'))
+    {
+      s->esc = 1;
+    }
+    else if ((s->esc == 0U) && (c == '"'))
+    {
+      s->in_str = 0;
+      if (s->in_key == 0U)
+      {
+        endSeedValue(s);
+      }
+    }
+    else if (s->in_key != 0U)
+    {
+      s->esc = 0;
+      d = s->depth - 1U;
+      if (s->key_len[d] < (SEED_KEY_MAX - 1U))
+      {
+        s->key[d][s->key_len[d]++] = c;
+        s->key[d][s->key_len[d]] = '\0';
+      }
+      else
       {
-        char *seed_str = eph->valuestring;
-        mbedtls_base64_decode(seed_info.eph_seed,
-                              seed_info.eph_seed_size,
-                              &len_eph_seed,
-                              (unsigned char *)seed_str,
-                              strlen(seed_str));
-
-        printf("Eph Seed (base64 - bytes written %d):\n", len_eph_seed);
-        /*        for(int k=0; k<len_eph_seed; k++) */
-        /*          printf( "0x%02X,", seed_info.eph_seed[k] ); */
-        /*        printf( "\n" ); */
+        s->key_len[d] = SEED_KEY_MAX;
       }
     }
+    else
+    {
+      s->esc = 0;
+      decodeSeedChar(s, (uint8_t)c);
+    }
+    return;
+  }
 
-    if (seed_type == GLO_SEED)
+  if (s->in_num != 0U)
+  {
+    if ((c >= '0') && (c <= '9'))
     {
-      for (int i = 0; i < items_count; i++)
+      s->num = (s->frac == 0U) ? ((s->num * 10) + (c - '0')) : s->num;
+      return;
+    }
+    if ((c == '.') || (c == 'e') || (c == 'E') || (c == '+') || (c == '-'))
+    {
+      s->frac = 1;
+      return;
+    }
+    s->in_num = 0;
+    endSeedValue(s);
+    /* c is scanned below */
+  }
+
+  switch (c)
+  {
+    case '{':
+    case '[':
+      if (s->depth == SEED_DEPTH_MAX)
+      {
+        s->err = -1;
+        return;
+      }
+      if ((s->depth > 0U) && (strcmp(s->key[s->depth - 1U], "body") == 0))
+      {
+        s->body = s->depth + 1U;
+      }
+      s->type[s->depth] = c;
+      s->key[s->depth][0] = '\0';
+      s->key_len[s->depth] = 0;
+      s->depth++;
+      s->expect_key = (c == '{');
+      break;
+    case '}':
+    case ']':
+      if (s->depth == 0U)
+      {
+        s->err = -1;
+        return;
+      }
+      s->depth--;
+      if (s->depth < s->body)
       {
-        cJSON *subitem = cJSON_GetArrayItem(child, i);
-        cJSON *eph = cJSON_GetObjectItem(subitem, req_nkc);
-        if (eph != NULL)
+        s->body = 0;
+      }
+      break;
+    case ',':
+      s->expect_key = (s->depth > 0U) && (s->type[s->depth - 1U] == '{');
+      break;
+    case ':':
+      s->expect_key = 0;
+      break;
+    case '"':
+      s->in_str = 1;
+      s->esc = 0;
+      s->in_key = s->expect_key;
+      if (s->in_key != 0U)
+      {
+        if (s->depth == 0U)
         {
-          char *seed_str = eph->valuestring;
-          mbedtls_base64_decode(seed_info.eph_nkc_seed,
-                                seed_info.eph_nkc_seed_size,
-                                &len_eph_nkc_seed,
-                                (unsigned char *)seed_str,
-                                strlen(seed_str));
-
-          printf("Eph NKC Seed (base64 - bytes written %d):\n", len_eph_nkc_seed);
-          /*          for(int k=0; k<len_eph_nkc_seed; k++) */
-          /*            printf( "0x%02X,", seed_info.eph_nkc_seed[k] ); */
-          /*          printf( "\n" ); */
+          s->err = -1;
+          return;
         }
+        s->key[s->depth - 1U][0] = '\0';
+        s->key_len[s->depth - 1U] = 0;
       }
+      else
+      {
+        startSeedValue(s);
+      }
+      break;
+    default:
+      if ((c == '-') || ((c >= '0') && (c <= '9')))
+      {
+        s->in_num = 1;
+        s->neg = (c == '-');
+        s->frac = 0;
+        s->num = (c == '-') ? 0 : (c - '0');
+        startSeedValue(s);
+      }
+      /* else blanks, true, false, null */
+      break;
+  }
+}
+
+/* Consumes a piece of the HTTP body: the values are decoded as soon as they are received */
+static int feedSeed(void *arg, const uint8_t *data, uint32_t len)
+{
+  seed_stream_t *s = &seed_stream;
+
+  (void)arg;
+#ifdef PRINT_JSON
+  (void)printf("%.*s", (int)len, (const char *)data);
+#endif /* PRINT_JSON */
+  for (uint32_t i = 0; (i < len) && (s->err == 0); i++)
+  {
+    if (s->count < SEED_HEAD_LEN)
+    {
+      s->head[s->count] = data[i];
     }
+    s->tail[s->count % SEED_TAIL_LEN] = data[i];
+    s->count++;
+    scanSeedChar(s, (char)data[i]);
   }
-  /* Free memory */
-  cJSON_Delete(root);
+  if ((s->err == 0) && (s->count > s->max))
+  {
+    s->err = -1;
+  }
+
+  return s->err;
 }
 
-/* Parses JSON containing Alamnac info (RT-GNSS) */
-static void decodeJsonAlm(seed_type_t seed_type)
+/* Picks the Leap Sec part */
+static int decodeJsonLeapsec(void)
 {
-  char req[10] = {0};
-  size_t len_alm_seed = 0;
+  const seed_rec_t *rec = findSeedRec("leap", "currSecs");
 
-  /* First, parse the whole seed */
-  cJSON *root = cJSON_Parse((char *)seed_info.jsonBuffer);
-  if (root == NULL)
+  if ((rec == NULL) || (rec->done == 0U))
   {
-    AGNSS_PRINT_OUT("ERROR: ALM Json root is NULL\n");
-    return;
+    return -1;
   }
 
-  switch (seed_type)
+  printf("curr_secs(%ld), next_gps_time(%ld) next_secs(%ld)\n", seed_info.curr_secs, seed_info.next_gps_time,
+         seed_info.next_secs);
+
+  return 0;
+}
+
+/* Copies a table decoded from the seed */
+static void copySeedRec(const char *group, const char *key, uint8_t *buf, size_t size)
+{
+  const seed_rec_t *rec = findSeedRec(group, key);
+
+  if (rec != NULL)
   {
-    case GPS_SEED:
-      strcpy(req, "GPS:1ALM");
-      break;
-    case GLO_SEED:
-      strcpy(req, "GLO:2ALM");
-      break;
-    case GAL_SEED:
-      strcpy(req, "GAL:2ALM");
-      break;
-    case BEI_SEED:
-      strcpy(req, "BDS:2ALM");
-      break;
-    default:
-      AGNSS_PRINT_OUT("ERROR: Unknown constellation\n");
+    (void)memcpy(buf, rec->buf, (rec->len < size) ? rec->len : size);
+  }
+}
+
+/* Picks the Seed info decoded from the JSON (PR-GNSS) */
+static size_t decodeJsonSeed(seed_type_t seed_type)
+{
+  const char *req = seedName(seed_type, PR_SEED, 0);
+  const seed_rec_t *rec;
+
+  seed_info.seed = NULL;
+  if (req == NULL)
+  {
+    return 0;
   }
 
-  cJSON *child = root->child;
-  while (child != NULL && strcmp(child->string, "body") != 0)
+  copySeedRec(req, "blockTypes", seed_info.block_types, MAX_BLOCK_TYPE_SIZE);
+  copySeedRec(req, "timeModel", seed_info.time_model, MAX_TIME_MODEL_SIZE);
+  copySeedRec(req, "slotFreq", seed_info.slot_freq, MAX_SLOT_FREQ_SIZE);
+  rec = findSeedRec(req, "seed");
+  if (rec == NULL)
+  {
+    return 0;
+  }
+  seed_info.seed = rec->buf;
+  seed_info.seed_size = rec->size;
+  printf("Seed (seed_size %d, base64 - len %d):\n", seed_info.seed_size, rec->len);
+
+  return rec->len;
+}
+
+/* Picks the Ephemeris info decoded from the JSON (RT-GNSS) */
+static void decodeJsonEph(seed_type_t seed_type)
+{
+  const char *req = seedName(seed_type, RT_SEED, 0);
+  const seed_rec_t *rec = (req != NULL) ? findSeedRec(NULL, req) : NULL;
+
+  seed_info.eph_seed = NULL;
+  seed_info.eph_nkc_seed = NULL;
+  if (rec == NULL)
   {
-    child = child->child;
+    return;
   }
-  if (child != NULL)
+  seed_info.eph_seed = rec->buf;
+  seed_info.eph_seed_size = rec->size;
+  printf("Eph Seed (base64 - bytes written %d):\n", rec->len);
+
+  if (seed_type == GLO_SEED)
   {
-    int items_count = cJSON_GetArraySize(child);
-    for (int i = 0; i < items_count; i++)
+    rec = findSeedRec(NULL, "GLO:2NKC");
+    if (rec != NULL)
     {
-      cJSON *subitem = cJSON_GetArrayItem(child, i);
-      cJSON *alm = cJSON_GetObjectItem(subitem, req);
-      if (alm != NULL)
-      {
-        char *seed_str = alm->valuestring;
-        mbedtls_base64_decode(seed_info.alm_seed,
-                              seed_info.alm_seed_size,
-                              &len_alm_seed,
-                              (unsigned char *)seed_str,
-                              strlen(seed_str));
-
-        printf("Alm Seed (base64 - bytes written %d):\n", len_alm_seed);
-        /*        for(int k=0; k<len_alm_seed; k++) */
-        /*          printf( "0x%02X,", seed_info.alm_seed[k] ); */
-        /*        printf( "\n" ); */
-      }
+      seed_info.eph_nkc_seed = rec->buf;
+      seed_info.eph_nkc_seed_size = rec->size;
+      printf("Eph NKC Seed (base64 - bytes written %d):\n", rec->len);
     }
   }
-  /* Free memory */
-  cJSON_Delete(root);
 }
 
+/* Picks the Almanac info decoded from the JSON (RT-GNSS) */
+static void decodeJsonAlm(seed_type_t seed_type)
+{
+  const char *req = seedName(seed_type, RT_SEED, 1);
+  const seed_rec_t *rec = (req != NULL) ? findSeedRec(NULL, req) : NULL;
+
+  seed_info.alm_seed = NULL;
+  if (rec == NULL)
+  {
+    return;
+  }
+  seed_info.alm_seed = rec->buf;
+  seed_info.alm_seed_size = rec->size;
+  printf("Alm Seed (base64 - bytes written %d):\n", rec->len);
+}
+
+/* Reads the current date and time from the RTC */
+static void getRtcTime(current_timedate_t *timedate)
+{
+  RTC_DateTypeDef sDate;
+  RTC_TimeTypeDef sTime;
+
+  HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
+  HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
+
+  timedate->Year = sDate.Year + 2000;
+  timedate->Month = sDate.Month;
+  timedate->Day = sDate.Date;
+
+  timedate->Hours = sTime.Hours;
+  timedate->Minutes = sTime.Minutes;
+  timedate->Seconds = sTime.Seconds;
+}
+
+#if (CONFIG_USE_SEED_CACHE == 1)
+/* Keeps the converted PR seed of a constellation in the flash cache */
+static void cachePRSeed(seed_type_t seed_type)
+{
+  current_timedate_t timedate;
+  seed_cache_pr_t pr;
+  SEEDCACHE_Seg_t segs[2];
+  uint32_t gps_time;
+
+  getRtcTime(&timedate);
+  gps_time = UTC_ToGPS(&timedate);
+
+  (void)memset(&pr, 0, sizeof(pr));
+  pr.curr_secs = seed_info.curr_secs;
+  pr.next_gps_time = seed_info.next_gps_time;
+  pr.next_secs = seed_info.next_secs;
+  pr.seed_size = seed_info.seed_size;
+  pr.nsat = seed_info.nsat;
+  pr.max_satid = seed_info.max_satid;
+  (void)memcpy(pr.block_types, seed_info.block_types, sizeof(pr.block_types));
+  (void)memcpy(pr.slot_freq, seed_info.slot_freq, sizeof(pr.slot_freq));
+  (void)memcpy(pr.time_model, seed_info.time_model, sizeof(pr.time_model));
+
+  segs[0].data = &pr;
+  segs[0].len = sizeof(pr);
+  segs[1].data = seed_info.seed;
+  segs[1].len = seed_info.seed_size;
+  if (SEEDCACHE_Store(PR_SEED, seed_type, gps_time, gps_time + SEEDCACHE_PR_VALIDITY, segs, 2U) != SEEDCACHE_OK)
+  {
+    AGNSS_PRINT_OUT("ERROR: Failed to cache the PR seed\n");
+  }
+}
+
+/* Keeps the decoded EPH and ALM of a constellation in the flash cache (RT) */
+static void cacheRTSeed(seed_type_t seed_type, current_timedate_t *timedate)
+{
+  seed_cache_rt_t rt;
+  SEEDCACHE_Seg_t segs[3];
+  uint32_t gps_time = UTC_ToGPS(timedate);
+
+  if ((seed_info.stm_ephem == NULL) || (seed_info.stm_alm == NULL))
+  {
+    return;
+  }
+
+  (void)memset(&rt, 0, sizeof(rt));
+  rt.num_sat_eph = seed_info.num_sat_eph;
+  rt.num_sat_alm = seed_info.num_sat_alm;
+  (void)memcpy(rt.sat_id, seed_info.sat_id, sizeof(rt.sat_id));
+
+  segs[0].data = &rt;
+  segs[0].len = sizeof(rt);
+  segs[1].data = seed_info.stm_ephem;
+  segs[1].len = SEED_RT_SAT_MAX * sizeof(ephemeris_raw_t);
+  segs[2].data = seed_info.stm_alm;
+  segs[2].len = SEED_RT_SAT_MAX * sizeof(almanac_raw_t);
+  if (SEEDCACHE_Store(RT_SEED, seed_type, gps_time, gps_time + SEEDCACHE_RT_VALIDITY, segs, 3U) != SEEDCACHE_OK)
+  {
+    AGNSS_PRINT_OUT("ERROR: Failed to cache the RT seed\n");
+  }
+}
+#endif /* CONFIG_USE_SEED_CACHE */
+
 /* Public functions -----------------------------------------------------------*/
 
 /* Parses option provided by the user according to the requested constellation */
@@ -480,7 +820,7 @@ void AppAGNSS_PassGen(void)
   RTC_DateTypeDef sDate;
   RTC_TimeTypeDef sTime;
 
-  /* Init the Network to set time */
+  /* Init the Network to set time, it is kept up for the seed requests */
   if (httpclient_init() != 0)
   {
     return;
@@ -489,9 +829,6 @@ void AppAGNSS_PassGen(void)
   HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
   HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
 
-  /* Deinit the Network */
-  httpclient_deinit();
-
   utc_time.Year = sDate.Year + 2000;
   utc_time.Month = sDate.Month;
   utc_time.Day = sDate.Date;
@@ -526,37 +863,33 @@ int AppAGNSS_DownloadSeed(GNSSParser_Data_t *pGNSSParser_Data, int seedMask, see
     /* Add the HTTP authorization header */
     (void)A_GNSS_BuildAuthHeader(pGNSSParser_Data, auth_string);
 
-    /* Start sending request */
-    seed_info.jsonBuffer = (uint8_t *)malloc(sizeof(uint8_t) * seedSize);
-    memset(seed_info.jsonBuffer, 0, sizeof(uint8_t) * seedSize);
-    if (seed_info.jsonBuffer != NULL)
+    /* Set up the values to be decoded while the seed is received */
+    if (initSeedRec(seedMask, seedReq) == 0)
     {
-      /* Init the Network */
-      httpclient_init();
+      (void)memset(&seed_stream, 0, sizeof(seed_stream));
+      seed_stream.max = (uint32_t)seedSize;
 
-      /* Query the server */
-      ret = httpclient_rxn(rxn_server_res,
-                           (char *)auth_string,
-                           seed_info.jsonBuffer,
-                           sizeof(uint8_t) * seedSize,
-                           (char *)jsonData);
-
-      /* Deinit the Network */
-      httpclient_deinit();
+      /* Init the Network, if not up yet: it is kept up for the next requests */
+      if (httpclient_init() == 0)
+      {
+        /* Query the server */
+        ret = httpclient_rxn_stream(rxn_server_res,
+                                    (char *)auth_string,
+                                    feedSeed,
+                                    NULL,
+                                    (char *)jsonData);
+      }
 
-      if (seed_valid(seed_info.jsonBuffer, ret, seedReq) != 0)
+      if ((ret <= 0) || (seed_valid(seedReq) != 0))
       {
         AGNSS_PRINT_OUT("ERROR: Failed to download a valid seed\n\n>");
         /* Free resource */
-        free(seed_info.jsonBuffer);
-        seed_info.jsonBuffer = NULL;
+        freeSeedRec();
         return -1;
       }
       else
       {
-#ifdef PRINT_JSON
-        printJson(seed_info.jsonBuffer);
-#endif /* PRINT_JSON */
+        printf("Seed decoded (%lu bytes received)\n", seed_stream.count);
       }
     }
     else
@@ -583,7 +916,7 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
   size_t num_sats_bei = 0;
   size_t len_seed;
 
-  if (seed_info.jsonBuffer != NULL)
+  if (seed_rec_nbr != 0U)
   {
     /* get some preliminary info */
     decodeJsonLeapsec();
@@ -595,13 +928,10 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
       memset(seed_info.slot_freq, 0, sizeof(seed_info.slot_freq));
       memset(seed_info.time_model, 0, sizeof(seed_info.time_model));
 
-      seed_info.seed = (uint8_t *)malloc(sizeof(uint8_t) * BUF_SIZE_5K);
-      memset(seed_info.seed, 0, sizeof(uint8_t) * BUF_SIZE_5K);
+      /* start decoding step - GPS seed */
+      len_seed = decodeJsonSeed(GPS_SEED);
       if (seed_info.seed != NULL)
       {
-        /* start decoding step - GPS seed */
-        seed_info.seed_size = BUF_SIZE_5K;
-        len_seed = decodeJsonSeed(GPS_SEED);
 
         /* before ending the decode step, update some values */
         num_sats_gps = len_seed / (SINGLE_SEED_BIT_LEN / 8);
@@ -611,18 +941,21 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
         printf("\n\n*********************seed_info.nsat = %d\n\n", seed_info.nsat);
         printf("\n\n*********************seed_info.max_satid = %d\n\n", seed_info.max_satid);
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+        cachePRSeed(GPS_SEED);
+#endif /* CONFIG_USE_SEED_CACHE */
+
         /* end decoding step and propagation */
 #ifdef PROPAGATE_PR_SEED
         A_GNSS_SendSeed(GPS_SEED, &seed_info);
 #endif /*PROPAGATE_PR_SEED*/
 
-        /* Free resource */
-        free(seed_info.seed);
+        /* The seed is released with the other records */
         seed_info.seed = NULL;
       }
       else
       {
-        AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for GPS seed\n");
+        AGNSS_PRINT_OUT("ERROR: No GPS seed downloaded\n");
       }
     }
 
@@ -633,13 +966,10 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
       memset(seed_info.slot_freq, 0, sizeof(seed_info.slot_freq));
       memset(seed_info.time_model, 0, sizeof(seed_info.time_model));
 
-      seed_info.seed = (uint8_t *)malloc(sizeof(uint8_t) * BUF_SIZE_4K);
-      memset(seed_info.seed, 0, sizeof(uint8_t)*BUF_SIZE_4K);
+      /* start decoding step - GLO seed */
+      len_seed = decodeJsonSeed(GLO_SEED);
       if (seed_info.seed != NULL)
       {
-        /* start decoding step - GLO seed */
-        seed_info.seed_size = BUF_SIZE_4K;
-        len_seed = decodeJsonSeed(GLO_SEED);
 
         /* before ending the decode step, update some values */
         num_sats_glo = len_seed / (SINGLE_SEED_BIT_LEN / 8);
@@ -649,18 +979,21 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
         printf("\n\n*********************seed_info.nsat = %d\n\n", seed_info.nsat);
         printf("\n\n*********************seed_info.max_satid = %d\n\n", seed_info.max_satid);
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+        cachePRSeed(GLO_SEED);
+#endif /* CONFIG_USE_SEED_CACHE */
+
         /* end decoding step and propagation */
 #ifdef PROPAGATE_PR_SEED
         A_GNSS_SendSeed(GLO_SEED, &seed_info);
 #endif /*PROPAGATE_PR_SEED*/
 
-        /* Free resource */
-        free(seed_info.seed);
+        /* The seed is released with the other records */
         seed_info.seed = NULL;
       }
       else
       {
-        AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for GLO seed\n");
+        AGNSS_PRINT_OUT("ERROR: No GLO seed downloaded\n");
       }
     }
 
@@ -671,13 +1004,10 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
       memset(seed_info.slot_freq, 0, sizeof(seed_info.slot_freq));
       memset(seed_info.time_model, 0, sizeof(seed_info.time_model));
 
-      seed_info.seed = (uint8_t *)malloc(sizeof(uint8_t) * BUF_SIZE_4K);
-      memset(seed_info.seed, 0, sizeof(uint8_t) * BUF_SIZE_4K);
+      /* start decoding step - GAL seed */
+      len_seed = decodeJsonSeed(GAL_SEED);
       if (seed_info.seed != NULL)
       {
-        /* start decoding step - GAL seed */
-        seed_info.seed_size = BUF_SIZE_4K;
-        len_seed = decodeJsonSeed(GAL_SEED);
 
         /* before ending the decode step, update some values */
         num_sats_gal = len_seed / (SINGLE_SEED_BIT_LEN / 8);
@@ -687,18 +1017,21 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
         printf("\n\n*********************seed_info.nsat = %d\n\n", seed_info.nsat);
         printf("\n\n*********************seed_info.max_satid = %d\n\n", seed_info.max_satid);
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+        cachePRSeed(GAL_SEED);
+#endif /* CONFIG_USE_SEED_CACHE */
+
         /* end decoding step and propagation */
 #ifdef PROPAGATE_PR_SEED
         A_GNSS_SendSeed(GAL_SEED, &seed_info);
 #endif /*PROPAGATE_PR_SEED*/
 
-        /* Free resource */
-        free(seed_info.seed);
+        /* The seed is released with the other records */
         seed_info.seed = NULL;
       }
       else
       {
-        AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for GAL seed\n");
+        AGNSS_PRINT_OUT("ERROR: No GAL seed downloaded\n");
       }
     }
 
@@ -709,13 +1042,10 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
       memset(seed_info.slot_freq, 0, sizeof(seed_info.slot_freq));
       memset(seed_info.time_model, 0, sizeof(seed_info.time_model));
 
-      seed_info.seed = (uint8_t *)malloc(sizeof(uint8_t) * BUF_SIZE_4K);
-      memset(seed_info.seed, 0, sizeof(uint8_t) * BUF_SIZE_4K);
+      /* start decoding step - BEI seed */
+      len_seed = decodeJsonSeed(BEI_SEED);
       if (seed_info.seed != NULL)
       {
-        /* start decoding step - BEI seed */
-        seed_info.seed_size = BUF_SIZE_4K;
-        len_seed = decodeJsonSeed(BEI_SEED);
 
         /* before ending the decode step, update some values */
         num_sats_bei = len_seed / (SINGLE_SEED_BIT_LEN / 8);
@@ -725,24 +1055,26 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
         printf("\n\n*********************seed_info.nsat = %d\n\n", seed_info.nsat);
         printf("\n\n*********************seed_info.max_satid = %d\n\n", seed_info.max_satid);
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+        cachePRSeed(BEI_SEED);
+#endif /* CONFIG_USE_SEED_CACHE */
+
         /* end decoding step and propagation */
 #ifdef PROPAGATE_PR_SEED
         A_GNSS_SendSeed(BEI_SEED, &seed_info);
 #endif /*PROPAGATE_PR_SEED*/
 
-        /* Free resource */
-        free(seed_info.seed);
+        /* The seed is released with the other records */
         seed_info.seed = NULL;
       }
       else
       {
-        AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for BEI seed\n");
+        AGNSS_PRINT_OUT("ERROR: No BEI seed downloaded\n");
       }
     }
 
     /* Free memory */
-    free(seed_info.jsonBuffer);
-    seed_info.jsonBuffer = NULL;
+    freeSeedRec();
   }
   else
   {
@@ -757,12 +1089,15 @@ void AppAGNSS_ConvertPRSeed(int seedMask)
 /* Invokes Almanac decoding API (RT) */
 static void decodeAlmanac(seed_type_t seed_type, uint16_t week, current_timedate_t *timedate)
 {
-  seed_info.stm_alm = (almanac_raw_t *)malloc(sizeof(almanac_raw_t) * 64);
-  memset(seed_info.stm_alm, 0, sizeof(almanac_raw_t) * 64);
+  seed_info.stm_alm = heap_arena_alloc(&seed_arena, sizeof(almanac_raw_t) * SEED_RT_SAT_MAX);
   if (seed_info.stm_alm != NULL)
   {
+    (void)memset(seed_info.stm_alm, 0, sizeof(almanac_raw_t) * SEED_RT_SAT_MAX);
     /* Decode Almanac */
     A_GNSS_DecodeAlmRT(seed_type, &seed_info, week, timedate);
+#if (CONFIG_USE_SEED_CACHE == 1)
+    cacheRTSeed(seed_type, timedate);
+#endif /* CONFIG_USE_SEED_CACHE */
   }
   else
   {
@@ -771,27 +1106,21 @@ static void decodeAlmanac(seed_type_t seed_type, uint16_t week, current_timedate
 }
 
 /* Starts Almanac decoding (RT) */
-static void handleAlmConversion(seed_type_t seed_type, uint16_t seed_size, uint16_t week, current_timedate_t *timedate)
+static void handleAlmConversion(seed_type_t seed_type, uint16_t week, current_timedate_t *timedate)
 {
-  seed_info.alm_seed = (uint8_t *)malloc(sizeof(uint8_t) * seed_size);
-  (void)memset(seed_info.alm_seed, 0, sizeof(uint8_t) * seed_size);
+  /* Pick the ALM seed decoded while downloading */
+  decodeJsonAlm(seed_type);
   if (seed_info.alm_seed != NULL)
   {
-    seed_info.alm_seed_size = seed_size;
-
-    /* Initial json parsing for ALM */
-    decodeJsonAlm(seed_type);
-
     /* Prepare to decode Almanac */
     decodeAlmanac(seed_type, week, timedate);
 
-    /* Free alm seed resource */
-    free(seed_info.alm_seed);
+    /* The alm seed is released with the other records */
     seed_info.alm_seed = NULL;
   }
   else
   {
-    AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for RT ALM seed\n");
+    AGNSS_PRINT_OUT("ERROR: No RT ALM seed downloaded\n");
   }
 
 }
@@ -801,10 +1130,10 @@ static uint16_t decodeEphemeris(seed_type_t seed_type, current_timedate_t *timed
 {
   uint16_t week = 0;
 
-  seed_info.stm_ephem = (ephemeris_raw_t *)malloc(sizeof(ephemeris_raw_t) * 64);
-  memset(seed_info.stm_ephem, 0, sizeof(ephemeris_raw_t) * 64);
+  seed_info.stm_ephem = heap_arena_alloc(&seed_arena, sizeof(ephemeris_raw_t) * SEED_RT_SAT_MAX);
   if (seed_info.stm_ephem != NULL)
   {
+    (void)memset(seed_info.stm_ephem, 0, sizeof(ephemeris_raw_t) * SEED_RT_SAT_MAX);
     /* Decode Ephemeris */
     week = A_GNSS_DecodeEphemRT(seed_type, &seed_info, timedate);
   }
@@ -817,57 +1146,26 @@ static uint16_t decodeEphemeris(seed_type_t seed_type, current_timedate_t *timed
 }
 
 /* Starts Ephemeris decoding (RT) */
-static uint16_t handleEphConversion(seed_type_t seed_type, uint16_t seed_size, current_timedate_t *timedate)
+static uint16_t handleEphConversion(seed_type_t seed_type, current_timedate_t *timedate)
 {
   uint16_t week = 0;
 
-  seed_info.eph_seed = (uint8_t *)malloc(sizeof(uint8_t) * seed_size);
-  memset(seed_info.eph_seed, 0, sizeof(uint8_t) * seed_size);
-  if (seed_info.eph_seed != NULL)
+  /* Pick the EPH seed decoded while downloading */
+  decodeJsonEph(seed_type);
+  if ((seed_info.eph_seed != NULL) && ((seed_type != GLO_SEED) || (seed_info.eph_nkc_seed != NULL)))
   {
-    seed_info.eph_seed_size = seed_size;
-
-    if (seed_type == GLO_SEED)
-    {
-      seed_info.eph_nkc_seed = (uint8_t *)malloc(sizeof(uint8_t) * seed_size);
-      (void)memset(seed_info.eph_nkc_seed, 0, sizeof(uint8_t) * seed_size);
-      if (seed_info.eph_nkc_seed != NULL)
-      {
-        seed_info.eph_nkc_seed_size = seed_size;
-
-        /* Initial json parsing for EPH */
-        decodeJsonEph(seed_type);
-
-        /* Prepare to decode Ephemeris */
-        week = decodeEphemeris(seed_type, timedate);
-
-        /* Free eph nkc seed resource */
-        free(seed_info.eph_nkc_seed);
-        seed_info.eph_nkc_seed = NULL;
-      }
-      else
-      {
-        AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for RT NKC seed\n");
-      }
-    }
-    else
-    {
-      /* Initial json parsing for EPH */
-      decodeJsonEph(seed_type);
-
-      /* Prepare to decode Ephemeris */
-      week = decodeEphemeris(seed_type, timedate);
-    }
-
-    /* Free eph seed resource */
-    free(seed_info.eph_seed);
-    seed_info.eph_seed = NULL;
+    /* Prepare to decode Ephemeris */
+    week = decodeEphemeris(seed_type, timedate);
   }
   else
   {
-    AGNSS_PRINT_OUT("ERROR: Failed to alloc memory for RT EPH seed\n");
+    AGNSS_PRINT_OUT("ERROR: No RT EPH seed downloaded\n");
   }
 
+  /* The eph seeds are released with the other records */
+  seed_info.eph_seed = NULL;
+  seed_info.eph_nkc_seed = NULL;
+
   return week;
 }
 
@@ -882,19 +1180,11 @@ static void sendRTSeed(seed_type_t seed_type)
   A_GNSS_SendAlmRT(seed_type, &seed_info);
 }
 
-/* Clean utility */
+/* Clean utility: the buffers are released with the seed arena */
 static void clearDecodingBuffer()
 {
-  if (seed_info.stm_ephem != NULL)
-  {
-    free(seed_info.stm_ephem);
-    seed_info.stm_ephem = NULL;
-  }
-  if (seed_info.stm_alm != NULL)
-  {
-    free(seed_info.stm_alm);
-    seed_info.stm_alm = NULL;
-  }
+  seed_info.stm_ephem = NULL;
+  seed_info.stm_alm = NULL;
 }
 
 /* Starts seed conversion (Real-time). */
@@ -903,23 +1193,11 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
   current_timedate_t timedate;
   uint16_t week;
 
-  RTC_DateTypeDef sDate;
-  RTC_TimeTypeDef sTime;
-
-  if (seed_info.jsonBuffer != NULL)
+  if (seed_rec_nbr != 0U)
   {
 
     /* Get time and send $PSTMINITTIME command */
-    HAL_RTC_GetTime(&hrtc, &sTime, RTC_FORMAT_BIN);
-    HAL_RTC_GetDate(&hrtc, &sDate, RTC_FORMAT_BIN);
-
-    timedate.Year = sDate.Year + 2000;
-    timedate.Month = sDate.Month;
-    timedate.Day = sDate.Date;
-
-    timedate.Hours = sTime.Hours;
-    timedate.Minutes = sTime.Minutes;
-    timedate.Seconds = sTime.Seconds;
+    getRtcTime(&timedate);
 
     /*    printf("Today's time : %02d %02d %04d %02d:%02d:%02d\n", */
     /*           timedate.Day, */
@@ -931,9 +1209,9 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
     /* GPS Constellation */
     if (seedMask & GPS_CONSTELLATION)
     {
-      week = handleEphConversion(GPS_SEED, BUF_SIZE_3K, &timedate);
+      week = handleEphConversion(GPS_SEED, &timedate);
 
-      handleAlmConversion(GPS_SEED, BUF_SIZE_2K, week, &timedate);
+      handleAlmConversion(GPS_SEED, week, &timedate);
 #ifdef PROPAGATE_RT_SEED
       sendRTSeed(GPS_SEED);
 #endif /*PROPAGATE_RT_SEED*/
@@ -943,9 +1221,9 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
     /* GLO Constellation */
     else if (seedMask & GLO_CONSTELLATION)
     {
-      week = handleEphConversion(GLO_SEED, BUF_SIZE_2K, &timedate);
+      week = handleEphConversion(GLO_SEED, &timedate);
 
-      handleAlmConversion(GLO_SEED, BUF_SIZE_2K, week, &timedate);
+      handleAlmConversion(GLO_SEED, week, &timedate);
 #ifdef PROPAGATE_RT_SEED
       sendRTSeed(GLO_SEED);
 #endif /*PROPAGATE_RT_SEED*/
@@ -955,9 +1233,9 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
     /* GAL Constellation */
     else if (seedMask & GAL_CONSTELLATION)
     {
-      week = handleEphConversion(GAL_SEED, BUF_SIZE_2K, &timedate);
+      week = handleEphConversion(GAL_SEED, &timedate);
 
-      handleAlmConversion(GAL_SEED, BUF_SIZE_1K, week, &timedate);
+      handleAlmConversion(GAL_SEED, week, &timedate);
 #ifdef PROPAGATE_RT_SEED
       sendRTSeed(GAL_SEED);
 #endif /*PROPAGATE_RT_SEED */
@@ -967,9 +1245,9 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
     /* BEI Constellation */
     else if (seedMask & BEI_CONSTELLATION)
     {
-      week = handleEphConversion(BEI_SEED, BUF_SIZE_2K, &timedate);
+      week = handleEphConversion(BEI_SEED, &timedate);
 
-      handleAlmConversion(BEI_SEED, BUF_SIZE_1K, week, &timedate);
+      handleAlmConversion(BEI_SEED, week, &timedate);
 #ifdef PROPAGATE_RT_SEED
       sendRTSeed(BEI_SEED);
 #endif /*PROPAGATE_RT_SEED*/
@@ -978,8 +1256,7 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
     }
 
     /* Free memory */
-    free(seed_info.jsonBuffer);
-    seed_info.jsonBuffer = NULL;
+    freeSeedRec();
   }
   else
   {
@@ -991,3 +1268,89 @@ void AppAGNSS_ConvertRTSeed(int seedMask)
   return;
 }
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+/* Sends the seeds still valid in the flash cache to the Teseo device. */
+int AppAGNSS_RestoreSeed(int seedMask, seed_req_t seedReq)
+{
+  current_timedate_t timedate;
+  const uint8_t *data;
+  uint8_t *copy;
+  uint32_t gps_time;
+  uint32_t len;
+  int restored = 0;
+
+  getRtcTime(&timedate);
+  gps_time = UTC_ToGPS(&timedate);
+
+  for (seed_type_t t = GPS_SEED; t <= BEI_SEED; t++)
+  {
+    if ((seedMask & (1 << (t - GPS_SEED))) == 0)
+    {
+      continue;
+    }
+    data = SEEDCACHE_Get(seedReq, t, gps_time, &len);
+    if ((data == NULL) ||
+        ((seedReq == PR_SEED) && ((len < sizeof(seed_cache_pr_t)) ||
+                                  ((len - sizeof(seed_cache_pr_t)) < ((const seed_cache_pr_t *)data)->seed_size))) ||
+        ((seedReq == RT_SEED) && (len != SEED_CACHE_RT_LEN)))
+    {
+      continue;
+    }
+
+    /* The library takes writable buffers: work on a copy in the seed arena */
+    freeSeedRec();
+    copy = heap_arena_alloc(&seed_arena, len);
+    if (copy == NULL)
+    {
+      continue;
+    }
+    (void)memcpy(copy, data, len);
+    printf("Cached %s seed (%lu bytes)\n", seedName(t, PR_SEED, 0), len);
+
+    if (seedReq == PR_SEED)
+    {
+      const seed_cache_pr_t *pr = (const seed_cache_pr_t *)copy;
+
+      seed_info.curr_secs = pr->curr_secs;
+      seed_info.next_gps_time = pr->next_gps_time;
+      seed_info.next_secs = pr->next_secs;
+      seed_info.nsat = pr->nsat;
+      seed_info.max_satid = pr->max_satid;
+      (void)memcpy(seed_info.block_types, pr->block_types, sizeof(seed_info.block_types));
+      (void)memcpy(seed_info.slot_freq, pr->slot_freq, sizeof(seed_info.slot_freq));
+      (void)memcpy(seed_info.time_model, pr->time_model, sizeof(seed_info.time_model));
+      seed_info.seed = &copy[sizeof(seed_cache_pr_t)];
+      seed_info.seed_size = pr->seed_size;
+#ifdef PROPAGATE_PR_SEED
+      A_GNSS_SendSeed(t, &seed_info);
+#endif /*PROPAGATE_PR_SEED*/
+      seed_info.seed = NULL;
+    }
+    else
+    {
+      const seed_cache_rt_t *rt = (const seed_cache_rt_t *)copy;
+
+      /* Send $PSTMINITTIME command before the first EPH */
+      if (restored == 0)
+      {
+        A_GNSS_SendCurrentTime(&timedate);
+      }
+      seed_info.num_sat_eph = rt->num_sat_eph;
+      seed_info.num_sat_alm = rt->num_sat_alm;
+      (void)memcpy(seed_info.sat_id, rt->sat_id, sizeof(seed_info.sat_id));
+      seed_info.stm_ephem = &copy[sizeof(seed_cache_rt_t)];
+      seed_info.stm_alm = &copy[sizeof(seed_cache_rt_t) + (SEED_RT_SAT_MAX * sizeof(ephemeris_raw_t))];
+#ifdef PROPAGATE_RT_SEED
+      sendRTSeed(t);
+#endif /*PROPAGATE_RT_SEED*/
+      clearDecodingBuffer();
+    }
+    restored |= 1 << (t - GPS_SEED);
+  }
+
+  /* Free memory */
+  freeSeedRec();
+
+  return restored;
+}
+#endif /* CONFIG_USE_SEED_CACHE */
@@ -0,0 +1,377 @@
+/**
+  ******************************************************************************
+  * @file    fix_log.c
+  * @author  SRA Application Team
+  * @brief   Append-only, wear-levelled log of GNSS fixes in the internal flash.
+  *
+  *          The log area is a ring of FIXLOG_PAGE_NBR flash pages. Each page
+  *          starts with a header holding a sequence number which increases
+  *          every time a page is (re)opened, followed by fixed size records
+  *          protected by a CRC. Records are only ever appended: when the head
+  *          page is full the next page of the ring is erased and reopened, so
+  *          every page is erased once per lap and the oldest fixes are
+  *          discarded first.
+  *          FIXLOG_Sample() only builds the record of a fix, so that the
+  *          caller can take it while holding the GNSS data, and leave the
+  *          flash programming and the page erases to a lower priority task.
+  *          At boot the head is recovered by reading the page headers only,
+  *          then by a binary search of the first blank slot in the head page.
+  *          A record torn by a reset fails its CRC and is skipped on read.
+  *
+  *          The functions of this module are not reentrant: the caller has to
+  *          serialize the accesses.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <stdio.h>
+
+#include "main.h"
+#include "flash.h"
+#include "fix_log.h"
+#include "teseo_liv3f_conf.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t magic;
+  uint32_t seq;
+} FIXLOG_PageHeader_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define FIXLOG_MAGIC          0x464C4F47U  /* "FLOG" */
+#define FIXLOG_BLANK          0xFFFFFFFFU
+#define FIXLOG_REC_SZ         sizeof(FIXLOG_Record_t)
+#define FIXLOG_SLOTS_PER_PAGE ((FLASH_PAGE_SIZE - sizeof(FIXLOG_PageHeader_t)) / FIXLOG_REC_SZ)
+#define FIXLOG_CRC_LEN        (FIXLOG_REC_SZ - sizeof(uint16_t))
+
+#define FIXLOG_PAGE_ADDR(p)    (FIXLOG_BASE_ADDR + ((p) * FLASH_PAGE_SIZE))
+#define FIXLOG_SLOT_ADDR(p, s) (FIXLOG_PAGE_ADDR(p) + sizeof(FIXLOG_PageHeader_t) + ((s) * FIXLOG_REC_SZ))
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t head_page;
+static uint32_t head_slot;
+static uint32_t head_seq;
+static uint32_t used_pages;
+static uint8_t  is_initialized = 0;
+static uint32_t sample_tick;
+static uint8_t  is_sampled = 0;
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t FIXLOG_Crc16(const uint8_t *pData, uint32_t len);
+static uint8_t  FIXLOG_IsBlank(uint32_t addr, uint32_t len);
+static uint32_t FIXLOG_FindHeadSlot(uint32_t page);
+static int32_t  FIXLOG_OpenPage(uint32_t page, uint32_t seq);
+static int32_t  FIXLOG_NmeaToDeg7(float64_t nmea, uint8_t hemi, uint8_t neg);
+
+/* Private functions ---------------------------------------------------------*/
+
+/* CRC16-CCITT (poly 0x1021, init 0xFFFF) */
+static uint16_t FIXLOG_Crc16(const uint8_t *pData, uint32_t len)
+{
+  uint16_t crc = 0xFFFFU;
+
+  for (uint32_t i = 0; i < len; i++)
+  {
+    crc ^= (uint16_t)pData[i] << 8;
+    for (uint8_t b = 0; b < 8U; b++)
+    {
+      crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+  }
+
+  return crc;
+}
+
+/* Returns 1 if the flash area is in the erased state */
+static uint8_t FIXLOG_IsBlank(uint32_t addr, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i += 4U)
+  {
+    if (*(volatile uint32_t *)(addr + i) != FIXLOG_BLANK)
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* Records are appended in order, so the blank slots are contiguous at the
+ * end of the page: binary search the first one.
+ */
+static uint32_t FIXLOG_FindHeadSlot(uint32_t page)
+{
+  uint32_t lo = 0;
+  uint32_t hi = FIXLOG_SLOTS_PER_PAGE;
+
+  while (lo < hi)
+  {
+    uint32_t mid = lo + ((hi - lo) / 2U);
+
+    if (FIXLOG_IsBlank(FIXLOG_SLOT_ADDR(page, mid), FIXLOG_REC_SZ) == 1U)
+    {
+      hi = mid;
+    }
+    else
+    {
+      lo = mid + 1U;
+    }
+  }
+
+  return lo;
+}
+
+/* Erases a page of the ring and stamps its header */
+static int32_t FIXLOG_OpenPage(uint32_t page, uint32_t seq)
+{
+  FIXLOG_PageHeader_t hdr;
+
+  if (FIXLOG_IsBlank(FIXLOG_PAGE_ADDR(page), FLASH_PAGE_SIZE) == 0U)
+  {
+    if (FLASH_Erase_Size(FIXLOG_PAGE_ADDR(page), FLASH_PAGE_SIZE) != HAL_OK)
+    {
+      return FIXLOG_ERROR;
+    }
+  }
+
+  hdr.magic = FIXLOG_MAGIC;
+  hdr.seq = seq;
+  if (FLASH_Write(FIXLOG_PAGE_ADDR(page), (uint32_t *)&hdr, sizeof(hdr)) != HAL_OK)
+  {
+    return FIXLOG_ERROR;
+  }
+
+  return FIXLOG_OK;
+}
+
+/* Converts a NMEA (d)ddmm.mmmm coordinate to 1e-7 degrees */
+static int32_t FIXLOG_NmeaToDeg7(float64_t nmea, uint8_t hemi, uint8_t neg)
+{
+  int32_t deg = (int32_t)(nmea / 100.0);
+  float64_t val = ((float64_t)deg + ((nmea - ((float64_t)deg * 100.0)) / 60.0)) * 1e7;
+  int32_t ret = (int32_t)(val + 0.5);
+
+  return (hemi == neg) ? -ret : ret;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+
+/**
+  * @brief  Recover the write head of the log from the flash content.
+  * @note   Only the page headers and O(log n) slots of the head page are read.
+  * @retval FIXLOG_OK on success, FIXLOG_ERROR otherwise.
+  */
+int32_t FIXLOG_Init(void)
+{
+  uint8_t found = 0;
+
+  used_pages = 0;
+
+  for (uint32_t p = 0; p < FIXLOG_PAGE_NBR; p++)
+  {
+    const FIXLOG_PageHeader_t *hdr = (const FIXLOG_PageHeader_t *)FIXLOG_PAGE_ADDR(p);
+
+    if ((hdr->magic != FIXLOG_MAGIC) || (hdr->seq == FIXLOG_BLANK))
+    {
+      continue;
+    }
+    used_pages++;
+    if ((found == 0U) || ((int32_t)(hdr->seq - head_seq) > 0))
+    {
+      head_seq = hdr->seq;
+      head_page = p;
+      found = 1;
+    }
+  }
+
+  if (found == 0U)
+  {
+    head_page = 0;
+    head_seq = 0;
+    if (FIXLOG_OpenPage(head_page, head_seq) != FIXLOG_OK)
+    {
+      return FIXLOG_ERROR;
+    }
+    used_pages = 1;
+  }
+
+  head_slot = FIXLOG_FindHeadSlot(head_page);
+  is_initialized = 1;
+
+  return FIXLOG_OK;
+}
+
+/**
+  * @brief  Build the record of the last GGA fix (with the last RMC date),
+  *         if one is due.
+  * @note   Fixes with INVALID quality are not logged, and valid ones at most
+  *         once every FIXLOG_PERIOD seconds. The flash is not accessed.
+  * @param  In: pGNSSParser_Data  Parsed GNSS data.
+  * @param  Out: pRecord          Record to be passed to FIXLOG_Append().
+  * @retval FIXLOG_OK if a record is due, FIXLOG_ERROR otherwise.
+  */
+int32_t FIXLOG_Sample(const GNSSParser_Data_t *pGNSSParser_Data, FIXLOG_Record_t *pRecord)
+{
+  const GPGGA_Info_t *gga = &pGNSSParser_Data->gpgga_data;
+  uint32_t now = HAL_GetTick();
+
+  if (gga->valid == (uint8_t)INVALID)
+  {
+    return FIXLOG_ERROR;
+  }
+  if ((is_sampled == 1U) && ((now - sample_tick) < (FIXLOG_PERIOD * 1000U)))
+  {
+    return FIXLOG_ERROR;
+  }
+  sample_tick = now;
+  is_sampled = 1;
+
+  (void)memset(pRecord, 0, sizeof(FIXLOG_Record_t));
+  pRecord->utc = (uint32_t)gga->utc.utc;
+  pRecord->date = (uint32_t)pGNSSParser_Data->gprmc_data.date;
+  pRecord->lat = FIXLOG_NmeaToDeg7(gga->xyz.lat, gga->xyz.ns, (uint8_t)'S');
+  pRecord->lon = FIXLOG_NmeaToDeg7(gga->xyz.lon, gga->xyz.ew, (uint8_t)'W');
+  pRecord->alt = (int32_t)(gga->xyz.alt * 10.0);
+  pRecord->sats = (uint8_t)gga->sats;
+  pRecord->valid = gga->valid;
+  pRecord->crc = FIXLOG_Crc16((const uint8_t *)pRecord, FIXLOG_CRC_LEN);
+
+  return FIXLOG_OK;
+}
+
+/**
+  * @brief  Append a record to the log.
+  * @note   When the head page is full, the next page of the ring is erased
+  *         first: this call may then take the time of a page erase.
+  * @param  In: pRecord  Record built by FIXLOG_Sample().
+  * @retval FIXLOG_OK on success, FIXLOG_ERROR otherwise.
+  */
+int32_t FIXLOG_Append(const FIXLOG_Record_t *pRecord)
+{
+  if (is_initialized == 0U)
+  {
+    return FIXLOG_ERROR;
+  }
+
+  if (head_slot >= FIXLOG_SLOTS_PER_PAGE)
+  {
+    uint32_t next = (head_page + 1U) % FIXLOG_PAGE_NBR;
+
+    if (FIXLOG_OpenPage(next, head_seq + 1U) != FIXLOG_OK)
+    {
+      return FIXLOG_ERROR;
+    }
+    if (used_pages < FIXLOG_PAGE_NBR)
+    {
+      used_pages++;
+    }
+    head_page = next;
+    head_seq++;
+    head_slot = 0;
+  }
+
+  /* The slot is consumed even on failure: a partially programmed slot is no
+   * longer blank and cannot be written again until the page is erased.
+   */
+  head_slot++;
+  if (FLASH_Write(FIXLOG_SLOT_ADDR(head_page, head_slot - 1U), (uint32_t *)pRecord, FIXLOG_REC_SZ) != HAL_OK)
+  {
+    return FIXLOG_ERROR;
+  }
+
+  return FIXLOG_OK;
+}
+
+/**
+  * @brief  Bulk read of the log, from the oldest to the newest record.
+  * @note   Records failing the CRC check are skipped.
+  * @param  In/Out: pCursor   Slot index to start from (0 is the oldest slot);
+  *                           updated to the slot following the last one read.
+  * @param  Out: pRecords     Destination buffer.
+  * @param  In: nbr           Max number of records to read.
+  * @retval Number of records copied to pRecords (0 at the end of the log).
+  */
+int32_t FIXLOG_Read(uint32_t *pCursor, FIXLOG_Record_t *pRecords, uint32_t nbr)
+{
+  uint32_t total = FIXLOG_GetCount();
+  uint32_t tail_page = (head_page + FIXLOG_PAGE_NBR + 1U - used_pages) % FIXLOG_PAGE_NBR;
+  int32_t n = 0;
+
+  while ((*pCursor < total) && ((uint32_t)n < nbr))
+  {
+    uint32_t page = (tail_page + (*pCursor / FIXLOG_SLOTS_PER_PAGE)) % FIXLOG_PAGE_NBR;
+    const FIXLOG_Record_t *rec = (const FIXLOG_Record_t *)FIXLOG_SLOT_ADDR(page, *pCursor % FIXLOG_SLOTS_PER_PAGE);
+
+    if (rec->crc == FIXLOG_Crc16((const uint8_t *)rec, FIXLOG_CRC_LEN))
+    {
+      (void)memcpy(&pRecords[n], rec, sizeof(FIXLOG_Record_t));
+      n++;
+    }
+    (*pCursor)++;
+  }
+
+  return n;
+}
+
+/**
+  * @brief  Erase the whole log area and restart the log.
+  * @retval FIXLOG_OK on success, FIXLOG_ERROR otherwise.
+  */
+int32_t FIXLOG_Erase(void)
+{
+  for (uint32_t p = 0; p < FIXLOG_PAGE_NBR; p++)
+  {
+    if (FIXLOG_IsBlank(FIXLOG_PAGE_ADDR(p), FLASH_PAGE_SIZE) == 0U)
+    {
+      if (FLASH_Erase_Size(FIXLOG_PAGE_ADDR(p), FLASH_PAGE_SIZE) != HAL_OK)
+      {
+        return FIXLOG_ERROR;
+      }
+    }
+  }
+
+  return FIXLOG_Init();
+}
+
+/**
+  * @brief  Get the number of slots written in the log, torn records included.
+  * @retval Number of slots.
+  */
+uint32_t FIXLOG_GetCount(void)
+{
+  if (is_initialized == 0U)
+  {
+    return 0;
+  }
+
+  return ((used_pages - 1U) * FIXLOG_SLOTS_PER_PAGE) + head_slot;
+}
+
+/**
+  * @brief  Print a record on the console.
+  * @note   The record is printed from a copy, so the caller does not need to
+  *         hold the log while the console is busy.
+  * @param  In: pRecord   Record to print.
+  * @retval None
+  */
+void FIXLOG_Print(const FIXLOG_Record_t *pRecord)
+{
+  char msg[96];
+
+  (void)snprintf(msg, sizeof(msg), "%06lu %06lu %ld %ld %ld %u %u\r\n",
+                 (unsigned long)pRecord->utc, (unsigned long)pRecord->date,
+                 (long)pRecord->lat, (long)pRecord->lon, (long)pRecord->alt,
+                 pRecord->sats, pRecord->valid);
+  PRINT_OUT(msg);
+}
@@ -116,10 +116,28 @@
 #include "gnss_feature_cfg_data.h"
 #endif /* CONFIG_USE_FEATURE */
 
+#if (CONFIG_USE_FIXLOG == 1)
+#include "fix_log.h"
+#endif /* CONFIG_USE_FIXLOG */
+
+#if (CONFIG_USE_SEED_CACHE == 1)
+#include "seed_cache.h"
+#endif /* CONFIG_USE_SEED_CACHE */
+
 /* Private defines -----------------------------------------------------------*/
 
 #define CONSUMER_STACK_SIZE (1*1024)
 
+#if (CONFIG_USE_FIXLOG == 1)
+#define FIXLOG_STACK_SIZE   512
+#define FIXLOG_QUEUE_LEN    4
+#endif /* CONFIG_USE_FIXLOG */
+
+#if (CONFIG_USE_SEED_CACHE == 1)
+/* Signal to the console task: the GNSS is initialized */
+#define GNSS_READY_SIGNAL   0x01
+#endif /* CONFIG_USE_SEED_CACHE */
+
 /* Global variables ----------------------------------------------------------*/
 RTC_HandleTypeDef hrtc;
 RNG_HandleTypeDef hrng;
@@ -135,6 +153,13 @@ osThreadId consoleParseTaskHandle;
 osThreadId backgroundTaskHandle;
 #endif /* USE_I2C */
 
+#if (CONFIG_USE_FIXLOG == 1)
+/* The fix log is written by its own task, fed through a mail queue */
+osThreadId fixLogTaskHandle;
+osMutexId fixLogMutexHandle;
+osMailQId fixLogMailHandle;
+#endif /* CONFIG_USE_FIXLOG */
+
 /* Private variables ---------------------------------------------------------*/
 
 static GNSSParser_Data_t GNSSParser_Data;
@@ -167,6 +192,12 @@ static uint8_t ConsoleReadable(void);
 static void BackgroundTask(void const * argument);
 #endif /* USE_I2C */
 
+#if (CONFIG_USE_FIXLOG == 1)
+static void Fix_Log_Task_Init(void);
+static void FixLogTask(void const * argument);
+static void FixLogPost(const GNSSParser_Data_t *pGNSSParser_Data);
+#endif /* CONFIG_USE_FIXLOG */
+
 static void AppCmdProcess(char *com);
 static void AppCfgMsgList(uint32_t lowMask, uint32_t highMask);
 
@@ -230,6 +261,9 @@ int main(void)
 #if (USE_I2C == 1)
   Background_Task_Init();
 #endif /* USE_I2C */
+#if (CONFIG_USE_FIXLOG == 1)
+  Fix_Log_Task_Init();
+#endif /* CONFIG_USE_FIXLOG */
   Teseo_Consumer_Task_Init();
 
   //HAL_Delay(100);
@@ -273,6 +307,24 @@ static void Console_Parse_Task_Init(void)
   consoleParseTaskHandle = osThreadCreate(osThread(consoleParseTask), NULL);
 }
 
+#if (CONFIG_USE_FIXLOG == 1)
+/*
+ * This function creates the task writing the fix log, at a lower priority
+ * than the Teseo consumer so that the page erases do not delay the parsing
+ */
+static void Fix_Log_Task_Init(void)
+{
+  osMutexDef(fixLogMutex);
+  fixLogMutexHandle = osMutexCreate(osMutex(fixLogMutex));
+
+  osMailQDef(fixLogMail, FIXLOG_QUEUE_LEN, FIXLOG_Record_t);
+  fixLogMailHandle = osMailCreate(osMailQ(fixLogMail), NULL);
+
+  osThreadDef(fixLogTask, FixLogTask, osPriorityBelowNormal, 0, FIXLOG_STACK_SIZE);
+  fixLogTaskHandle = osThreadCreate(osThread(fixLogTask), NULL);
+}
+#endif /* CONFIG_USE_FIXLOG */
+
 #if (USE_I2C == 1)
 /* This function creates a background task for I2C FSM */
 static void Background_Task_Init(void)
@@ -371,6 +423,54 @@ static void BackgroundTask(void const * argument)
 }
 #endif /* USE_I2C */
 
+#if (CONFIG_USE_FIXLOG == 1)
+/* FixLogTask function */
+static void FixLogTask(void const * argument)
+{
+  osEvent evt;
+
+  osMutexWait(fixLogMutexHandle, osWaitForever);
+  if (FIXLOG_Init() != FIXLOG_OK)
+  {
+    PRINT_OUT("Fix log init failed\r\n");
+  }
+  osMutexRelease(fixLogMutexHandle);
+
+  for(;;)
+  {
+    evt = osMailGet(fixLogMailHandle, osWaitForever);
+    if (evt.status == osEventMail)
+    {
+      osMutexWait(fixLogMutexHandle, osWaitForever);
+      (void)FIXLOG_Append((const FIXLOG_Record_t *)evt.value.p);
+      osMutexRelease(fixLogMutexHandle);
+      (void)osMailFree(fixLogMailHandle, evt.value.p);
+    }
+  }
+}
+
+/*
+ * Queue the last fix for FixLogTask, if one is due.
+ * To be called with the GNSS data mutex held: it never waits.
+ */
+static void FixLogPost(const GNSSParser_Data_t *pGNSSParser_Data)
+{
+  FIXLOG_Record_t rec;
+  FIXLOG_Record_t *mail;
+
+  if (FIXLOG_Sample(pGNSSParser_Data, &rec) == FIXLOG_OK)
+  {
+    /* A fix is dropped if FixLogTask is that late */
+    mail = (FIXLOG_Record_t *)osMailAlloc(fixLogMailHandle, 0);
+    if (mail != NULL)
+    {
+      *mail = rec;
+      (void)osMailPut(fixLogMailHandle, mail);
+    }
+  }
+}
+#endif /* CONFIG_USE_FIXLOG */
+
 /* TeseoConsumerTask function */
 void TeseoConsumerTask(void const * argument)
 {
@@ -397,6 +497,11 @@ void TeseoConsumerTask(void const * argument)
   //PRINT_OUT("\n\rTeseo Consumer Task running\n\r");
   GNSS_PARSER_Init(&GNSSParser_Data);
 
+#if (CONFIG_USE_SEED_CACHE == 1)
+  /* The seeds of the cache are restored by the console task */
+  (void)osSignalSet(consoleParseTaskHandle, GNSS_READY_SIGNAL);
+#endif /* CONFIG_USE_SEED_CACHE */
+
   for(;;)
   {    
     gnssMsg = GNSS1A1_GNSS_GetMessage(GNSS1A1_TESEO_LIV3F);
@@ -419,6 +524,11 @@ void TeseoConsumerTask(void const * argument)
 
         osMutexWait(gnssDataMutexHandle, osWaitForever);
         status = GNSS_PARSER_ParseMsg(&GNSSParser_Data, (eNMEAMsg)m, (uint8_t *)gnssMsg->buf);
+#if (CONFIG_USE_FIXLOG == 1)
+        if((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == GPGGA)) {
+          FixLogPost(&GNSSParser_Data);
+        }
+#endif /* CONFIG_USE_FIXLOG */
         osMutexRelease(gnssDataMutexHandle);
 
         if((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMVER)) {
@@ -480,6 +590,15 @@ void ConsoleParseTask(void const * argument)
   char cmd[32] = {0};
   uint8_t ch;
   
+#if (CONFIG_USE_SEED_CACHE == 1)
+  /* Send the seeds downloaded before the reset, if still valid.
+   * This runs here, as the seed commands, to keep a single user of the A-GNSS buffers.
+   */
+  (void)osSignalWait(GNSS_READY_SIGNAL, osWaitForever);
+  (void)AppAGNSS_RestoreSeed(DEFAULT_CONSTELLATION | BEI_CONSTELLATION, PR_SEED);
+  (void)AppAGNSS_RestoreSeed(DEFAULT_CONSTELLATION | BEI_CONSTELLATION, RT_SEED);
+#endif /* CONFIG_USE_SEED_CACHE */
+
   showCmds();
   for (;;)
   {
@@ -577,6 +696,9 @@ static void AppCmdProcess(char *com)
     PRINT_OUT("C or c: only BEI \r\n");
 
     PRINT_OUT("Type \"GETAGPSSTATUS\" to get A-GNSS status\r\n");
+#if (CONFIG_USE_SEED_CACHE == 1)
+    PRINT_OUT("Type \"ERASE-SEEDCACHE\" to erase the seeds cached in flash\r\n");
+#endif /* CONFIG_USE_SEED_CACHE */
 //    PRINT_OUT("Type \"SCALE-CLOCK-DOWN\" after conversion completed\r\n");
 
     showPrompt();
@@ -591,6 +713,17 @@ static void AppCmdProcess(char *com)
   else if (strncmp((char *)com, "DOWNLOAD-PR-DATA", strlen("DOWNLOAD-PR-DATA")) == 0) 
   {
     seedMask = AppAGNSS_ParseSeedOp(com);
+#if (CONFIG_USE_SEED_CACHE == 1)
+    /* The seeds still valid in the cache are not downloaded again */
+    if (seedMask != 0)
+    {
+      seedMask &= ~AppAGNSS_RestoreSeed(seedMask, PR_SEED);
+      if (seedMask == 0)
+      {
+        showPrompt();
+      }
+    }
+#endif /* CONFIG_USE_SEED_CACHE */
     if (seedMask != 0)
     {
       if (AppAGNSS_DownloadSeed(&GNSSParser_Data, seedMask, PR_SEED) == 0)
@@ -604,6 +737,17 @@ static void AppCmdProcess(char *com)
   else if (strncmp((char *)com, "DOWNLOAD-RT-DATA", strlen("DOWNLOAD-RT-DATA")) == 0) 
   {
     seedMask = AppAGNSS_ParseSeedOp(com);
+#if (CONFIG_USE_SEED_CACHE == 1)
+    /* The seeds still valid in the cache are not downloaded again */
+    if (seedMask != 0)
+    {
+      seedMask &= ~AppAGNSS_RestoreSeed(seedMask, RT_SEED);
+      if (seedMask == 0)
+      {
+        showPrompt();
+      }
+    }
+#endif /* CONFIG_USE_SEED_CACHE */
     if (seedMask != 0)
     {
       if(AppAGNSS_DownloadSeed(&GNSSParser_Data, seedMask, RT_SEED) == 0)
@@ -617,6 +761,13 @@ static void AppCmdProcess(char *com)
   {
     GNSS_DATA_SendCommand((uint8_t *)"$PSTMGETAGPSSTATUS");
   }
+#if (CONFIG_USE_SEED_CACHE == 1)
+  // ERASE-SEEDCACHE
+  else if (strcmp((char *)com, "ERASE-SEEDCACHE") == 0)
+  {
+    SEEDCACHE_Erase() == SEEDCACHE_OK ? PRINT_OUT("Seed cache erased\r\n> ") : PRINT_OUT("Seed cache erase failed\r\n> ");
+  }
+#endif /* CONFIG_USE_SEED_CACHE */
   // SCALE CLOCK DOWN
 //  else if(strncmp((char *)com, "SCALE-CLOCK-DOWN", strlen("SCALE-CLOCK-DOWN")) == 0) {
 //    GNSS_DATA_SendCommand(&pGNSS, "$PSTMGPSRESTART");
@@ -959,6 +1110,48 @@ static void AppCmdProcess(char *com)
     GNSS_DATA_SendCommand((uint8_t *)com);
   }
 
+#if (CONFIG_USE_FIXLOG == 1)
+  // 25 - FIXLOG (DUMP/ERASE)
+  else if(strcmp((char *)com, "25") == 0 || strcmp((char *)com, "fixlog-op") == 0)
+  {
+    sprintf(msg, "Fix log holds %lu fixes\r\n", (unsigned long)FIXLOG_GetCount());
+    PRINT_OUT(msg);
+    PRINT_OUT("Type \"DUMP-FIXLOG\" to print the fix log\r\n");
+    PRINT_OUT("Type \"ERASE-FIXLOG\" to erase the fix log\r\n");
+    PRINT_OUT("Type the command:\r\n> ");
+  }
+  // Fix log op
+  else if(strcmp((char *)com, "DUMP-FIXLOG") == 0)
+  {
+    FIXLOG_Record_t rec;
+    uint32_t cursor = 0;
+    uint32_t nrec = 0;
+    int32_t n;
+
+    /* Only the copy of each record is done under the lock, not the printing */
+    do
+    {
+      osMutexWait(fixLogMutexHandle, osWaitForever);
+      n = FIXLOG_Read(&cursor, &rec, 1);
+      osMutexRelease(fixLogMutexHandle);
+      if (n > 0)
+      {
+        FIXLOG_Print(&rec);
+        nrec++;
+      }
+    } while (n > 0);
+    sprintf(msg, "%lu fixes (utc date lat[1e-7deg] lon[1e-7deg] alt[dm] sats fix)\r\n", (unsigned long)nrec);
+    PRINT_OUT(msg);
+    showPrompt();
+  }
+  else if(strcmp((char *)com, "ERASE-FIXLOG") == 0)
+  {
+    osMutexWait(fixLogMutexHandle, osWaitForever);
+    FIXLOG_Erase() == FIXLOG_OK ? PRINT_OUT("Fix log erased\r\n> ") : PRINT_OUT("Fix log erase failed\r\n> ");
+    osMutexRelease(fixLogMutexHandle);
+  }
+#endif /* CONFIG_USE_FIXLOG */
+
   else
   {
     PRINT_OUT("Command not valid.\r\n\n>");
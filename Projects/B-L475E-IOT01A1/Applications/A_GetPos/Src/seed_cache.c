@@ -0,0 +1,264 @@
+/**
+  ******************************************************************************
+  * @file    seed_cache.c
+  * @author  SRA Application Team
+  * @brief   Cache of the converted A-GNSS seeds in the internal flash.
+  *
+  *          The cache area holds one slot per seed request (PR/RT) and
+  *          constellation. A slot starts with a header giving the validity
+  *          window of the seed in GPS seconds, followed by the data of the
+  *          seed as handed to SEEDCACHE_Store(). The header carries a CRC32
+  *          of itself and of the data: a slot torn by a reset, or left over
+  *          by another firmware, fails the check and is ignored.
+  *          Slots are written page by page through FLASH_update(), so that
+  *          each page is erased at most once per store, and not at all when
+  *          its content is unchanged.
+  *
+  *          The functions of this module are not reentrant: the caller has to
+  *          serialize the accesses.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <string.h>
+#include <stdio.h>
+
+#include "main.h"
+#include "flash.h"
+#include "seed_cache.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t magic;
+  uint8_t  req;
+  uint8_t  type;
+  uint16_t reserved;
+  uint32_t gps_start;     /* validity window, GPS seconds */
+  uint32_t gps_end;
+  uint32_t len;           /* bytes of data following the header */
+  uint32_t crc;           /* CRC32 of the previous fields and of the data */
+} SEEDCACHE_Header_t;
+
+/* Private defines -----------------------------------------------------------*/
+#define SEEDCACHE_MAGIC        0x53454544U  /* "SEED" */
+#define SEEDCACHE_BLANK        0xFFFFFFFFU
+#define SEEDCACHE_HDR_SZ       ((sizeof(SEEDCACHE_Header_t) + 7U) & ~7U)
+#define SEEDCACHE_DATA_MAX     (SEEDCACHE_SLOT_SIZE - SEEDCACHE_HDR_SZ)
+#define SEEDCACHE_CRC_LEN      (sizeof(SEEDCACHE_Header_t) - sizeof(uint32_t))
+
+#define SEEDCACHE_SLOT_ADDR(s) (SEEDCACHE_BASE_ADDR + ((s) * SEEDCACHE_SLOT_SIZE))
+
+/* Private variables ---------------------------------------------------------*/
+/* Content of the page being written */
+static uint64_t page_buf[FLASH_PAGE_SIZE / sizeof(uint64_t)];
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t SEEDCACHE_Crc32(uint32_t crc, const uint8_t *pData, uint32_t len);
+static int32_t  SEEDCACHE_Slot(seed_req_t seedReq, seed_type_t seedType);
+static uint8_t  SEEDCACHE_IsBlank(uint32_t addr, uint32_t len);
+
+/* Private functions ---------------------------------------------------------*/
+
+/* CRC32 (IEEE 802.3, reflected): start from 0xFFFFFFFF */
+static uint32_t SEEDCACHE_Crc32(uint32_t crc, const uint8_t *pData, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i++)
+  {
+    crc ^= pData[i];
+    for (uint8_t b = 0; b < 8U; b++)
+    {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+    }
+  }
+
+  return crc;
+}
+
+/* One slot per request and constellation */
+static int32_t SEEDCACHE_Slot(seed_req_t seedReq, seed_type_t seedType)
+{
+  int32_t slot = ((int32_t)seedReq * 4) + ((int32_t)seedType - (int32_t)GPS_SEED);
+
+  if ((seedType < GPS_SEED) || (seedType > BEI_SEED) || (slot >= (int32_t)SEEDCACHE_SLOT_NBR))
+  {
+    return SEEDCACHE_ERROR;
+  }
+
+  return slot;
+}
+
+/* Returns 1 if the flash area is in the erased state */
+static uint8_t SEEDCACHE_IsBlank(uint32_t addr, uint32_t len)
+{
+  for (uint32_t i = 0; i < len; i += 4U)
+  {
+    if (*(volatile uint32_t *)(addr + i) != SEEDCACHE_BLANK)
+    {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* Functions Definition ------------------------------------------------------*/
+
+/**
+  * @brief  Store a converted seed in its slot, replacing the previous one.
+  * @param  In: seedReq    Type of Assisted GNSS (PR/RT).
+  * @param  In: seedType   Constellation of the seed.
+  * @param  In: gpsStart   Start of the validity window, GPS seconds.
+  * @param  In: gpsEnd     End of the validity window, GPS seconds.
+  * @param  In: pSegs      Data of the seed, stored back to back.
+  * @param  In: nbr        Number of segments.
+  * @retval SEEDCACHE_OK on success, SEEDCACHE_ERROR otherwise.
+  */
+int32_t SEEDCACHE_Store(seed_req_t seedReq, seed_type_t seedType, uint32_t gpsStart, uint32_t gpsEnd,
+                        const SEEDCACHE_Seg_t *pSegs, uint32_t nbr)
+{
+  SEEDCACHE_Header_t hdr;
+  int32_t slot = SEEDCACHE_Slot(seedReq, seedType);
+  uint32_t total = 0;
+  uint32_t seg = 0;
+  uint32_t seg_off = 0;
+
+  if (slot < 0)
+  {
+    return SEEDCACHE_ERROR;
+  }
+  for (uint32_t i = 0; i < nbr; i++)
+  {
+    total += pSegs[i].len;
+  }
+  if (total > SEEDCACHE_DATA_MAX)
+  {
+    return SEEDCACHE_ERROR;
+  }
+
+  (void)memset(&hdr, 0, sizeof(hdr));
+  hdr.magic = SEEDCACHE_MAGIC;
+  hdr.req = (uint8_t)seedReq;
+  hdr.type = (uint8_t)seedType;
+  hdr.gps_start = gpsStart;
+  hdr.gps_end = gpsEnd;
+  hdr.len = total;
+  hdr.crc = SEEDCACHE_Crc32(0xFFFFFFFFU, (const uint8_t *)&hdr, SEEDCACHE_CRC_LEN);
+  for (uint32_t i = 0; i < nbr; i++)
+  {
+    hdr.crc = SEEDCACHE_Crc32(hdr.crc, (const uint8_t *)pSegs[i].data, pSegs[i].len);
+  }
+
+  total += SEEDCACHE_HDR_SZ;
+  for (uint32_t off = 0; off < total; off += FLASH_PAGE_SIZE)
+  {
+    uint8_t *page = (uint8_t *)page_buf;
+    uint32_t len = ((total - off) < FLASH_PAGE_SIZE) ? (total - off) : FLASH_PAGE_SIZE;
+    uint32_t pos = 0;
+
+    /* The header comes first, in the first page */
+    if (off == 0U)
+    {
+      (void)memset(page, 0, SEEDCACHE_HDR_SZ);
+      (void)memcpy(page, &hdr, sizeof(hdr));
+      pos = SEEDCACHE_HDR_SZ;
+    }
+    while (pos < len)
+    {
+      uint32_t n = pSegs[seg].len - seg_off;
+
+      if (n > (len - pos))
+      {
+        n = len - pos;
+      }
+      (void)memcpy(&page[pos], (const uint8_t *)pSegs[seg].data + seg_off, n);
+      pos += n;
+      seg_off += n;
+      if (seg_off == pSegs[seg].len)
+      {
+        seg++;
+        seg_off = 0;
+      }
+    }
+
+    if (memcmp((const void *)(SEEDCACHE_SLOT_ADDR((uint32_t)slot) + off), page, len) != 0)
+    {
+      if (FLASH_update(SEEDCACHE_SLOT_ADDR((uint32_t)slot) + off, page, len) != 0)
+      {
+        return SEEDCACHE_ERROR;
+      }
+    }
+  }
+
+  return SEEDCACHE_OK;
+}
+
+/**
+  * @brief  Get a seed of the cache, if valid at the given time.
+  * @param  In: seedReq    Type of Assisted GNSS (PR/RT).
+  * @param  In: seedType   Constellation of the seed.
+  * @param  In: gpsNow     Current time, GPS seconds.
+  * @param  Out: pLen      Length of the data of the seed.
+  * @retval Address in flash of the data of the seed, NULL if there is no valid seed.
+  */
+const uint8_t *SEEDCACHE_Get(seed_req_t seedReq, seed_type_t seedType, uint32_t gpsNow, uint32_t *pLen)
+{
+  int32_t slot = SEEDCACHE_Slot(seedReq, seedType);
+  const SEEDCACHE_Header_t *hdr;
+  const uint8_t *data;
+  uint32_t crc;
+
+  if (slot < 0)
+  {
+    return NULL;
+  }
+  hdr = (const SEEDCACHE_Header_t *)SEEDCACHE_SLOT_ADDR((uint32_t)slot);
+  data = (const uint8_t *)hdr + SEEDCACHE_HDR_SZ;
+
+  if ((hdr->magic != SEEDCACHE_MAGIC) || (hdr->req != (uint8_t)seedReq) || (hdr->type != (uint8_t)seedType) ||
+      (hdr->len > SEEDCACHE_DATA_MAX))
+  {
+    return NULL;
+  }
+  if ((gpsNow < hdr->gps_start) || (gpsNow >= hdr->gps_end))
+  {
+    return NULL;
+  }
+  crc = SEEDCACHE_Crc32(0xFFFFFFFFU, (const uint8_t *)hdr, SEEDCACHE_CRC_LEN);
+  if (SEEDCACHE_Crc32(crc, data, hdr->len) != hdr->crc)
+  {
+    return NULL;
+  }
+
+  *pLen = hdr->len;
+  return data;
+}
+
+/**
+  * @brief  Erase the whole cache area.
+  * @retval SEEDCACHE_OK on success, SEEDCACHE_ERROR otherwise.
+  */
+int32_t SEEDCACHE_Erase(void)
+{
+  for (uint32_t s = 0; s < SEEDCACHE_SLOT_NBR; s++)
+  {
+    if (SEEDCACHE_IsBlank(SEEDCACHE_SLOT_ADDR(s), SEEDCACHE_SLOT_SIZE) == 0U)
+    {
+      if (FLASH_Erase_Size(SEEDCACHE_SLOT_ADDR(s), SEEDCACHE_SLOT_SIZE) != HAL_OK)
+      {
+        return SEEDCACHE_ERROR;
+      }
+    }
+  }
+
+  return SEEDCACHE_OK;
+}
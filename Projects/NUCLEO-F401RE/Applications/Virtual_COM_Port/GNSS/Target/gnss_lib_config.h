@@ -27,6 +27,14 @@ extern "C" {
 #include <stdint.h>
 
 #include "teseo_liv3f_conf.h"
+
+/* LibGNSS options */
+#define CONFIG_USE_EPOCH_BIN 0 /* Binary epoch records off */
+
+#define CONFIG_USE_LAZY_DECODE 0 /* GGA/GNS/GST/RMC/GSA/GSV decoded when parsing (1: when first read) */
+
+#define CONFIG_USE_LEAN_DATA 0 /* Full GNSS data layout (1: disabled features' holders dropped, no LibAGNSS) */
+
 #if (USE_FREE_RTOS_NATIVE_API) /* native FreeRTOS API */
 #include "FreeRTOS.h"
 #include "task.h"
@@ -29,6 +29,13 @@ extern "C" {
 #include "teseo_liv3f_conf.h"
 #define OS_DELAY GNSS_Wrapper_Delay
 
+/* LibGNSS options */
+#define CONFIG_USE_LEAN_DATA 1 /* Lean GNSS data layout: disabled features' holders dropped (no LibAGNSS) */
+
+#define CONFIG_USE_EPOCH_BIN 0 /* Binary epoch records off */
+
+#define CONFIG_USE_LAZY_DECODE 0 /* GGA/GNS/GST/RMC/GSA/GSV decoded when parsing (1: when first read) */
+
 /** @addtogroup MIDDLEWARES
   *  @{
   */
@@ -57,6 +57,26 @@ extern "C" {
 
 #define CONFIG_USE_DATALOG 0 /* Datalog off */
 
+#define CONFIG_USE_QUEUE_PRIO 0 /* Queue full: the incoming sentence is dropped */
+
+#define CONFIG_USE_QUEUE_BATCH 0 /* Consumer task dequeues one sentence at a time */
+
+#define CONFIG_USE_QUEUE_BCAST 0 /* Single reader of the NMEA stream */
+
+#define CONFIG_USE_TRACE 0 /* Receive path trace off */
+
+#define MAX_MSG_QUEUE (12) /* Deeper NMEA queue, paid by the lean GNSS data layout */
+
+#define CONFIG_USE_STATIC_BUS 1 /* Driver calls the I2C HAL directly instead of the bus IO function pointers */
+
+#if (CONFIG_USE_STATIC_BUS == 1)
+#include "stm32l0xx_nucleo_bus.h"
+/* TESEO_LIV3F_I2C_7BITS_ADDR comes from teseo_liv3f.h, included by the driver */
+#define TESEO_LIV3F_BUS_RECEIVE_IT(pData, Length)   HAL_I2C_Master_Receive_IT(&hi2c1, (uint16_t)(TESEO_LIV3F_I2C_7BITS_ADDR << 1), (pData), (Length))
+#define TESEO_LIV3F_BUS_TRANSMIT_IT(pData, Length)  HAL_I2C_Master_Transmit_IT(&hi2c1, (uint16_t)(TESEO_LIV3F_I2C_7BITS_ADDR << 1), (pData), (Length))
+#define TESEO_LIV3F_BUS_GET_TICK()                  HAL_GetTick()
+#endif /* CONFIG_USE_STATIC_BUS */
+
 #if (GNSS_DEBUG == 1)
 #define PRINT_DBG(pBuffer)  GNSS_PRINT(pBuffer)
 #else
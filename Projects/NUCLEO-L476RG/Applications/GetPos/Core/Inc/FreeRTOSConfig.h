@@ -165,6 +165,21 @@ standard names. */
 
 /* USER CODE BEGIN Defines */
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+#include "teseo_liv3f_conf.h"
+
+#if (CONFIG_USE_TRACE == 1)
+/* Scheduling events recorded in the GNSS trace ring, together with the receive pipeline ones */
+#define traceTASK_SWITCHED_IN()                             GNSS_TRACE_Record(GNSS_TRACE_TASK_IN, (uint32_t)pxCurrentTCB)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)             GNSS_TRACE_Record(GNSS_TRACE_SEM_WAIT, (uint32_t)(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)                         GNSS_TRACE_Record(GNSS_TRACE_SEM_TAKE, (uint32_t)(pxQueue))
+#define traceQUEUE_SEND(pxQueue)                            GNSS_TRACE_Record(GNSS_TRACE_SEM_GIVE, (uint32_t)(pxQueue))
+#define traceTASK_PRIORITY_INHERIT(pxTCBOfMutexHolder, uxInheritedPriority) \
+                                                            GNSS_TRACE_Record(GNSS_TRACE_PRIO_INHERIT, (uint32_t)(pxTCBOfMutexHolder))
+#define traceTASK_PRIORITY_DISINHERIT(pxTCBOfMutexHolder, uxOriginalPriority) \
+                                                            GNSS_TRACE_Record(GNSS_TRACE_PRIO_DISINHERIT, (uint32_t)(pxTCBOfMutexHolder))
+#endif /* CONFIG_USE_TRACE */
+#endif /* __ICCARM__ || __CC_ARM || __GNUC__ */
 /* USER CODE END Defines */
 
 #endif /* FREERTOS_CONFIG_H */
@@ -56,6 +56,8 @@ void TIM1_UP_TIM16_IRQHandler(void);
 void I2C1_EV_IRQHandler(void);
 void I2C1_ER_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel7_IRQHandler(void);
+void USART2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
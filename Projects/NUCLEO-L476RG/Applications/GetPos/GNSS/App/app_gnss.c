@@ -28,8 +28,12 @@
 #include "stm32l4xx_nucleo.h"
 #include "gnss1a1_conf.h"
 #include "teseo_liv3f_conf.h"
+#include "gnss_console.h"
 #include "gnss_feature_cfg_data.h"
 #include "gnss_utils.h"
+#if (CONFIG_USE_TRACE == 1)
+#include "queue.h"
+#endif /* CONFIG_USE_TRACE */
 
 /* USER CODE BEGIN Includes */
 
@@ -76,6 +80,55 @@ osThreadId_t backgroundTaskHandle;
 /* Private variables ---------------------------------------------------------*/
 static GNSSParser_Data_t GNSSParser_Data;
 static uint8_t gnss_feature = 0x0;
+#if (CONFIG_USE_RX_LATENCY == 1)
+/* Latency stages, all measured from the end of the sentence on the bus */
+#define LATENCY_DEQUEUE 0U /* Sentence handed to TeseoConsumerTask */
+#define LATENCY_PARSE   1U /* Sentence parsed and handled */
+#define LATENCY_READ    2U /* Fix of a $GPGGA sentence read by the application */
+#define LATENCY_STAGES  3U
+#define LATENCY_BUCKETS 16U /* bucket n holds [2^(n-1), 2^n) ms, the last one is open */
+
+static uint32_t latencyHist[LATENCY_STAGES][LATENCY_BUCKETS];
+static uint32_t fixTick;
+static uint8_t fixUnread = 0;
+#endif /* CONFIG_USE_RX_LATENCY */
+#if (CONFIG_USE_EPOCH_BIN == 1)
+static uint8_t epochBinOut = 0;
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+#if (CONFIG_USE_TRACE == 1)
+/* Trace ring: events are overwritten oldest first, the DWT cycle counter stamps them */
+typedef struct
+{
+  uint32_t ts;
+  uint32_t evt;
+  uint32_t arg;
+} TraceEvt_t;
+
+static TraceEvt_t traceRing[TRACE_RING_SIZE];
+static volatile uint32_t traceWr = 0;
+static volatile uint8_t traceFrozen = 0;
+
+#define APP_TRACE(evt, arg) GNSS_TRACE_Record((evt), (uint32_t)(arg))
+#else
+#define APP_TRACE(evt, arg)
+#endif /* CONFIG_USE_TRACE */
+
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+/* Console RX ring filled by the USART2 RX interrupt, read line by line by ConsoleParseTask */
+static uint8_t consoleRxBuf[CONSOLE_RX_BUF_SIZE];
+static volatile uint32_t consoleRxRd = 0;
+static volatile uint32_t consoleRxWr = 0;
+static volatile uint32_t consoleRxLines = 0;
+static uint8_t consoleRxByte;
+
+/* Semaphore signalling a complete line in the console RX ring */
+#if (osCMSIS < 0x20000U)
+static osSemaphoreId consoleRxSemHandle;
+#else
+static osSemaphoreId_t consoleRxSemHandle;
+#endif /* osCMSIS */
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
 
 /* USER CODE BEGIN PV */
 
@@ -112,11 +165,36 @@ static osThreadAttr_t task_attributes =
 };
 #endif /* osCMSIS */
 
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+static void Console_RxInit(void);
+static void Console_ReadLine(char *pLine, uint32_t size);
+static void Console_RxCpltCallback(UART_HandleTypeDef *huart);
+#else
 static uint8_t ConsoleReadable(void);
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
 
+static void AppMsgHandler(eNMEAMsg msg);
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+static void AppParseMsg(const GNSS1A1_GNSS_Msg_t *gnssMsg);
+#endif /* CONFIG_USE_QUEUE_BATCH */
 static void AppCmdProcess(char *com);
 static void AppCfgMsgList(uint32_t lowMask, uint32_t highMask);
 
+#if (CONFIG_USE_RX_STATS == 1)
+static void AppRxStats(void);
+#endif /* CONFIG_USE_RX_STATS */
+
+#if (CONFIG_USE_RX_LATENCY == 1)
+static void AppLatencyAdd(uint32_t stage, uint32_t tick);
+static void AppLatencyFixRead(void);
+static void AppLatencyDump(void);
+#endif /* CONFIG_USE_RX_LATENCY */
+
+#if (CONFIG_USE_TRACE == 1)
+static void AppTraceInit(void);
+static void AppTraceDump(void);
+#endif /* CONFIG_USE_TRACE */
+
 #if (CONFIG_USE_FEATURE == 1)
 static void AppEnFeature(char *command);
 #endif /* CONFIG_USE_FEATURE */
@@ -136,6 +214,10 @@ static void AppDatalogOp(char *command);
 static uint8_t GetSWVerCmdIsAllowed(char *com);
 static uint8_t SetPARameterCmdIsAllowed(const char *com);
 static uint8_t GetPARameterCmdIsAllowed(const char *com);
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1) || (CONFIG_USE_CONSOLE_RX_IT == 1)
+static void Console_ErrorCallback(UART_HandleTypeDef *huart);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA || CONFIG_USE_CONSOLE_RX_IT */
+
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -151,6 +233,15 @@ void MX_GNSS_Init(void)
   {
     Error_Handler();
   }
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  if (GNSS_CONSOLE_TxInit(&hcom_uart[COM1]) != 0)
+  {
+    Error_Handler();
+  }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+#if (CONFIG_USE_TRACE == 1)
+  AppTraceInit();
+#endif /* CONFIG_USE_TRACE */
 
   /* USER CODE BEGIN GNSS_Init_PostTreatment */
 
@@ -261,8 +352,13 @@ static void TeseoConsumerTask(void const *argument)
 static void TeseoConsumerTask(void *argument)
 #endif /* osCMSIS */
 {
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+  const GNSS1A1_GNSS_Msg_t *gnssBatch[MAX_MSG_QUEUE];
+  uint32_t nbr;
+#else
   GNSSParser_Status_t status, check;
   const GNSS1A1_GNSS_Msg_t *gnssMsg;
+#endif /* CONFIG_USE_QUEUE_BATCH */
 
   GNSS1A1_GNSS_Init(GNSS1A1_TESEO_LIV3F);
 
@@ -283,6 +379,25 @@ static void TeseoConsumerTask(void *argument)
 
   for (;;)
   {
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+    if ((GNSS1A1_GNSS_GetMessageBatch(GNSS1A1_TESEO_LIV3F, gnssBatch, MAX_MSG_QUEUE, &nbr) != BSP_ERROR_NONE) ||
+        (nbr == 0U))
+    {
+      continue;
+    }
+
+    /* one lock for the whole burst, released only to handle the command answers */
+    osMutexAcquire(gnssDataMutexHandle, osWaitForever);
+    APP_TRACE(GNSS_TRACE_PARSE_BEGIN, nbr);
+    for (uint32_t k = 0; k < nbr; k++)
+    {
+      AppParseMsg(gnssBatch[k]);
+    }
+    APP_TRACE(GNSS_TRACE_PARSE_END, nbr);
+    osMutexRelease(gnssDataMutexHandle);
+
+    GNSS1A1_GNSS_ReleaseMessageBatch(GNSS1A1_TESEO_LIV3F, gnssBatch, nbr);
+#else
     gnssMsg = GNSS1A1_GNSS_GetMessage(GNSS1A1_TESEO_LIV3F);
 
     if (gnssMsg == NULL)
@@ -290,63 +405,145 @@ static void TeseoConsumerTask(void *argument)
       continue;
     }
 
-    check = GNSS_PARSER_CheckSanity((uint8_t *)gnssMsg->buf, gnssMsg->len);
+#if (CONFIG_USE_RX_LATENCY == 1)
+    AppLatencyAdd(LATENCY_DEQUEUE, gnssMsg->tick);
+#endif /* CONFIG_USE_RX_LATENCY */
+
+    check = GNSS_PARSER_CheckMsg(&GNSSParser_Data, (uint8_t *)gnssMsg->buf, gnssMsg->len);
 
     if (check != GNSS_PARSER_ERROR)
     {
+      APP_TRACE(GNSS_TRACE_PARSE_BEGIN, 1U);
       for (uint8_t m = 0; m < NMEA_MSGS_NUM; m++)
       {
         osMutexAcquire(gnssDataMutexHandle, osWaitForever);
         status = GNSS_PARSER_ParseMsg(&GNSSParser_Data, (eNMEAMsg)m, (uint8_t *)gnssMsg->buf);
-        osMutexRelease(gnssDataMutexHandle);
-
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMVER))
+#if (CONFIG_USE_RX_LATENCY == 1)
+        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == GPGGA))
         {
-          GNSS_DATA_GetPSTMVerInfo(&GNSSParser_Data);
+          fixTick = gnssMsg->tick;
+          fixUnread = 1;
         }
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMSETPAR))
+#endif /* CONFIG_USE_RX_LATENCY */
+        osMutexRelease(gnssDataMutexHandle);
+
+        if (status != GNSS_PARSER_ERROR)
         {
-          GNSS_DATA_GetPSTMSetParInfo(&GNSSParser_Data);
+          AppMsgHandler((eNMEAMsg)m);
         }
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMGETPAR))
+
+#if (CONFIG_USE_EPOCH_BIN == 1)
+        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == GPGGA) && (epochBinOut == 1U))
         {
-          GNSS_DATA_GetPSTMGetParInfo(&GNSSParser_Data);
+          osMutexAcquire(gnssDataMutexHandle, osWaitForever);
+          GNSS_DATA_SendEpoch(&GNSSParser_Data);
+#if (CONFIG_USE_RX_LATENCY == 1)
+          AppLatencyFixRead();
+#endif /* CONFIG_USE_RX_LATENCY */
+          osMutexRelease(gnssDataMutexHandle);
         }
+#endif /* CONFIG_USE_EPOCH_BIN */
+      }
+      APP_TRACE(GNSS_TRACE_PARSE_END, 1U);
+    }
+#if (CONFIG_USE_RX_LATENCY == 1)
+    AppLatencyAdd(LATENCY_PARSE, gnssMsg->tick);
+#endif /* CONFIG_USE_RX_LATENCY */
+    GNSS1A1_GNSS_ReleaseMessage(GNSS1A1_TESEO_LIV3F, gnssMsg);
+#endif /* CONFIG_USE_QUEUE_BATCH */
+  }
+}
+
+/* Handles the answers to the proprietary commands */
+static void AppMsgHandler(eNMEAMsg msg)
+{
+  switch (msg)
+  {
+    case PSTMVER:
+      GNSS_DATA_GetPSTMVerInfo(&GNSSParser_Data);
+      break;
+    case PSTMSETPAR:
+      GNSS_DATA_GetPSTMSetParInfo(&GNSSParser_Data);
+      break;
+    case PSTMGETPAR:
+      GNSS_DATA_GetPSTMGetParInfo(&GNSSParser_Data);
+      break;
 #if (CONFIG_USE_GEOFENCE == 1)
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMGEOFENCE))
-        {
-          GNSS_DATA_GetGeofenceInfo(&GNSSParser_Data);
-        }
+    case PSTMGEOFENCE:
+      GNSS_DATA_GetGeofenceInfo(&GNSSParser_Data);
+      break;
 #endif /* CONFIG_USE_GEOFENCE */
-
 #if (CONFIG_USE_ODOMETER == 1)
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMODO))
-        {
-          GNSS_DATA_GetOdometerInfo(&GNSSParser_Data);
-        }
+    case PSTMODO:
+      GNSS_DATA_GetOdometerInfo(&GNSSParser_Data);
+      break;
 #endif /* CONFIG_USE_ODOMETER */
-
 #if (CONFIG_USE_DATALOG == 1)
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMDATALOG))
-        {
-          GNSS_DATA_GetDatalogInfo(&GNSSParser_Data);
-        }
+    case PSTMDATALOG:
+      GNSS_DATA_GetDatalogInfo(&GNSSParser_Data);
+      break;
 #endif /* CONFIG_USE_DATALOG */
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMSGL))
-        {
-          GNSS_DATA_GetMsglistAck(&GNSSParser_Data);
-        }
+    case PSTMSGL:
+      GNSS_DATA_GetMsglistAck(&GNSSParser_Data);
+      break;
+    case PSTMSAVEPAR:
+      GNSS_DATA_GetGNSSAck(&GNSSParser_Data);
+      break;
+    default:
+      break;
+  }
+}
 
-        if ((status != GNSS_PARSER_ERROR) && ((eNMEAMsg)m == PSTMSAVEPAR))
-        {
-          GNSS_DATA_GetGNSSAck(&GNSSParser_Data);
-        }
+#if (CONFIG_USE_QUEUE_BATCH == 1)
+/* Parses a message of a batch, called with gnssDataMutexHandle held */
+static void AppParseMsg(const GNSS1A1_GNSS_Msg_t *gnssMsg)
+{
+  GNSSParser_Status_t status, check;
+
+#if (CONFIG_USE_RX_LATENCY == 1)
+  AppLatencyAdd(LATENCY_DEQUEUE, gnssMsg->tick);
+#endif /* CONFIG_USE_RX_LATENCY */
+
+  check = GNSS_PARSER_CheckMsg(&GNSSParser_Data, (uint8_t *)gnssMsg->buf, gnssMsg->len);
+
+  if (check != GNSS_PARSER_ERROR)
+  {
+    for (uint8_t m = 0; m < NMEA_MSGS_NUM; m++)
+    {
+      status = GNSS_PARSER_ParseMsg(&GNSSParser_Data, (eNMEAMsg)m, (uint8_t *)gnssMsg->buf);
+      if (status == GNSS_PARSER_ERROR)
+      {
+        continue;
+      }
+#if (CONFIG_USE_RX_LATENCY == 1)
+      if ((eNMEAMsg)m == GPGGA)
+      {
+        fixTick = gnssMsg->tick;
+        fixUnread = 1;
+      }
+#endif /* CONFIG_USE_RX_LATENCY */
+#if (CONFIG_USE_EPOCH_BIN == 1)
+      if (((eNMEAMsg)m == GPGGA) && (epochBinOut == 1U))
+      {
+        GNSS_DATA_SendEpoch(&GNSSParser_Data);
+#if (CONFIG_USE_RX_LATENCY == 1)
+        AppLatencyFixRead();
+#endif /* CONFIG_USE_RX_LATENCY */
+      }
+#endif /* CONFIG_USE_EPOCH_BIN */
+      if ((eNMEAMsg)m >= PSTMVER)
+      {
+        osMutexRelease(gnssDataMutexHandle);
+        AppMsgHandler((eNMEAMsg)m);
+        osMutexAcquire(gnssDataMutexHandle, osWaitForever);
       }
     }
-    GNSS1A1_GNSS_ReleaseMessage(GNSS1A1_TESEO_LIV3F, gnssMsg);
-
   }
+#if (CONFIG_USE_RX_LATENCY == 1)
+  AppLatencyAdd(LATENCY_PARSE, gnssMsg->tick);
+#endif /* CONFIG_USE_RX_LATENCY */
 }
+#endif /* CONFIG_USE_QUEUE_BATCH */
 
 #if (osCMSIS < 0x20000U)
 static void ConsoleParseTask(void const *argument)
@@ -355,6 +552,27 @@ static void ConsoleParseTask(void *argument)
 #endif /* osCMSIS */
 {
   char cmd[32] = {0};
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+
+  Console_RxInit();
+
+  showCmds();
+  for (;;)
+  {
+    /* Sleep until a whole line has been received */
+    Console_ReadLine(cmd, sizeof(cmd));
+
+    if (strlen(cmd) > 0)
+    {
+      AppCmdProcess(cmd);
+      memset(cmd, 0, sizeof(cmd));
+    }
+    else
+    {
+      showPrompt();
+    }
+  }
+#else
   uint8_t ch;
 
   showCmds();
@@ -392,10 +610,14 @@ static void ConsoleParseTask(void *argument)
       cmd[strlen(cmd)] = ch;
     }
   }
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
 }
 
 static void ConsoleRead(uint8_t *string)
 {
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+  Console_ReadLine((char *)string, MAX_STR_LEN);
+#else
   uint8_t ch;
 
   while (1)
@@ -422,6 +644,7 @@ static void ConsoleRead(uint8_t *string)
       }
     }
   }
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
 }
 
 static void AppCmdProcess(char *com)
@@ -456,6 +679,9 @@ static void AppCmdProcess(char *com)
   {
     osMutexAcquire(gnssDataMutexHandle, osWaitForever);
     GNSS_DATA_GetValidInfo(&GNSSParser_Data);
+#if (CONFIG_USE_RX_LATENCY == 1)
+    AppLatencyFixRead();
+#endif /* CONFIG_USE_RX_LATENCY */
     osMutexRelease(gnssDataMutexHandle);
   }
 
@@ -810,6 +1036,51 @@ static void AppCmdProcess(char *com)
     GNSS_DATA_SendCommand((uint8_t *)com);
   }
 
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  /* 25 - BINOUT */
+  else if (strcmp((char *)com, "25") == 0 || strcmp((char *)com, "binout") == 0)
+  {
+    epochBinOut ^= 1U;
+    PRINT_OUT((epochBinOut == 1U) ? "Binary epoch output on.\r\n\n>" : "Binary epoch output off.\r\n\n>");
+  }
+#endif /* CONFIG_USE_EPOCH_BIN */
+
+#if (CONFIG_USE_RX_STATS == 1)
+  /* 26 - RXSTATS */
+  else if (strcmp((char *)com, "26") == 0 || strcmp((char *)com, "rxstats") == 0)
+  {
+    AppRxStats();
+  }
+#endif /* CONFIG_USE_RX_STATS */
+
+#if (CONFIG_USE_RX_LATENCY == 1)
+  /* 27 - LATENCY */
+  else if (strcmp((char *)com, "27") == 0 || strcmp((char *)com, "latency") == 0)
+  {
+    AppLatencyDump();
+  }
+  else if (strcmp((char *)com, "latency-reset") == 0)
+  {
+    osMutexAcquire(gnssDataMutexHandle, osWaitForever);
+    memset(latencyHist, 0, sizeof(latencyHist));
+    osMutexRelease(gnssDataMutexHandle);
+    PRINT_OUT("Latency histograms cleared.\r\n\n>");
+  }
+#endif /* CONFIG_USE_RX_LATENCY */
+
+#if (CONFIG_USE_TRACE == 1)
+  /* 28 - TRACE */
+  else if (strcmp((char *)com, "28") == 0 || strcmp((char *)com, "trace") == 0)
+  {
+    AppTraceDump();
+  }
+  else if (strcmp((char *)com, "trace-reset") == 0)
+  {
+    traceWr = 0;
+    PRINT_OUT("Trace cleared.\r\n\n>");
+  }
+#endif /* CONFIG_USE_TRACE */
+
   else
   {
     PRINT_OUT("Command not valid.\r\n\n>");
@@ -822,6 +1093,237 @@ static void AppCfgMsgList(uint32_t lowMask, uint32_t highMask)
   GNSS_DATA_CfgMessageList(lowMask, highMask);
 }
 
+#if (CONFIG_USE_RX_STATS == 1)
+/* Dump the receive path statistics, rates are averaged since boot */
+static void AppRxStats(void)
+{
+  static const char *msgName[NMEA_MSGS_NUM] =
+  {
+    "GPGGA", "GNS", "GPGST", "GPRMC", "GSA", "GSV", "PSTMVER", "PSTMPASSRTN",
+    "PSTMAGPSSTATUS", "PSTMGEOFENCE", "PSTMODO", "PSTMDATALOG", "PSTMSGL",
+    "PSTMSAVEPAR", "PSTMSETPAROK", "PSTMSETPAR", "PSTMSRR", "PSTMRESTOREPAR", "PSTMGETPAR"
+  };
+  GNSS1A1_GNSS_Stats_t rxStats;
+  GNSSParser_Stats_t parserStats;
+  uint32_t elapsed = HAL_GetTick();
+  uint32_t rate;
+  char line[64];
+
+  if (GNSS1A1_GNSS_GetStats(GNSS1A1_TESEO_LIV3F, &rxStats) != BSP_ERROR_NONE)
+  {
+    PRINT_OUT("Statistics not available.\r\n\n>");
+    return;
+  }
+  osMutexAcquire(gnssDataMutexHandle, osWaitForever);
+  parserStats = GNSSParser_Data.stats;
+  osMutexRelease(gnssDataMutexHandle);
+
+  if (elapsed == 0U)
+  {
+    elapsed = 1U;
+  }
+
+  (void)snprintf(line, sizeof(line), "Uptime:          %lu s\r\n", elapsed / 1000U);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Sentences:       %lu\r\n", rxStats.rx_msgs);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Queue drops:     %lu\r\n", rxStats.drops);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Queue evictions: %lu\r\n", rxStats.evictions);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Bus errors:      %lu\r\n", rxStats.rx_errors);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Queue HWM:       %lu/%d\r\n", rxStats.queue_hwm, MAX_MSG_QUEUE);
+  PRINT_OUT(line);
+  (void)snprintf(line, sizeof(line), "Checksum errors: %lu\r\n", parserStats.checksum_errors);
+  PRINT_OUT(line);
+
+  for (uint8_t m = 0; m < NMEA_MSGS_NUM; m++)
+  {
+    if (parserStats.msg_count[m] != 0U)
+    {
+      /* sentences per second, one decimal */
+      rate = (uint32_t)(((uint64_t)parserStats.msg_count[m] * 10000U) / elapsed);
+      (void)snprintf(line, sizeof(line), "  %-15s %8lu  %lu.%lu/s\r\n",
+                     msgName[m], parserStats.msg_count[m], rate / 10U, rate % 10U);
+      PRINT_OUT(line);
+    }
+  }
+  PRINT_OUT("\r\n>");
+}
+#endif /* CONFIG_USE_RX_STATS */
+
+#if (CONFIG_USE_RX_LATENCY == 1)
+/* Account the time elapsed since tick in the log2 histogram of a stage */
+static void AppLatencyAdd(uint32_t stage, uint32_t tick)
+{
+  uint32_t delta = HAL_GetTick() - tick;
+  uint32_t bucket = 0;
+
+  while ((delta != 0U) && (bucket < (LATENCY_BUCKETS - 1U)))
+  {
+    delta >>= 1;
+    bucket++;
+  }
+  latencyHist[stage][bucket]++;
+}
+
+/* Account the first read of the latest fix, called with gnssDataMutexHandle held */
+static void AppLatencyFixRead(void)
+{
+  if (fixUnread == 1U)
+  {
+    AppLatencyAdd(LATENCY_READ, fixTick);
+    fixUnread = 0;
+  }
+}
+
+/* Dump the latency histograms, one row per non-empty bucket */
+static void AppLatencyDump(void)
+{
+  static uint32_t hist[LATENCY_STAGES][LATENCY_BUCKETS];
+  char range[16];
+  char line[64];
+
+  osMutexAcquire(gnssDataMutexHandle, osWaitForever);
+  memcpy(hist, latencyHist, sizeof(hist));
+  osMutexRelease(gnssDataMutexHandle);
+
+  PRINT_OUT("Latency [ms]      dequeue      parse       read\r\n");
+  for (uint32_t b = 0; b < LATENCY_BUCKETS; b++)
+  {
+    if ((hist[LATENCY_DEQUEUE][b] | hist[LATENCY_PARSE][b] | hist[LATENCY_READ][b]) == 0U)
+    {
+      continue;
+    }
+    if (b == 0U)
+    {
+      (void)snprintf(range, sizeof(range), "0");
+    }
+    else if (b == (LATENCY_BUCKETS - 1U))
+    {
+      (void)snprintf(range, sizeof(range), ">= %lu", 1UL << (b - 1U));
+    }
+    else
+    {
+      (void)snprintf(range, sizeof(range), "%lu-%lu", 1UL << (b - 1U), (1UL << b) - 1UL);
+    }
+    (void)snprintf(line, sizeof(line), "%-12s %10lu %10lu %10lu\r\n", range,
+                   hist[LATENCY_DEQUEUE][b], hist[LATENCY_PARSE][b], hist[LATENCY_READ][b]);
+    PRINT_OUT(line);
+  }
+  PRINT_OUT("\r\n>");
+}
+#endif /* CONFIG_USE_RX_LATENCY */
+
+#if (CONFIG_USE_TRACE == 1)
+/* Start the DWT cycle counter used to stamp the trace events */
+static void AppTraceInit(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/* Record an event, from any task, ISR or kernel hook */
+void GNSS_TRACE_Record(uint32_t evt, uint32_t arg)
+{
+  TraceEvt_t *pEvt;
+  uint32_t primask;
+
+  if (traceFrozen != 0U)
+  {
+    return;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  pEvt = &traceRing[traceWr & (TRACE_RING_SIZE - 1U)];
+  traceWr++;
+  pEvt->ts = DWT->CYCCNT;
+  pEvt->evt = evt;
+  pEvt->arg = arg;
+  __set_PRIMASK(primask);
+}
+
+/* Dump the trace ring, oldest event first. Recording is suspended meanwhile. */
+static void AppTraceDump(void)
+{
+  static const char *const evtName[] =
+  {
+    [TESEO_TRACE_WR_CLAIM]        = "wr-claim",
+    [TESEO_TRACE_WR_DROP]         = "wr-drop",
+    [TESEO_TRACE_WR_RELEASE]      = "wr-release",
+    [TESEO_TRACE_RD_CLAIM]        = "rd-claim",
+    [TESEO_TRACE_RD_RELEASE]      = "rd-release",
+    [TESEO_TRACE_EVICT]           = "evict",
+    [TESEO_TRACE_RX_ERROR]        = "rx-error",
+    [GNSS_TRACE_PARSE_BEGIN]      = "parse-begin",
+    [GNSS_TRACE_PARSE_END]        = "parse-end",
+    [GNSS_TRACE_PRINT_BEGIN]      = "print-begin",
+    [GNSS_TRACE_PRINT_END]        = "print-end",
+    [GNSS_TRACE_TASK_IN]          = "task-in",
+    [GNSS_TRACE_SEM_WAIT]         = "sem-wait",
+    [GNSS_TRACE_SEM_TAKE]         = "sem-take",
+    [GNSS_TRACE_SEM_GIVE]         = "sem-give",
+    [GNSS_TRACE_PRIO_INHERIT]     = "prio-inherit",
+    [GNSS_TRACE_PRIO_DISINHERIT]  = "prio-disinherit",
+  };
+  const TraceEvt_t *pEvt;
+  const char *name;
+  const char *obj;
+  uint32_t cyclesPerUs = SystemCoreClock / 1000000U;
+  uint32_t first;
+  uint32_t last;
+  uint32_t t0;
+  char line[80];
+
+  traceFrozen = 1;
+  last = traceWr;
+  first = (last > TRACE_RING_SIZE) ? (last - TRACE_RING_SIZE) : 0U;
+  t0 = traceRing[first & (TRACE_RING_SIZE - 1U)].ts;
+
+  PRINT_OUT("      [us] event           object\r\n");
+  for (uint32_t i = first; i < last; i++)
+  {
+    pEvt = &traceRing[i & (TRACE_RING_SIZE - 1U)];
+    name = ((pEvt->evt < (sizeof(evtName) / sizeof(evtName[0]))) && (evtName[pEvt->evt] != NULL)) ?
+           evtName[pEvt->evt] : "?";
+    obj = NULL;
+
+    switch (pEvt->evt)
+    {
+      case GNSS_TRACE_TASK_IN:
+      case GNSS_TRACE_PRIO_INHERIT:
+      case GNSS_TRACE_PRIO_DISINHERIT:
+        obj = pcTaskGetName((TaskHandle_t)pEvt->arg);
+        break;
+      case GNSS_TRACE_SEM_WAIT:
+      case GNSS_TRACE_SEM_TAKE:
+      case GNSS_TRACE_SEM_GIVE:
+#if (configQUEUE_REGISTRY_SIZE > 0)
+        obj = pcQueueGetName((QueueHandle_t)pEvt->arg);
+#endif /* configQUEUE_REGISTRY_SIZE */
+        break;
+      default:
+        break;
+    }
+
+    if (obj != NULL)
+    {
+      (void)snprintf(line, sizeof(line), "%10lu %-15s %s\r\n", (pEvt->ts - t0) / cyclesPerUs, name, obj);
+    }
+    else
+    {
+      (void)snprintf(line, sizeof(line), "%10lu %-15s 0x%08lx\r\n", (pEvt->ts - t0) / cyclesPerUs, name, pEvt->arg);
+    }
+    PRINT_OUT(line);
+  }
+  traceFrozen = 0;
+  PRINT_OUT("\r\n>");
+}
+#endif /* CONFIG_USE_TRACE */
+
 /* Enable feature */
 #if (CONFIG_USE_FEATURE == 1)
 static void AppEnFeature(char *command)
@@ -906,6 +1408,7 @@ static void AppDatalogOp(char *command)
 }
 #endif /* CONFIG_USE_DATALOG */
 
+#if (CONFIG_USE_CONSOLE_RX_IT == 0)
 static uint8_t ConsoleReadable(void)
 {
   /*  To avoid a target blocking case, let's check for
@@ -918,6 +1421,7 @@ static uint8_t ConsoleReadable(void)
   /* Check if data is received */
   return (__HAL_UART_GET_FLAG(&hcom_uart[COM1], UART_FLAG_RXNE) != RESET) ? 1 : 0;
 }
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
 
 static uint8_t GetSWVerCmdIsAllowed(char *com)
 {
@@ -984,23 +1488,235 @@ static uint8_t GetPARameterCmdIsAllowed(const char *com)
 
 uint8_t GNSS_PRINT(char *pBuffer)
 {
+  APP_TRACE(GNSS_TRACE_PRINT_BEGIN, strlen((char *)pBuffer));
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)pBuffer, strlen((char *)pBuffer));
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)pBuffer, (uint16_t)strlen((char *)pBuffer), 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+  APP_TRACE(GNSS_TRACE_PRINT_END, 0U);
+
+  return 0;
+}
+
+uint8_t GNSS_WRITE(const uint8_t *pBuffer, uint32_t len)
+{
+  APP_TRACE(GNSS_TRACE_PRINT_BEGIN, len);
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite(pBuffer, len);
+#else
+  if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)pBuffer, (uint16_t)len, 1000) != HAL_OK)
+  {
+    return 1;
+  }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+  APP_TRACE(GNSS_TRACE_PRINT_END, 0U);
 
   return 0;
 }
 
 uint8_t GNSS_PUTC(char pChar)
 {
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)&pChar, 1);
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&pChar, 1, 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
   return 0;
 }
 
+/*
+ * Wait until all the queued console output has been sent.
+ * Returns 1 if the ring is not empty after timeout ms.
+ */
+uint8_t GNSS_FLUSH(uint32_t timeout)
+{
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  return GNSS_CONSOLE_TxFlush(timeout);
+#else
+  (void)timeout;
+
+  return 0;
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+}
+
+
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+/*
+ * Create the line semaphore and start receiving the console input
+ * one character at a time under interrupt.
+ */
+static void Console_RxInit(void)
+{
+#if (osCMSIS < 0x20000U)
+  osSemaphoreDef(console_rx_sem);
+  consoleRxSemHandle = osSemaphoreCreate(osSemaphore(console_rx_sem), 1);
+#else
+  consoleRxSemHandle = osSemaphoreNew(1, 0, NULL);
+#endif /* osCMSIS */
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 1)
+  if ((HAL_UART_RegisterCallback(&hcom_uart[COM1], HAL_UART_RX_COMPLETE_CB_ID, Console_RxCpltCallback) != HAL_OK) ||
+      (HAL_UART_RegisterCallback(&hcom_uart[COM1], HAL_UART_ERROR_CB_ID, Console_ErrorCallback) != HAL_OK))
+  {
+    Error_Handler();
+  }
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+
+  HAL_NVIC_SetPriority(USART2_IRQn, 5, 0);
+  HAL_NVIC_EnableIRQ(USART2_IRQn);
+
+  /* Drop anything left over in the receive register */
+  __HAL_UART_CLEAR_OREFLAG(&hcom_uart[COM1]);
+  __HAL_UART_SEND_REQ(&hcom_uart[COM1], UART_RXDATA_FLUSH_REQUEST);
+
+  if (HAL_UART_Receive_IT(&hcom_uart[COM1], &consoleRxByte, 1) != HAL_OK)
+  {
+    Error_Handler();
+  }
+}
+
+/*
+ * Sleep until a complete line is in the console RX ring, then copy it
+ * (without the terminator) into pLine, truncated to size - 1 characters.
+ */
+static void Console_ReadLine(char *pLine, uint32_t size)
+{
+  uint32_t primask;
+  uint32_t len = 0;
+  uint8_t ch;
+
+  while (consoleRxLines == 0U)
+  {
+#if (osCMSIS < 0x20000U)
+    (void)osSemaphoreWait(consoleRxSemHandle, osWaitForever);
+#else
+    (void)osSemaphoreAcquire(consoleRxSemHandle, osWaitForever);
+#endif /* osCMSIS */
+  }
+
+  do
+  {
+    ch = consoleRxBuf[consoleRxRd];
+    consoleRxRd = (consoleRxRd + 1U) % CONSOLE_RX_BUF_SIZE;
+    if ((ch != (uint8_t)'\r') && (len < (size - 1U)))
+    {
+      pLine[len] = (char)ch;
+      len++;
+    }
+  } while (ch != (uint8_t)'\r');
+  pLine[len] = '\0';
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  consoleRxLines--;
+  __set_PRIMASK(primask);
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 0)
+  /* Without the TX ring the echo cannot be done from the interrupt */
+  PRINT_OUT(pLine);
+  PRINT_OUT("\n\r");
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+}
+
+/*
+ * USART2 RX complete: store the character, echo it and wake
+ * ConsoleParseTask when a line is complete.
+ */
+static void Console_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  uint8_t ch = consoleRxByte;
+  uint32_t used;
+
+  if (huart != &hcom_uart[COM1])
+  {
+    return;
+  }
+  (void)HAL_UART_Receive_IT(&hcom_uart[COM1], &consoleRxByte, 1);
+
+  if ((ch != (uint8_t)'\r') && !((ch > 31U) && (ch < 126U)))
+  {
+    return;
+  }
+
+  /* The last free slot is kept for a terminator, so that a full ring always holds a line */
+  used = (consoleRxWr + CONSOLE_RX_BUF_SIZE - consoleRxRd) % CONSOLE_RX_BUF_SIZE;
+  if ((used + ((ch == (uint8_t)'\r') ? 1U : 2U)) > (CONSOLE_RX_BUF_SIZE - 1U))
+  {
+    return;
+  }
+  consoleRxBuf[consoleRxWr] = ch;
+  consoleRxWr = (consoleRxWr + 1U) % CONSOLE_RX_BUF_SIZE;
+
+  if (ch == (uint8_t)'\r')
+  {
+    consoleRxLines++;
+    (void)osSemaphoreRelease(consoleRxSemHandle);
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+    PRINT_OUT("\n\r");
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+  }
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  else
+  {
+    PUTC_OUT((char)ch);
+  }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+}
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 0)
+/**
+  * @brief  Rx Transfer completed callback
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+{
+  Console_RxCpltCallback(huart);
+}
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1) || (CONFIG_USE_CONSOLE_RX_IT == 1)
+/*
+ * USART2 error: the HAL has stopped the transfer in error, restart it.
+ */
+static void Console_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  if (huart != &hcom_uart[COM1])
+  {
+    return;
+  }
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxErrorCallback(huart);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+  if (huart->RxState == HAL_UART_STATE_READY)
+  {
+    (void)HAL_UART_Receive_IT(&hcom_uart[COM1], &consoleRxByte, 1);
+  }
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
+}
+
+#if (USE_HAL_UART_REGISTER_CALLBACKS == 0)
+/**
+  * @brief  UART error callback
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  Console_ErrorCallback(huart);
+}
+#endif /* USE_HAL_UART_REGISTER_CALLBACKS */
+#endif /* CONFIG_USE_CONSOLE_TX_DMA || CONFIG_USE_CONSOLE_RX_IT */
+
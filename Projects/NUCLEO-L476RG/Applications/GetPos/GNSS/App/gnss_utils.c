@@ -22,6 +22,7 @@
 
 #include "gnss_utils.h"
 #include "teseo_liv3f_conf.h"
+#include "gnss_lib_config.h"
 
 /* Defines -------------------------------------------------------------------*/
 
@@ -83,6 +84,21 @@ void printHelp(void)
   PRINT_INFO("\n\r22) SAVE-CDB REGISTER:\r\n\tApi to save the CDB Register.\n");
   PRINT_INFO("\n\r23) SYSTEM RESET:\r\n\tApi for the system reset.\n");
   PRINT_INFO("\n\r24) CDB FACTORY RESET:\r\n\tApi to restore factory setting parameters.\n");
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  PRINT_INFO("\n\r25) BINOUT:\r\n\tToggles the output of a binary record for each fix.\n");
+#endif /* CONFIG_USE_EPOCH_BIN */
+#if (CONFIG_USE_RX_STATS == 1)
+  PRINT_INFO("\n\r26) RXSTATS:\r\n\tPrints the receive path statistics and the sentence rates.\n");
+#endif /* CONFIG_USE_RX_STATS */
+#if (CONFIG_USE_RX_LATENCY == 1)
+  PRINT_INFO("\n\r27) LATENCY:\r\n\tPrints the log2 histograms of the time from the end of a sentence on the bus "
+             "to its dequeue, to the end of its parsing and, for a fix, to its first read by the application.\r\n"
+             "\tType \"latency-reset\" to clear them.\n");
+#endif /* CONFIG_USE_RX_LATENCY */
+#if (CONFIG_USE_TRACE == 1)
+  PRINT_INFO("\n\r28) TRACE:\r\n\tPrints the last receive, parse, print and scheduling events, oldest first.\r\n"
+             "\tType \"trace-reset\" to clear them.\n");
+#endif /* CONFIG_USE_TRACE */
   PRINT_INFO("\n\r> ");
   /* PRINT_INFO("\n\r 0) ENDAPP:\r\n\tEnds the application.\r\n\tTo restart it, "
                 "press CTRL+B command on the console or restart the Nucleo.\n\n\r"); */
@@ -127,6 +143,18 @@ void showCmds(void)
   PRINT_INFO("22 - save-cdb\n\r");
   PRINT_INFO("23 - reset\n\r");
   PRINT_INFO("24 - cdb-factoryreset\n\r");
+#if (CONFIG_USE_EPOCH_BIN == 1)
+  PRINT_INFO("25 - binout\n\r");
+#endif /* CONFIG_USE_EPOCH_BIN */
+#if (CONFIG_USE_RX_STATS == 1)
+  PRINT_INFO("26 - rxstats\n\r");
+#endif /* CONFIG_USE_RX_STATS */
+#if (CONFIG_USE_RX_LATENCY == 1)
+  PRINT_INFO("27 - latency\n\r");
+#endif /* CONFIG_USE_RX_LATENCY */
+#if (CONFIG_USE_TRACE == 1)
+  PRINT_INFO("28 - trace\n\r");
+#endif /* CONFIG_USE_TRACE */
   PRINT_INFO("\n\rSave configuration (y/n)? ");
   PRINT_INFO("\n\r> ");
 }
@@ -57,6 +57,56 @@ extern "C" {
 
 #define CONFIG_USE_DATALOG 0 /* Datalog off */
 
+#define CONFIG_USE_QUEUE_BCAST 0 /* Single reader of the NMEA stream */
+
+#define CONFIG_USE_STATIC_BUS 0 /* Driver calls the bus through the IO function pointers */
+
+#define CONFIG_USE_RX_STATS 0 /* Receive path and parser statistics off */
+
+#define CONFIG_USE_RX_LATENCY 0 /* Sentence latency histograms off */
+
+#define CONFIG_USE_QUEUE_PRIO 1 /* Queue full: the lowest priority sentence is dropped (TESEO_QUEUE_PRIO_TABLE) */
+
+#define CONFIG_USE_QUEUE_BATCH 1 /* Consumer task dequeues all the received sentences at once */
+
+#define CONFIG_USE_CONSOLE_TX_DMA 1 /* Console output queued in a ring drained by the UART TX DMA */
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+/* Overflow policies of the console TX ring */
+#define CONSOLE_TX_DROP_OLDEST 0 /* Discard the oldest unsent output to make room */
+#define CONSOLE_TX_BLOCK       1 /* Wait for the DMA to drain enough room */
+
+#define CONSOLE_TX_BUF_SIZE        2048U
+#define CONSOLE_TX_OVERFLOW_POLICY CONSOLE_TX_BLOCK
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+
+#define CONFIG_USE_CONSOLE_RX_IT 1 /* Console input collected in a ring by the UART RX interrupt */
+
+#if (CONFIG_USE_CONSOLE_RX_IT == 1)
+#define CONSOLE_RX_BUF_SIZE 512U
+#endif /* CONFIG_USE_CONSOLE_RX_IT */
+
+#define CONFIG_USE_TRACE 0 /* Receive, parse, print and scheduling events not recorded */
+
+#if (CONFIG_USE_TRACE == 1)
+#define TRACE_RING_SIZE 256U /* Number of events, a power of 2 */
+
+/* Receive path trace points of the driver (TESEO_TRACE_xxx) */
+#define TESEO_LIV3F_TRACE(evt, arg) GNSS_TRACE_Record((uint32_t)(evt), (uint32_t)(arg))
+
+/* Application and kernel trace points, numbered after the driver ones */
+#define GNSS_TRACE_PARSE_BEGIN      16U /* arg: number of sentences */
+#define GNSS_TRACE_PARSE_END        17U
+#define GNSS_TRACE_PRINT_BEGIN      18U /* arg: number of bytes */
+#define GNSS_TRACE_PRINT_END        19U
+#define GNSS_TRACE_TASK_IN          32U /* arg: task handle */
+#define GNSS_TRACE_SEM_WAIT         33U /* arg: queue, semaphore or mutex handle */
+#define GNSS_TRACE_SEM_TAKE         34U
+#define GNSS_TRACE_SEM_GIVE         35U
+#define GNSS_TRACE_PRIO_INHERIT     36U /* arg: task handle of the mutex holder */
+#define GNSS_TRACE_PRIO_DISINHERIT  37U
+#endif /* CONFIG_USE_TRACE */
+
 #if (GNSS_DEBUG == 1)
 #define PRINT_DBG(pBuffer)  GNSS_PRINT(pBuffer)
 #else
@@ -66,10 +116,16 @@ extern "C" {
 #define PRINT_INFO(pBuffer) GNSS_PRINT(pBuffer)
 #define PRINT_OUT(pBuffer)  GNSS_PRINT(pBuffer)
 #define PUTC_OUT(pChar)     GNSS_PUTC(pChar)
+#define PRINT_BIN(pBuffer, len) GNSS_WRITE(pBuffer, len)
 
 /* Exported functions prototypes ---------------------------------------------*/
 uint8_t GNSS_PRINT(char *pBuffer);
 uint8_t GNSS_PUTC(char pChar);
+uint8_t GNSS_WRITE(const uint8_t *pBuffer, uint32_t len);
+uint8_t GNSS_FLUSH(uint32_t timeout);
+#if (CONFIG_USE_TRACE == 1)
+void    GNSS_TRACE_Record(uint32_t evt, uint32_t arg);
+#endif /* CONFIG_USE_TRACE */
 
 #ifdef __cplusplus
 }
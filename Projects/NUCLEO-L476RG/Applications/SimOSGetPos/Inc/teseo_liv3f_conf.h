@@ -57,6 +57,29 @@ extern "C" {
 
 #define CONFIG_USE_DATALOG 0 /* Datalog off */
 
+#define CONFIG_USE_QUEUE_PRIO 0 /* Queue full: the incoming sentence is dropped */
+
+#define CONFIG_USE_QUEUE_BATCH 0 /* Consumer task dequeues one sentence at a time */
+
+#define CONFIG_USE_QUEUE_BCAST 0 /* Single reader of the NMEA stream */
+
+#define CONFIG_USE_STATIC_BUS 0 /* Driver calls the bus through the IO function pointers */
+
+#define CONFIG_USE_TRACE 0 /* Receive path trace off */
+
+#define CONFIG_USE_CONSOLE_TX_DMA 1 /* Console output queued in a ring drained by the UART TX DMA */
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+/* Overflow policies of the console TX ring */
+#define CONSOLE_TX_DROP_OLDEST 0 /* Discard the oldest unsent output to make room */
+#define CONSOLE_TX_BLOCK       1 /* Wait for the DMA to drain enough room */
+
+#define CONSOLE_TX_BUF_SIZE        2048U
+#define CONSOLE_TX_OVERFLOW_POLICY CONSOLE_TX_BLOCK
+#define CONSOLE_TX_IRQ_PRIO        0U
+#define CONSOLE_TX_WAIT_OS         0 /* No RTOS: spin while waiting for room */
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+
 #if (GNSS_DEBUG == 1)
 #define PRINT_DBG(pBuffer)  GNSS_PRINT(pBuffer)
 #else
@@ -70,6 +93,7 @@ extern "C" {
 /* Exported functions prototypes ---------------------------------------------*/
 uint8_t GNSS_PRINT(char *pBuffer);
 uint8_t GNSS_PUTC(char pChar);
+uint8_t GNSS_FLUSH(uint32_t timeout);
 
 #ifdef __cplusplus
 }
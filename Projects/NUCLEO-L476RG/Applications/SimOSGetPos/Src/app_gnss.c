@@ -28,6 +28,7 @@
 
 #include "gnss1a1_conf.h"
 #include "teseo_liv3f_conf.h"
+#include "gnss_console.h"
 
 #include "gnss1a1_gnss.h"
 #include "gnss_data.h"
@@ -60,6 +61,7 @@ static void AppGeofenceCfg(char *command);
 static void AppEnFeature(char *command);
 #endif /* CONFIG_USE_FEATURE */
 
+
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -75,6 +77,12 @@ void MX_GNSS_Init(void)
   {
     Error_Handler();
   }
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  if (GNSS_CONSOLE_TxInit(&hcom_uart[COM1]) != 0)
+  {
+    Error_Handler();
+  }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
   PRINT_DBG("Booting...\r\n");
 
@@ -217,23 +225,58 @@ static void AppGeofenceCfg(char *command)
 
 uint8_t GNSS_PRINT(char *pBuffer)
 {
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)pBuffer, strlen((char *)pBuffer));
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)pBuffer, (uint16_t)strlen((char *)pBuffer), 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
   return 0;
 }
 
 uint8_t GNSS_PUTC(char pChar)
 {
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)&pChar, 1);
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&pChar, 1, 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+
+  return 0;
+}
+
+/*
+ * Wait until all the queued console output has been sent.
+ * Returns 1 if the ring is not empty after timeout ms.
+ */
+uint8_t GNSS_FLUSH(uint32_t timeout)
+{
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  return GNSS_CONSOLE_TxFlush(timeout);
+#else
+  (void)timeout;
 
   return 0;
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+}
+
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1) && (USE_HAL_UART_REGISTER_CALLBACKS == 0)
+/**
+  * @brief  UART error callback
+  * @param  huart UART handle
+  * @retval None
+  */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
+{
+  GNSS_CONSOLE_TxErrorCallback(huart);
 }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA && USE_HAL_UART_REGISTER_CALLBACKS */
 
@@ -22,6 +22,7 @@
 #include "stm32l4xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "teseo_liv3f_conf.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -59,6 +60,9 @@ extern I2C_HandleTypeDef hi2c1;
 extern TIM_HandleTypeDef htim1;
 
 /* USER CODE BEGIN EV */
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+extern DMA_HandleTypeDef hdma_usart2_tx;
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
 /* USER CODE END EV */
 
@@ -243,5 +247,22 @@ void I2C1_ER_IRQHandler(void)
 }
 
 /* USER CODE BEGIN 1 */
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+/**
+  * @brief This function handles DMA1 channel7 global interrupt (console TX).
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+}
+
+/**
+  * @brief This function handles USART2 global interrupt (console).
+  */
+void USART2_IRQHandler(void)
+{
+  HAL_UART_IRQHandler(&hcom_uart[COM1]);
+}
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
 /* USER CODE END 1 */
@@ -55,6 +55,8 @@ void DebugMon_Handler(void);
 void TIM1_UP_TIM16_IRQHandler(void);
 void USART1_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void DMA1_Channel7_IRQHandler(void);
+void USART2_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -28,6 +28,7 @@
 #include "gnss1a1_conf.h"
 #include "gnss1a1_gnss.h"
 #include "teseo_liv3f_conf.h"
+#include "gnss_console.h"
 
 /* USER CODE BEGIN Includes */
 
@@ -99,6 +100,7 @@ static osThreadAttr_t task_attributes =
 
 static uint8_t ConsoleReadable(void);
 
+
 /* USER CODE BEGIN PFP */
 
 /* USER CODE END PFP */
@@ -114,6 +116,12 @@ void MX_GNSS_Init(void)
   {
     Error_Handler();
   }
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  if (GNSS_CONSOLE_TxInit(&hcom_uart[COM1]) != 0)
+  {
+    Error_Handler();
+  }
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
   BSP_PB_Init(BUTTON_KEY, BUTTON_MODE_EXTI);
 
@@ -298,23 +306,46 @@ static uint8_t ConsoleReadable(void)
 
 uint8_t GNSS_PRINT(char *pBuffer)
 {
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)pBuffer, strlen((char *)pBuffer));
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)pBuffer, (uint16_t)strlen((char *)pBuffer), 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 
   return 0;
 }
 
 uint8_t GNSS_PUTC(char pChar)
 {
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  GNSS_CONSOLE_TxWrite((uint8_t *)&pChar, 1);
+#else
   if (HAL_UART_Transmit(&hcom_uart[COM1], (uint8_t *)&pChar, 1, 1000) != HAL_OK)
   {
     return 1;
   }
   fflush(stdout);
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
+
+  return 0;
+}
+
+/*
+ * Wait until all the queued console output has been sent.
+ * Returns 1 if the ring is not empty after timeout ms.
+ */
+uint8_t GNSS_FLUSH(uint32_t timeout)
+{
+#if (CONFIG_USE_CONSOLE_TX_DMA == 1)
+  return GNSS_CONSOLE_TxFlush(timeout);
+#else
+  (void)timeout;
 
   return 0;
+#endif /* CONFIG_USE_CONSOLE_TX_DMA */
 }
 
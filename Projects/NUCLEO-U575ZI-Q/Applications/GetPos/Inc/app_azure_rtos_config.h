@@ -48,7 +48,7 @@ extern "C" {
 /* Minimum stack size per thread  */
 #define GNSS_THREAD_MINIMUM_STACK                (2048)
 
-#define GNSS_NUM_OF_THREADS                      (4)
+#define GNSS_NUM_OF_THREADS                      (5)
 #define GNSS_APP_MEM_POOL_SIZE                   (GNSS_NUM_OF_THREADS * GNSS_THREAD_MINIMUM_STACK)
 
 /* USER CODE BEGIN EC */
@@ -57,6 +57,26 @@ extern "C" {
 
 #define CONFIG_USE_DATALOG 0 /* Datalog off */
 
+#define CONFIG_USE_QUEUE_PRIO 0 /* Queue full: the incoming sentence is dropped */
+
+#define CONFIG_USE_QUEUE_BATCH 0 /* Consumer task dequeues one sentence at a time */
+
+#define CONFIG_USE_STATIC_BUS 0 /* Driver calls the bus through the IO function pointers */
+
+#define CONFIG_USE_TRACE 0 /* Receive path trace off */
+
+#define CONFIG_USE_QUEUE_BCAST 1 /* Broadcast queue: several readers of the NMEA stream */
+
+/* Receive path trace points (TESEO_TRACE_xxx) logged as TraceX user events.
+ * Needs TX_ENABLE_EVENT_TRACE in tx_user.h, the event log is started by MX_GNSS_Init().
+ */
+#include "tx_api.h"
+#if defined(TX_ENABLE_EVENT_TRACE)
+#define GNSS_TRACE_BUF_SIZE 8192U /* TraceX event log, in bytes */
+#define TESEO_LIV3F_TRACE(evt, arg) \
+  ((void)tx_trace_user_event_insert(TX_TRACE_USER_EVENT_START + (ULONG)(evt), (ULONG)(arg), 0, 0, 0))
+#endif /* TX_ENABLE_EVENT_TRACE */
+
 #if (GNSS_DEBUG == 1)
 #define PRINT_DBG(pBuffer)  GNSS_PRINT(pBuffer)
 #else
@@ -43,9 +43,14 @@
 #else
 #define BACKGROUND_STACK_SIZE 0 /* in case of USART bus, the background task is not used */
 #endif /* USE_I2C */
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+#define ECHO_STACK_SIZE         (GNSS_THREAD_MINIMUM_STACK)
+#else
+#define ECHO_STACK_SIZE 0 /* the echo task reads the broadcast queue only */
+#endif /* CONFIG_USE_QUEUE_BCAST */
 #define SAFETY_STACK_SIZE       (GNSS_THREAD_MINIMUM_STACK)
 
-#if (GNSS_APP_MEM_POOL_SIZE < (BACKGROUND_STACK_SIZE + CONSOLE_STACK_SIZE + CONSUMER_STACK_SIZE + SAFETY_STACK_SIZE))
+#if (GNSS_APP_MEM_POOL_SIZE < (BACKGROUND_STACK_SIZE + CONSOLE_STACK_SIZE + CONSUMER_STACK_SIZE + ECHO_STACK_SIZE + SAFETY_STACK_SIZE))
 #warning "The application requires a greater GNSS_APP_MEM_POOL_SIZE!"
 #endif /* (GNSS_APP_MEM_POOL_SIZE) */
 
@@ -54,6 +59,9 @@
 #if (USE_I2C == 1)
 #define TESEO_BACKGROUND_TASK_PRIORITY  1
 #endif /* USE_I2C */
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+#define NMEA_ECHO_TASK_PRIORITY         2 /* below the parser: the echo may overrun */
+#endif /* CONFIG_USE_QUEUE_BCAST */
 
 /* Global variables ----------------------------------------------------------*/
 /* Mutex for GNSS data access */
@@ -67,9 +75,16 @@ TX_THREAD consoleParseTaskHandle;
 TX_THREAD backgroundTaskHandle;
 #endif /* USE_I2C */
 
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+TX_THREAD nmeaEchoTaskHandle;
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 /* Private variables ---------------------------------------------------------*/
 static GNSSParser_Data_t GNSSParser_Data;
 static uint8_t gnss_feature = 0x0;
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+static volatile uint8_t nmeaEcho = 0;
+#endif /* CONFIG_USE_QUEUE_BCAST */
 
 /* USER CODE BEGIN PV */
 
@@ -89,6 +104,10 @@ static void ConsoleParseTask(ULONG argument);
 #if (USE_I2C == 1)
 static void BackgroundTask(ULONG argument);
 #endif /* USE_I2C */
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+static UINT Nmea_Echo_Task_Init(VOID *memory_ptr);
+static void NmeaEchoTask(ULONG argument);
+#endif /* CONFIG_USE_QUEUE_BCAST */
 
 static uint8_t ConsoleReadable(void);
 
@@ -143,6 +162,12 @@ UINT MX_GNSS_Init(VOID *memory_ptr)
 
   /* USER CODE END MX_GNSS_Init */
 
+#if defined(TX_ENABLE_EVENT_TRACE)
+  /* TraceX event log, with the receive path events of the driver */
+  static UCHAR traceBuffer[GNSS_TRACE_BUF_SIZE];
+  (void)tx_trace_enable(traceBuffer, sizeof(traceBuffer), 32);
+#endif /* TX_ENABLE_EVENT_TRACE */
+
   /* Initialize the tasks */
 
   ret = Console_Parse_Task_Init(memory_ptr);
@@ -162,6 +187,13 @@ UINT MX_GNSS_Init(VOID *memory_ptr)
   {
     return ret;
   }
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  ret = Nmea_Echo_Task_Init(memory_ptr);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+#endif /* CONFIG_USE_QUEUE_BCAST */
 
   PRINT_DBG("Booting...\r\n");
   return ret;
@@ -222,6 +254,29 @@ static UINT Background_Task_Init(VOID *memory_ptr)
 }
 #endif /* USE_I2C */
 
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/* This function creates the task echoing the NMEA stream on the console */
+static UINT Nmea_Echo_Task_Init(VOID *memory_ptr)
+{
+  TX_BYTE_POOL *byte_pool = (TX_BYTE_POOL *)memory_ptr;
+  UINT ret = TX_SUCCESS;
+  CHAR *pointer;
+  UINT nmea_echo_task_preemption_th = NMEA_ECHO_TASK_PRIORITY;
+
+  ret = tx_byte_allocate(byte_pool, (VOID **)&pointer, ECHO_STACK_SIZE, TX_NO_WAIT);
+  if (ret != TX_SUCCESS)
+  {
+    return ret;
+  }
+
+  ret = tx_thread_create(&nmeaEchoTaskHandle, "NmeaEchoTask", NmeaEchoTask, 0,
+                         pointer, ECHO_STACK_SIZE, NMEA_ECHO_TASK_PRIORITY,
+                         nmea_echo_task_preemption_th,
+                         TX_NO_TIME_SLICE, TX_AUTO_START);
+  return ret;
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 static UINT Console_Parse_Task_Init(VOID *memory_ptr)
 {
   TX_BYTE_POOL *byte_pool = (TX_BYTE_POOL *)memory_ptr;
@@ -344,6 +399,57 @@ static void TeseoConsumerTask(ULONG argument)
   }
 }
 
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+/* NmeaEchoTask function: a second reader of the queue, it may overrun without stalling the parser */
+static void NmeaEchoTask(ULONG argument)
+{
+  const GNSS1A1_GNSS_Msg_t *gnssMsg;
+  uint32_t consumerId = 0;
+  uint32_t overruns;
+  uint8_t registered = 0;
+  char msg[48];
+
+  for (;;)
+  {
+    if (nmeaEcho == 0U)
+    {
+      if (registered == 1U)
+      {
+        (void)GNSS1A1_GNSS_GetConsumerOverruns(GNSS1A1_TESEO_LIV3F, consumerId, &overruns);
+        (void)GNSS1A1_GNSS_UnregisterConsumer(GNSS1A1_TESEO_LIV3F, consumerId);
+        registered = 0;
+        snprintf(msg, sizeof(msg), "\r\nNMEA echo off, %lu sentences missed\r\n> ", overruns);
+        PRINT_OUT(msg);
+      }
+      tx_thread_sleep(TX_TIMER_TICKS_PER_SECOND / 10);
+      continue;
+    }
+
+    if (registered == 0U)
+    {
+      if (GNSS1A1_GNSS_RegisterConsumer(GNSS1A1_TESEO_LIV3F, TESEO_QUEUE_CONSUMER_OVERRUN, &consumerId) != BSP_ERROR_NONE)
+      {
+        PRINT_OUT("No consumer of the queue left.\r\n> ");
+        nmeaEcho = 0;
+        continue;
+      }
+      registered = 1;
+    }
+
+    gnssMsg = GNSS1A1_GNSS_GetConsumerMessage(GNSS1A1_TESEO_LIV3F, consumerId);
+    if (gnssMsg == NULL)
+    {
+      continue;
+    }
+    for (uint16_t i = 0; i < gnssMsg->len; i++)
+    {
+      PUTC_OUT((char)gnssMsg->buf[i]);
+    }
+    (void)GNSS1A1_GNSS_ReleaseConsumerMessage(GNSS1A1_TESEO_LIV3F, consumerId, gnssMsg);
+  }
+}
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
 static void ConsoleParseTask(ULONG argument)
 {
   char cmd[32] = {0};
@@ -802,6 +908,18 @@ static void AppCmdProcess(char *com)
     GNSS_DATA_SendCommand((uint8_t *)com);
   }
 
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  /* 25 NMEA ECHO */
+  else if (strcmp((char *)com, "25") == 0 || strcmp((char *)com, "nmea-echo") == 0)
+  {
+    nmeaEcho = (nmeaEcho == 0U) ? 1U : 0U;
+    if (nmeaEcho == 1U)
+    {
+      PRINT_OUT("NMEA echo on, type \"25\" again to stop it.\r\n");
+    }
+  }
+#endif /* CONFIG_USE_QUEUE_BCAST */
+
   else
   {
     PRINT_OUT("Command not valid.\r\n\n>");
@@ -83,6 +83,9 @@ void printHelp(void)
   PRINT_INFO("\n\r22) SAVE-CDB REGISTER:\r\n\tApi to save the CDB Register.\n");
   PRINT_INFO("\n\r23) SYSTEM RESET:\r\n\tApi for the system reset.\n");
   PRINT_INFO("\n\r24) CDB FACTORY RESET:\r\n\tApi to restore factory setting parameters.\n");
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  PRINT_INFO("\n\r25) NMEA ECHO:\r\n\tToggles the echo of the NMEA stream, read by a second consumer of the queue.\n");
+#endif /* CONFIG_USE_QUEUE_BCAST */
   PRINT_INFO("\n\r> ");
   /* PRINT_INFO("\n\r 0) ENDAPP:\r\n\tEnds the application.\r\n\tTo restart it, "
                 "press CTRL+B command on the console or restart the Nucleo.\n\n\r"); */
@@ -127,6 +130,9 @@ void showCmds(void)
   PRINT_INFO("22 - save-cdb\n\r");
   PRINT_INFO("23 - reset\n\r");
   PRINT_INFO("24 - cdb-factoryreset\n\r");
+#if (CONFIG_USE_QUEUE_BCAST == 1)
+  PRINT_INFO("25 - nmea-echo\n\r");
+#endif /* CONFIG_USE_QUEUE_BCAST */
   PRINT_INFO("\n\rSave configuration (y/n)? ");
   PRINT_INFO("\n\r> ");
 }
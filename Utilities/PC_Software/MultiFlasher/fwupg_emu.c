@@ -0,0 +1,316 @@
+/**
+  ******************************************************************************
+  * @file    fwupg_emu.c
+  * @author  SRA Application Team
+  * @brief   Pseudo-terminal stand-in of boards running FWUpgrade(): it answers
+  *          the FWUPG frames as the MCU and the Teseo flasher would, to test
+  *          fwupg_multi on Linux without any hardware.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+#define _GNU_SOURCE
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+
+#include "fwupg_proto.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define VER_OLD  "PSTMVER,BINIMG_4.6.6.0_CP_LIV3F"
+#define VER_NEW  "PSTMVER,BINIMG_4.6.8.2_CP_LIV3F"
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  int         id;
+  int         master;
+  char        name[64];
+  /* session */
+  int         crc_mode;
+  int         staged;
+  int         synced;
+  uint32_t    next;        /* index of the next chunk */
+  uint32_t    img_len;     /* from the Image Info */
+  uint32_t    img_crc;
+  uint32_t    rx_len;
+  uint32_t    rx_crc;
+  uint32_t    chunk_cnt;   /* for the fault injection */
+  int         upgraded;
+} Board_t;
+
+/* Private variables ---------------------------------------------------------*/
+static int write_ms;       /* Teseo write time of a chunk */
+static uint32_t nack_every;
+static uint32_t drop_every;
+static int verbose;
+
+/* Private functions ---------------------------------------------------------*/
+static void reply(const Board_t *b, const void *buf, size_t len)
+{
+  (void)fwupg_write(b->master, (const uint8_t *)buf, len);
+}
+
+static void reply_ack(const Board_t *b, uint8_t ack)
+{
+  reply(b, &ack, 1);
+}
+
+static void on_ctrl(Board_t *b, const uint8_t *cmd)
+{
+  uint8_t rsp[FWUPG_CHUNK_IDX_SZ];
+
+  if (memcmp(cmd, "START", FWUPG_CTRL_SZ) == 0)
+  {
+    b->crc_mode = 0;
+    b->staged = 0;
+    b->synced = 0;
+    reply(b, b->upgraded ? VER_NEW : VER_OLD, strlen(VER_OLD));
+  }
+  else if (memcmp(cmd, "CRC32", FWUPG_CTRL_SZ) == 0)
+  {
+    b->crc_mode = 1;
+    reply_ack(b, FWUPG_ACK);
+  }
+  else if (memcmp(cmd, "STAGE", FWUPG_CTRL_SZ) == 0)
+  {
+    b->staged = 1;
+    reply_ack(b, FWUPG_ACK);
+  }
+  else if (memcmp(cmd, "RESUM", FWUPG_CTRL_SZ) == 0)
+  {
+    fwupg_put32(rsp, (b->synced != 0) ? b->next : FWUPG_RESUME_NONE);
+    reply(b, rsp, sizeof(rsp));
+  }
+  else if (memcmp(cmd, "CLOSE", FWUPG_CTRL_SZ) == 0)
+  {
+    b->synced = 0;
+    b->crc_mode = 0;
+  }
+  else
+  {
+    /* Unknown command */
+  }
+}
+
+static void on_sync(Board_t *b, const uint8_t *sync)
+{
+  const uint8_t *info = &sync[5];
+
+  if ((fwupg_get32(sync) != FWUPG_IDENTIFIER) || (sync[4] != FWUPG_START_COMM) ||
+      (sync[5U + FWUPG_IMAGE_INFO_SZ] != FWUPG_FLASHER_READY))
+  {
+    reply_ack(b, FWUPG_NACK);
+    return;
+  }
+  b->img_len = fwupg_get32(&info[0]);
+  b->img_crc = fwupg_get32(&info[8]);
+  b->rx_len = 0;
+  b->rx_crc = 0xFFFFFFFFU;
+  b->next = 0;
+  b->chunk_cnt = 0;
+  b->synced = 1;
+  reply_ack(b, FWUPG_ACK);
+}
+
+static void on_chunk(Board_t *b, const uint8_t *buf, uint32_t len)
+{
+  const uint8_t *chunk = buf;
+  uint32_t idx;
+
+  b->chunk_cnt++;
+  if ((b->synced == 0) || ((nack_every != 0U) && ((b->chunk_cnt % nack_every) == 0U)))
+  {
+    reply_ack(b, FWUPG_NACK);
+    return;
+  }
+  if (b->crc_mode != 0)
+  {
+    if ((len <= (FWUPG_CHUNK_IDX_SZ + FWUPG_CHUNK_CRC_SZ)) ||
+        (~fwupg_crc32_update(0xFFFFFFFFU, buf, len - FWUPG_CHUNK_CRC_SZ) != fwupg_get32(&buf[len - FWUPG_CHUNK_CRC_SZ])))
+    {
+      reply_ack(b, FWUPG_NACK);
+      return;
+    }
+    idx = fwupg_get32(buf);
+    if (idx != b->next)
+    {
+      reply_ack(b, (idx < b->next) ? FWUPG_ACK : FWUPG_NACK);
+      return;
+    }
+    chunk = &buf[FWUPG_CHUNK_IDX_SZ];
+    len -= FWUPG_CHUNK_IDX_SZ + FWUPG_CHUNK_CRC_SZ;
+  }
+  if ((b->staged == 0) && (write_ms > 0))
+  {
+    (void)usleep((useconds_t)write_ms * 1000U);
+  }
+  b->rx_crc = fwupg_crc32_update(b->rx_crc, chunk, len);
+  b->rx_len += len;
+  b->next++;
+  /* the chunk is written but its ACK is lost on the link */
+  if ((drop_every != 0U) && ((b->chunk_cnt % drop_every) == 0U))
+  {
+    return;
+  }
+  reply_ack(b, FWUPG_ACK);
+}
+
+static void on_eof(Board_t *b)
+{
+  int ok = (b->synced != 0) && (b->rx_len == b->img_len) && (~b->rx_crc == b->img_crc);
+
+  if ((b->staged != 0) && (write_ms > 0))
+  {
+    (void)usleep((useconds_t)write_ms * 1000U * b->next);
+  }
+  reply_ack(b, ok ? FWUPG_ACK : FWUPG_NACK);
+  if (ok)
+  {
+    b->upgraded = 1;
+  }
+  b->synced = 0;
+  reply(b, b->upgraded ? VER_NEW : VER_OLD, strlen(VER_OLD));
+  if (verbose != 0)
+  {
+    (void)printf("%s: %s, %u bytes\n", b->name, ok ? "upgraded" : "CRC error", b->rx_len);
+  }
+}
+
+static void *board_thread(void *arg)
+{
+  static uint8_t eof[FWUPG_EOF_SZ] = { 0xFF, 0xFF, 0xFF, 0xFF };
+  Board_t *b = (Board_t *)arg;
+  uint8_t hdr[FWUPG_HEADER_SZ];
+  uint8_t *buf = malloc(FWUPG_CHUNK_IDX_SZ + FWUPG_CHUNK_SZ + FWUPG_CHUNK_CRC_SZ);
+  uint32_t len;
+
+  if (buf == NULL)
+  {
+    return NULL;
+  }
+  for (;;)
+  {
+    if (fwupg_read(b->master, hdr, sizeof(hdr), -1) != sizeof(hdr))
+    {
+      /* the host closed the port: wait for the next one */
+      (void)usleep(100000);
+      continue;
+    }
+    len = (uint32_t)hdr[0] | ((uint32_t)hdr[1] << 8);
+    if ((len == 0U) || (len > (FWUPG_CHUNK_IDX_SZ + FWUPG_CHUNK_SZ + FWUPG_CHUNK_CRC_SZ)) ||
+        (fwupg_read(b->master, buf, len, 1000) != len))
+    {
+      /* truncated frame, as the MCU the board answers a NACK */
+      reply_ack(b, FWUPG_NACK);
+      continue;
+    }
+    if (len == FWUPG_CTRL_SZ)
+    {
+      on_ctrl(b, buf);
+    }
+    else if (len == FWUPG_SYNC_SZ)
+    {
+      on_sync(b, buf);
+    }
+    else if ((len == FWUPG_EOF_SZ) && (memcmp(buf, eof, FWUPG_EOF_SZ) == 0))
+    {
+      on_eof(b);
+    }
+    else
+    {
+      on_chunk(b, buf, len);
+    }
+  }
+  return NULL;
+}
+
+static int board_open(Board_t *b)
+{
+  struct termios tio;
+  int slave;
+
+  b->master = posix_openpt(O_RDWR | O_NOCTTY);
+  if ((b->master < 0) || (grantpt(b->master) != 0) || (unlockpt(b->master) != 0) ||
+      (ptsname_r(b->master, b->name, sizeof(b->name)) != 0))
+  {
+    return -1;
+  }
+  /* kept open so that the master survives the host closing the port */
+  slave = open(b->name, O_RDWR | O_NOCTTY);
+  if ((slave < 0) || (tcgetattr(slave, &tio) != 0))
+  {
+    return -1;
+  }
+  cfmakeraw(&tio);
+  return tcsetattr(slave, TCSANOW, &tio);
+}
+
+static void usage(void)
+{
+  (void)fprintf(stderr,
+    "usage: fwupg_emu [options]\n"
+    "  -n nbr    number of emulated boards (default 4)\n"
+    "  -w ms     Teseo write time of a chunk (default 0)\n"
+    "  -k nbr    NACK every nbr-th chunk (corrupted chunk)\n"
+    "  -l nbr    drop the ACK of every nbr-th chunk (link glitch)\n"
+    "  -v        print the result of each upgrade\n");
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  Board_t *boards;
+  pthread_t tid;
+  int nbr = 4;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "n:w:k:l:v")) != -1)
+  {
+    switch (opt)
+    {
+      case 'n': nbr = (int)strtol(optarg, NULL, 0); break;
+      case 'w': write_ms = (int)strtol(optarg, NULL, 0); break;
+      case 'k': nack_every = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'l': drop_every = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'v': verbose = 1; break;
+      default:
+        usage();
+        return 2;
+    }
+  }
+  boards = calloc((size_t)nbr, sizeof(Board_t));
+  if ((nbr <= 0) || (boards == NULL))
+  {
+    usage();
+    return 2;
+  }
+  for (int i = 0; i < nbr; i++)
+  {
+    boards[i].id = i;
+    if ((board_open(&boards[i]) != 0) || (pthread_create(&tid, NULL, board_thread, &boards[i]) != 0))
+    {
+      (void)fprintf(stderr, "cannot create the pseudo-terminal %d\n", i);
+      return 1;
+    }
+    (void)printf("%s\n", boards[i].name);
+  }
+  (void)fflush(stdout);
+  for (;;)
+  {
+    (void)pause();
+  }
+  return 0;
+}
@@ -0,0 +1,437 @@
+/**
+  ******************************************************************************
+  * @file    fwupg_multi.c
+  * @author  SRA Application Team
+  * @brief   Upgrades the Teseo FW of several X-NUCLEO-GNSS1A1 boards at once,
+  *          one thread per serial port sharing the same image in memory.
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Includes ------------------------------------------------------------------*/
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <termios.h>
+
+#include "fwupg_proto.h"
+
+/* Private defines -----------------------------------------------------------*/
+#define CTRL_ACK_TIMEOUT      1000
+#define SYNC_ACK_TIMEOUT      30000  /* Teseo (or staging region) erase */
+#define CHUNK_ACK_TIMEOUT     10000
+#define EOF_ACK_TIMEOUT       15000
+#define STAGED_EOF_TIMEOUT    300000 /* the whole image is flashed by the MCU */
+#define VER_TIMEOUT           10000
+#define VER_IDLE_TIMEOUT      200
+
+/* Private types -------------------------------------------------------------*/
+typedef struct
+{
+  const char *path;
+  int         fd;
+  int         failed;
+  char        ver_old[FWUPG_VER_SZ + 1U];
+  char        ver_new[FWUPG_VER_SZ + 1U];
+  uint32_t    retries;
+  int64_t     elapsed;
+  char        err[80];
+} Port_t;
+
+/* Private variables ---------------------------------------------------------*/
+/* Shared by all the ports, read only once loaded */
+static uint8_t  *image;
+static uint32_t  image_len;
+static uint8_t   sync_frame[FWUPG_SYNC_SZ];
+static speed_t   baud = B115200;
+static int       crc_mode;
+static int       staged;
+static int       verbose;
+static uint32_t  max_retries = 5U;
+static int       chunk_timeout = CHUNK_ACK_TIMEOUT;
+
+static pthread_mutex_t print_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Private functions ---------------------------------------------------------*/
+static void log_port(const Port_t *p, const char *fmt, ...)
+{
+  va_list ap;
+
+  (void)pthread_mutex_lock(&print_lock);
+  (void)printf("[%s] ", p->path);
+  va_start(ap, fmt);
+  (void)vprintf(fmt, ap);
+  va_end(ap);
+  (void)printf("\n");
+  (void)fflush(stdout);
+  (void)pthread_mutex_unlock(&print_lock);
+}
+
+static int fail(Port_t *p, const char *why)
+{
+  (void)snprintf(p->err, sizeof(p->err), "%s", why);
+  p->failed = 1;
+  return -1;
+}
+
+static int port_open(Port_t *p)
+{
+  struct termios tio;
+
+  p->fd = open(p->path, O_RDWR | O_NOCTTY);
+  if (p->fd < 0)
+  {
+    return fail(p, "cannot open the port");
+  }
+  if (tcgetattr(p->fd, &tio) != 0)
+  {
+    return fail(p, "not a serial port");
+  }
+  cfmakeraw(&tio);
+  tio.c_cflag |= (CLOCAL | CREAD);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+  (void)cfsetispeed(&tio, baud);
+  (void)cfsetospeed(&tio, baud);
+  if (tcsetattr(p->fd, TCSANOW, &tio) != 0)
+  {
+    return fail(p, "cannot configure the port");
+  }
+  (void)tcflush(p->fd, TCIOFLUSH);
+  return 0;
+}
+
+static int send_frame(const Port_t *p, const uint8_t *payload, uint16_t len)
+{
+  uint8_t hdr[FWUPG_HEADER_SZ] = { (uint8_t)len, (uint8_t)(len >> 8) };
+
+  if (fwupg_write(p->fd, hdr, sizeof(hdr)) != 0)
+  {
+    return -1;
+  }
+  return fwupg_write(p->fd, payload, len);
+}
+
+static int send_ctrl(const Port_t *p, const char *cmd)
+{
+  return send_frame(p, (const uint8_t *)cmd, (uint16_t)FWUPG_CTRL_SZ);
+}
+
+/* Returns the ACK/NACK byte, 0 on timeout */
+static uint8_t wait_ack(const Port_t *p, int timeout_ms)
+{
+  uint8_t ack = 0;
+
+  (void)fwupg_read(p->fd, &ack, 1, timeout_ms);
+  return ack;
+}
+
+/* The version string is not framed: it ends when the line stays idle */
+static void read_version(const Port_t *p, char *ver)
+{
+  size_t len;
+
+  (void)memset(ver, 0, FWUPG_VER_SZ + 1U);
+  len = fwupg_read(p->fd, (uint8_t *)ver, 1, VER_TIMEOUT);
+  if (len == 1U)
+  {
+    len += fwupg_read(p->fd, (uint8_t *)&ver[1], FWUPG_VER_SZ - 1U, VER_IDLE_TIMEOUT);
+  }
+  ver[len] = '\0';
+}
+
+/* Asks the MCU the index of the next chunk after a link glitch */
+static uint32_t resume(const Port_t *p)
+{
+  uint8_t rsp[FWUPG_CHUNK_IDX_SZ];
+
+  /* drop a late answer of the previous chunk */
+  (void)fwupg_read(p->fd, rsp, sizeof(rsp), VER_IDLE_TIMEOUT);
+  (void)tcflush(p->fd, TCIFLUSH);
+  if ((send_ctrl(p, "RESUM") != 0) ||
+      (fwupg_read(p->fd, rsp, sizeof(rsp), CHUNK_ACK_TIMEOUT) != sizeof(rsp)))
+  {
+    return FWUPG_RESUME_NONE;
+  }
+  return fwupg_get32(rsp);
+}
+
+static int send_chunk(const Port_t *p, uint32_t idx, uint8_t *frame)
+{
+  uint32_t off = idx * FWUPG_CHUNK_SZ;
+  uint32_t len = ((image_len - off) < FWUPG_CHUNK_SZ) ? (image_len - off) : FWUPG_CHUNK_SZ;
+
+  if (crc_mode == 0)
+  {
+    return send_frame(p, &image[off], (uint16_t)len);
+  }
+  fwupg_put32(frame, idx);
+  (void)memcpy(&frame[FWUPG_CHUNK_IDX_SZ], &image[off], len);
+  len += FWUPG_CHUNK_IDX_SZ;
+  fwupg_put32(&frame[len], ~fwupg_crc32_update(0xFFFFFFFFU, frame, len));
+  return send_frame(p, frame, (uint16_t)(len + FWUPG_CHUNK_CRC_SZ));
+}
+
+static int upgrade(Port_t *p)
+{
+  static const uint8_t eof[FWUPG_EOF_SZ] = { 0xFF, 0xFF, 0xFF, 0xFF };
+  uint8_t frame[FWUPG_CHUNK_IDX_SZ + FWUPG_CHUNK_SZ + FWUPG_CHUNK_CRC_SZ];
+  uint32_t nbr = (image_len + FWUPG_CHUNK_SZ - 1U) / FWUPG_CHUNK_SZ;
+  uint32_t idx = 0;
+  uint8_t ack;
+
+  if (port_open(p) != 0)
+  {
+    return -1;
+  }
+  if (send_ctrl(p, "START") != 0)
+  {
+    return fail(p, "write error");
+  }
+  read_version(p, p->ver_old);
+  if (p->ver_old[0] == '\0')
+  {
+    return fail(p, "no answer to START (is FWUpgrade() running?)");
+  }
+  if ((crc_mode != 0) && ((send_ctrl(p, "CRC32") != 0) || (wait_ack(p, CTRL_ACK_TIMEOUT) != FWUPG_ACK)))
+  {
+    return fail(p, "CRC32 framing not supported");
+  }
+  if ((staged != 0) && ((send_ctrl(p, "STAGE") != 0) || (wait_ack(p, CTRL_ACK_TIMEOUT) != FWUPG_ACK)))
+  {
+    return fail(p, "staged upgrade not supported");
+  }
+  if ((send_frame(p, sync_frame, (uint16_t)FWUPG_SYNC_SZ) != 0) ||
+      (wait_ack(p, SYNC_ACK_TIMEOUT) != FWUPG_ACK))
+  {
+    return fail(p, "Teseo not synced");
+  }
+
+  while (idx < nbr)
+  {
+    if (send_chunk(p, idx, frame) != 0)
+    {
+      return fail(p, "write error");
+    }
+    ack = wait_ack(p, chunk_timeout);
+    if (ack == FWUPG_ACK)
+    {
+      idx++;
+      if ((verbose != 0) && (((idx % 8U) == 0U) || (idx == nbr)))
+      {
+        log_port(p, "%u/%u chunks", idx, nbr);
+      }
+      continue;
+    }
+    if ((crc_mode == 0) || (p->retries == max_retries))
+    {
+      return fail(p, (ack == 0U) ? "chunk ACK timeout" : "chunk NACK");
+    }
+    p->retries++;
+    if (ack == 0U)
+    {
+      idx = resume(p);
+      if (idx == FWUPG_RESUME_NONE)
+      {
+        return fail(p, "session lost, cannot resume");
+      }
+      log_port(p, "link glitch, resuming from chunk %u", idx);
+    }
+    /* a NACKed chunk is sent again */
+  }
+
+  if (send_frame(p, eof, (uint16_t)FWUPG_EOF_SZ) != 0)
+  {
+    return fail(p, "write error");
+  }
+  ack = wait_ack(p, (staged != 0) ? STAGED_EOF_TIMEOUT : EOF_ACK_TIMEOUT);
+  if (ack != FWUPG_ACK)
+  {
+    return fail(p, (ack == 0U) ? "CRC ACK timeout" : "image refused by the Teseo");
+  }
+  read_version(p, p->ver_new);
+  (void)send_ctrl(p, "CLOSE");
+  return 0;
+}
+
+static void *port_thread(void *arg)
+{
+  Port_t *p = (Port_t *)arg;
+  int64_t t0 = fwupg_now_ms();
+
+  (void)upgrade(p);
+  p->elapsed = fwupg_now_ms() - t0;
+  if (p->fd >= 0)
+  {
+    (void)close(p->fd);
+  }
+  if (p->failed != 0)
+  {
+    log_port(p, "FAILED: %s", p->err);
+  }
+  else
+  {
+    log_port(p, "OK %s -> %s (%.1f s, %u retries)", p->ver_old, p->ver_new,
+             (double)p->elapsed / 1000.0, p->retries);
+  }
+  return NULL;
+}
+
+static int load_image(const char *path)
+{
+  FILE *f = fopen(path, "rb");
+  long len;
+
+  if (f == NULL)
+  {
+    return -1;
+  }
+  if ((fseek(f, 0, SEEK_END) != 0) || ((len = ftell(f)) <= 0) || (fseek(f, 0, SEEK_SET) != 0))
+  {
+    (void)fclose(f);
+    return -1;
+  }
+  image = malloc((size_t)len);
+  if ((image == NULL) || (fread(image, 1, (size_t)len, f) != (size_t)len))
+  {
+    (void)fclose(f);
+    return -1;
+  }
+  (void)fclose(f);
+  image_len = (uint32_t)len;
+  return 0;
+}
+
+/* The Image Info fields: size, boot mode, CRC32, destination address and entry point */
+static void build_sync(uint32_t boot_mode, uint32_t dest, uint32_t entry)
+{
+  uint8_t *info = &sync_frame[5];
+
+  fwupg_put32(sync_frame, FWUPG_IDENTIFIER);
+  sync_frame[4] = FWUPG_START_COMM;
+  fwupg_put32(&info[0], image_len);
+  fwupg_put32(&info[4], boot_mode);
+  fwupg_put32(&info[8], ~fwupg_crc32_update(0xFFFFFFFFU, image, image_len));
+  fwupg_put32(&info[12], dest);
+  fwupg_put32(&info[16], entry);
+  sync_frame[5U + FWUPG_IMAGE_INFO_SZ] = FWUPG_FLASHER_READY;
+}
+
+static speed_t to_speed(unsigned long rate)
+{
+  switch (rate)
+  {
+    case 9600:    return B9600;
+    case 19200:   return B19200;
+    case 38400:   return B38400;
+    case 57600:   return B57600;
+    case 115200:  return B115200;
+    case 230400:  return B230400;
+    case 460800:  return B460800;
+    case 921600:  return B921600;
+    default:      return (speed_t)0;
+  }
+}
+
+static void usage(void)
+{
+  (void)fprintf(stderr,
+    "usage: fwupg_multi [options] image.bin port [port...]\n"
+    "  -b rate   serial baud rate (default 115200)\n"
+    "  -c        resumable upgrade: chunks framed with index and CRC32\n"
+    "  -s        staged upgrade: image stored in the MCU flash, then flashed\n"
+    "  -r nbr    retries of NACKed or lost chunks with -c, per board (default 5)\n"
+    "  -t ms     chunk ACK timeout (default 10000)\n"
+    "  -m val    Image Info boot mode (default 0)\n"
+    "  -d addr   Image Info destination address (default 0)\n"
+    "  -e addr   Image Info entry point (default 0)\n"
+    "  -v        print the progress of each port\n");
+}
+
+/* Exported functions --------------------------------------------------------*/
+int main(int argc, char **argv)
+{
+  uint32_t boot_mode = 0, dest = 0, entry = 0;
+  Port_t *ports;
+  pthread_t *tids;
+  int nbr, failed = 0;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "b:csr:t:m:d:e:v")) != -1)
+  {
+    switch (opt)
+    {
+      case 'b':
+        baud = to_speed(strtoul(optarg, NULL, 0));
+        if (baud == (speed_t)0)
+        {
+          (void)fprintf(stderr, "unsupported baud rate %s\n", optarg);
+          return 2;
+        }
+        break;
+      case 'c': crc_mode = 1; break;
+      case 's': staged = 1; break;
+      case 'r': max_retries = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 't': chunk_timeout = (int)strtol(optarg, NULL, 0); break;
+      case 'm': boot_mode = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'd': dest = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'e': entry = (uint32_t)strtoul(optarg, NULL, 0); break;
+      case 'v': verbose = 1; break;
+      default:
+        usage();
+        return 2;
+    }
+  }
+  if ((argc - optind) < 2)
+  {
+    usage();
+    return 2;
+  }
+  if (load_image(argv[optind]) != 0)
+  {
+    (void)fprintf(stderr, "cannot read %s\n", argv[optind]);
+    return 2;
+  }
+  build_sync(boot_mode, dest, entry);
+
+  nbr = argc - optind - 1;
+  ports = calloc((size_t)nbr, sizeof(Port_t));
+  tids = calloc((size_t)nbr, sizeof(pthread_t));
+  if ((ports == NULL) || (tids == NULL))
+  {
+    return 2;
+  }
+  for (int i = 0; i < nbr; i++)
+  {
+    ports[i].path = argv[optind + 1 + i];
+    ports[i].fd = -1;
+    if (pthread_create(&tids[i], NULL, port_thread, &ports[i]) != 0)
+    {
+      (void)fprintf(stderr, "cannot start the thread of %s\n", ports[i].path);
+      return 2;
+    }
+  }
+  for (int i = 0; i < nbr; i++)
+  {
+    (void)pthread_join(tids[i], NULL);
+    failed += ports[i].failed;
+  }
+  (void)printf("%d/%d boards upgraded\n", nbr - failed, nbr);
+
+  free(tids);
+  free(ports);
+  free(image);
+  return (failed == 0) ? 0 : 1;
+}
@@ -0,0 +1,150 @@
+/**
+  ******************************************************************************
+  * @file    fwupg_proto.h
+  * @author  SRA Application Team
+  * @brief   Host side definitions of the FW upgrade protocol handled by
+  *          FWUpgrade() (Drivers/BSP/GNSS1A1/gnss_fw_upgrade.c)
+  ******************************************************************************
+  * @attention
+  *
+  * Copyright (c) 2025 STMicroelectronics.
+  * All rights reserved.
+  *
+  * This software is licensed under terms that can be found in the LICENSE file
+  * in the root directory of this software component.
+  * If no LICENSE file comes with this software, it is provided AS-IS.
+  *
+  ******************************************************************************
+  */
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef FWUPG_PROTO_H
+#define FWUPG_PROTO_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Exported constants --------------------------------------------------------*/
+/* Each frame is a 2 bytes little endian length followed by the payload */
+#define FWUPG_HEADER_SZ          2U
+#define FWUPG_CTRL_SZ            5U    /* "START", "CLOSE", "CRC32", "RESUM", "STAGE" */
+#define FWUPG_SYNC_SZ            26U   /* IDENTIFIER, Start Communication, Image Info, Flasher Ready */
+#define FWUPG_EOF_SZ             4U    /* 0xFF 0xFF 0xFF 0xFF */
+#define FWUPG_CHUNK_SZ           (16U * 1024U)
+#define FWUPG_VER_SZ             32U
+
+/* Teseo flasher commands carried by the sync frame */
+#define FWUPG_IDENTIFIER         0xBCD501F4U
+#define FWUPG_START_COMM         0xA3U
+#define FWUPG_FLASHER_READY      0x4AU
+#define FWUPG_IMAGE_INFO_SZ      20U
+
+#define FWUPG_ACK                0xCCU
+#define FWUPG_NACK               0xDDU
+
+/* Resumable framing: [index][chunk][CRC32 of index and chunk] */
+#define FWUPG_CHUNK_IDX_SZ       4U
+#define FWUPG_CHUNK_CRC_SZ       4U
+#define FWUPG_RESUME_NONE        0xFFFFFFFFU
+
+/* Exported functions --------------------------------------------------------*/
+/* CRC32 (IEEE 802.3, reflected): start from 0xFFFFFFFF and complement the result */
+static inline uint32_t fwupg_crc32_update(uint32_t crc, const uint8_t *buf, size_t len)
+{
+  for (size_t i = 0; i < len; i++)
+  {
+    crc ^= buf[i];
+    for (int b = 0; b < 8; b++)
+    {
+      crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+    }
+  }
+  return crc;
+}
+
+static inline void fwupg_put32(uint8_t *buf, uint32_t val)
+{
+  buf[0] = (uint8_t)val;
+  buf[1] = (uint8_t)(val >> 8);
+  buf[2] = (uint8_t)(val >> 16);
+  buf[3] = (uint8_t)(val >> 24);
+}
+
+static inline uint32_t fwupg_get32(const uint8_t *buf)
+{
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) | ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static inline int64_t fwupg_now_ms(void)
+{
+  struct timespec ts;
+
+  (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ((int64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+}
+
+/* Reads len bytes within timeout_ms (-1 waits forever): returns the number of bytes read */
+static inline size_t fwupg_read(int fd, uint8_t *buf, size_t len, int timeout_ms)
+{
+  int64_t deadline = fwupg_now_ms() + timeout_ms;
+  struct pollfd pfd = { .fd = fd, .events = POLLIN };
+  size_t got = 0;
+  ssize_t n;
+  int left;
+
+  while (got < len)
+  {
+    left = (timeout_ms < 0) ? -1 : (int)(deadline - fwupg_now_ms());
+    if ((timeout_ms >= 0) && (left <= 0))
+    {
+      break;
+    }
+    if (poll(&pfd, 1, left) <= 0)
+    {
+      if ((timeout_ms < 0) && (errno == EINTR))
+      {
+        continue;
+      }
+      break;
+    }
+    n = read(fd, &buf[got], len - got);
+    if (n <= 0)
+    {
+      if ((n < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+      {
+        continue;
+      }
+      break;
+    }
+    got += (size_t)n;
+  }
+  return got;
+}
+
+/* Writes len bytes: returns 0 on success */
+static inline int fwupg_write(int fd, const uint8_t *buf, size_t len)
+{
+  ssize_t n;
+
+  while (len > 0U)
+  {
+    n = write(fd, buf, len);
+    if (n < 0)
+    {
+      if ((errno == EAGAIN) || (errno == EINTR))
+      {
+        continue;
+      }
+      return -1;
+    }
+    buf += n;
+    len -= (size_t)n;
+  }
+  return 0;
+}
+
+#endif /* FWUPG_PROTO_H */